@@ -109,3 +109,33 @@ Java_com_qxt_yuv420_LibyuvUtils_rotateYUV420SP(JNIEnv *env, jclass clazz, jbyteA
     env->ReleaseByteArrayElements(dst, _dst, 0);
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_LibyuvUtils_setColorSpace(JNIEnv *env, jclass clazz, jint matrix,
+                                              jint range) {
+    libyuvSetColorSpace(matrix, range);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_LibyuvUtils_getColorMatrix(JNIEnv *env, jclass clazz) {
+    return libyuvGetColorMatrix();
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_LibyuvUtils_getColorRange(JNIEnv *env, jclass clazz) {
+    return libyuvGetColorRange();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_LibyuvUtils_setChannelOrder(JNIEnv *env, jclass clazz, jint order) {
+    libyuvSetChannelOrder(order);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_LibyuvUtils_getChannelOrder(JNIEnv *env, jclass clazz) {
+    return libyuvGetChannelOrder();
+}
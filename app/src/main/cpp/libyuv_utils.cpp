@@ -18,6 +18,8 @@
 #include <libyuv/convert.h>
 #include <libyuv/convert_argb.h>
 #include <libyuv/convert_from.h>
+#include <libyuv/convert_from_argb.h>
+#include <libyuv/planar_functions.h>
 #include <libyuv/rotate.h>
 #include <libyuv/rotate_argb.h>
 
@@ -27,43 +29,199 @@
 using namespace std;
 using namespace libyuv;
 
+typedef int (*I420ToRGBAFunc)(const uint8 *src_y, int src_stride_y,
+                              const uint8 *src_u, int src_stride_u,
+                              const uint8 *src_v, int src_stride_v,
+                              uint8 *dst_rgba, int dst_stride_rgba, int width, int height);
+
+static int sColorMatrix = LIBYUV_COLOR_MATRIX_BT601;
+static int sColorRange = LIBYUV_COLOR_RANGE_LIMITED;
+static int sChannelOrder = LIBYUV_CHANNEL_ORDER_RGBA;
+
+//RGBA bytes to ARGB and ABGR bytes, for ARGBShuffle
+alignas(16) static const uint8 kShuffleRGBAToARGB[16] = {
+        3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14
+};
+alignas(16) static const uint8 kShuffleRGBAToABGR[16] = {
+        3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+};
+
+//the pairs libyuv has a conversion for, the others leave the setting as it is
+void libyuvSetColorSpace(int matrix, int range) {
+    if ((matrix == LIBYUV_COLOR_MATRIX_BT601 &&
+         (range == LIBYUV_COLOR_RANGE_LIMITED || range == LIBYUV_COLOR_RANGE_FULL)) ||
+        (matrix == LIBYUV_COLOR_MATRIX_BT709 && range == LIBYUV_COLOR_RANGE_LIMITED)) {
+        sColorMatrix = matrix;
+        sColorRange = range;
+    }
+}
+
+int libyuvGetColorMatrix() {
+    return sColorMatrix;
+}
+
+int libyuvGetColorRange() {
+    return sColorRange;
+}
+
+void libyuvSetChannelOrder(int order) {
+    if (order == LIBYUV_CHANNEL_ORDER_RGBA || order == LIBYUV_CHANNEL_ORDER_BGRA ||
+        order == LIBYUV_CHANNEL_ORDER_ARGB || order == LIBYUV_CHANNEL_ORDER_ABGR) {
+        sChannelOrder = order;
+    }
+}
+
+int libyuvGetChannelOrder() {
+    return sChannelOrder;
+}
+
+static inline bool isDefaultColorSpace() {
+    return sColorMatrix == LIBYUV_COLOR_MATRIX_BT601 && sColorRange == LIBYUV_COLOR_RANGE_LIMITED;
+}
+
+/*
+ * libyuv names the byte order of a little-endian word: RGBA bytes are ABGR,
+ * BGRA bytes ARGB, ARGB bytes BGRA and ABGR bytes RGBA. Only I420 has all
+ * four, J420 and H420 convert to RGBA bytes and *shuffler is the in place
+ * shuffle to the selected order, or nullptr.
+ */
+static I420ToRGBAFunc selectI420ToRGBA(const uint8 **shuffler) {
+    *shuffler = nullptr;
+    if (isDefaultColorSpace()) {
+        switch (sChannelOrder) {
+            case LIBYUV_CHANNEL_ORDER_BGRA:
+                return I420ToARGB;
+            case LIBYUV_CHANNEL_ORDER_ARGB:
+                return I420ToBGRA;
+            case LIBYUV_CHANNEL_ORDER_ABGR:
+                return I420ToRGBA;
+            default:
+                return I420ToABGR;
+        }
+    }
+    //BT.601 full range is J420, BT.709 limited range H420
+    const bool full = sColorRange == LIBYUV_COLOR_RANGE_FULL;
+    if (sChannelOrder == LIBYUV_CHANNEL_ORDER_BGRA) {
+        return full ? J420ToARGB : H420ToARGB;
+    } else if (sChannelOrder == LIBYUV_CHANNEL_ORDER_ARGB) {
+        *shuffler = kShuffleRGBAToARGB;
+    } else if (sChannelOrder == LIBYUV_CHANNEL_ORDER_ABGR) {
+        *shuffler = kShuffleRGBAToABGR;
+    }
+    return full ? J420ToABGR : H420ToABGR;
+}
+
+static void I420ToSelectedRGBA(const uint8 *pY, int yStride, const uint8 *pU, int uStride,
+                               const uint8 *pV, int vStride, unsigned char *dst,
+                               int width, int height) {
+    const uint8 *shuffler;
+    selectI420ToRGBA(&shuffler)(pY, yStride, pU, uStride, pV, vStride, dst, width * 4, width,
+                                height);
+    if (shuffler) {
+        ARGBShuffle(dst, width * 4, dst, width * 4, shuffler, width, height);
+    }
+}
+
+/*
+ * libyuv converts NV12 and NV21 with the BT.601 limited matrix to BGRA bytes
+ * only, RGBA is shuffled from them in place. The other color spaces and
+ * orders are converted through a temporary I420 image.
+ */
+static void libyuvNVToRGBA(unsigned char *src, unsigned char *dst, int width, int height,
+                           bool nv21) {
+    unsigned char *pY = src;
+    unsigned char *pUV = src + width * height;
+    if (isDefaultColorSpace() && (sChannelOrder == LIBYUV_CHANNEL_ORDER_BGRA ||
+                                  sChannelOrder == LIBYUV_CHANNEL_ORDER_RGBA)) {
+        if (nv21) {
+            NV21ToARGB(pY, width, pUV, width, dst, width * 4, width, height);
+        } else {
+            NV12ToARGB(pY, width, pUV, width, dst, width * 4, width, height);
+        }
+        if (sChannelOrder == LIBYUV_CHANNEL_ORDER_RGBA) {
+            ARGBToABGR(dst, width * 4, dst, width * 4, width, height);
+        }
+        return;
+    }
+
+    const int uvWidth = (width + 1) >> 1;
+    const int uvHeight = (height + 1) >> 1;
+    unsigned char *pTmp = new unsigned char[width * height + uvWidth * uvHeight * 2];
+    unsigned char *pTmpY = pTmp;
+    unsigned char *pTmpU = pTmp + width * height;
+    unsigned char *pTmpV = pTmpU + uvWidth * uvHeight;
+    if (nv21) {
+        NV21ToI420(pY, width, pUV, width, pTmpY, width, pTmpU, uvWidth, pTmpV, uvWidth,
+                   width, height);
+    } else {
+        NV12ToI420(pY, width, pUV, width, pTmpY, width, pTmpU, uvWidth, pTmpV, uvWidth,
+                   width, height);
+    }
+    I420ToSelectedRGBA(pTmpY, width, pTmpU, uvWidth, pTmpV, uvWidth, dst, width, height);
+    delete[] pTmp;
+}
+
 
 void libyuvI420ToRGBA(unsigned char *src, unsigned char *dst, int width, int height) {
     unsigned char *pY = src;
     unsigned char *pU = src + width * height;
     unsigned char *pV = src + width * height * 5 / 4;
-    I420ToABGR(pY, width, pU, width >> 1, pV, width >> 1, dst, width * 4, width, height);
+    I420ToSelectedRGBA(pY, width, pU, width >> 1, pV, width >> 1, dst, width, height);
 }
 
 void libyuvYV12ToRGBA(unsigned char *src, unsigned char *dst, int width, int height) {
     unsigned char *pY = src;
     unsigned char *pU = src + width * height * 5 / 4;
     unsigned char *pV = src + width * height;
-    I420ToABGR(pY, width, pU, width >> 1, pV, width >> 1, dst, width * 4, width, height);
+    I420ToSelectedRGBA(pY, width, pU, width >> 1, pV, width >> 1, dst, width, height);
 }
 
 void libyuvNV12ToRGBA(unsigned char *src, unsigned char *dst, int width, int height) {
-    unsigned char *pY = src;
-    unsigned char *pUV = src + width * height;
-    NV21ToARGB(pY, width, pUV, width, dst, width * 4, width, height);
+    libyuvNVToRGBA(src, dst, width, height, false);
 }
 
 void libyuvNV21ToRGBA(unsigned char *src, unsigned char *dst, int width, int height) {
-    unsigned char *pY = src;
-    unsigned char *pUV = src + width * height;
-    NV12ToARGB(pY, width, pUV, width, dst, width * 4, width, height);
+    libyuvNVToRGBA(src, dst, width, height, true);
 }
 
+//rows of RGB24 per strip of libyuvRotateRGB, its 2 ARGB strips stay in the cache
+static const int ROTATE_RGB_STRIP_ROWS = 32;
+
+/*
+ * libyuv rotates 1 and 4 byte pixels only, so RGB24 goes through ARGB a strip
+ * of rows at a time. RGB24ToARGB and ARGBToRGB24 keep the order of the 3
+ * bytes, so RGB and BGR both come out as they went in.
+ */
 void libyuvRotateRGB(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+    RotationMode mode;
     if (degree == 90.0f) {
-        ARGBRotate(src, width * 3, dst, height * 3, width, height, kRotate90);
+        mode = kRotate90;
     } else if (degree == 180.0f) {
-        ARGBRotate(src, width * 3, dst, width * 3, width, height, kRotate180);
+        mode = kRotate180;
     } else if (degree == 270.0f) {
-        ARGBRotate(src, width * 3, dst, height * 3, width, height, kRotate270);
+        mode = kRotate270;
     } else {
         return;
     }
+    const int strip = height < ROTATE_RGB_STRIP_ROWS ? height : ROTATE_RGB_STRIP_ROWS;
+    unsigned char *pTmp = new unsigned char[width * strip * 8];
+    unsigned char *pARGB = pTmp;
+    unsigned char *pRotated = pTmp + width * strip * 4;
+    for (int y = 0; y < height; y += strip) {
+        const int rows = height - y < strip ? height - y : strip;
+        RGB24ToARGB(src + y * width * 3, width * 3, pARGB, width * 4, width, rows);
+        if (mode == kRotate180) {
+            ARGBRotate(pARGB, width * 4, pRotated, width * 4, width, rows, mode);
+            ARGBToRGB24(pRotated, width * 4, dst + (height - y - rows) * width * 3, width * 3,
+                        width, rows);
+        } else {
+            //the strip becomes a band of columns, counted from the right for 90 degrees
+            const int dstX = mode == kRotate90 ? height - y - rows : y;
+            ARGBRotate(pARGB, width * 4, pRotated, rows * 4, width, rows, mode);
+            ARGBToRGB24(pRotated, rows * 4, dst + dstX * 3, height * 3, rows, width);
+        }
+    }
+    delete[] pTmp;
 }
 
 void libyuvRotateRGBA(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
@@ -22,6 +22,38 @@
 extern "C" {
 #endif
 
+/*
+ * Color matrix and range of the YUV input, same values as native_utils.h.
+ * libyuv only has BT.601 limited (I420), BT.601 full (J420) and BT.709
+ * limited (H420) conversions, libyuvSetColorSpace ignores the other pairs and
+ * the getters keep returning the last supported one.
+ */
+#define LIBYUV_COLOR_MATRIX_BT601 0
+#define LIBYUV_COLOR_MATRIX_BT709 1
+#define LIBYUV_COLOR_MATRIX_BT2020 2
+#define LIBYUV_COLOR_RANGE_LIMITED 0
+#define LIBYUV_COLOR_RANGE_FULL 1
+
+void libyuvSetColorSpace(int matrix, int range);
+
+int libyuvGetColorMatrix();
+
+int libyuvGetColorRange();
+
+/*
+ * Byte order of the RGBA outputs, same values as native_utils.h. libyuv has
+ * no J420 / H420 conversion to ARGB or ABGR bytes, those color spaces are
+ * shuffled in place after the conversion.
+ */
+#define LIBYUV_CHANNEL_ORDER_RGBA 0
+#define LIBYUV_CHANNEL_ORDER_BGRA 1
+#define LIBYUV_CHANNEL_ORDER_ARGB 2
+#define LIBYUV_CHANNEL_ORDER_ABGR 3
+
+void libyuvSetChannelOrder(int order);
+
+int libyuvGetChannelOrder();
+
 void libyuvI420ToRGBA(unsigned char *src, unsigned char *dst, int width, int height);
 
 void libyuvYV12ToRGBA(unsigned char *src, unsigned char *dst, int width, int height);
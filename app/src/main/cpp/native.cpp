@@ -27,12 +27,14 @@ JNIEXPORT void JNICALL
 Java_com_qxt_yuv420_NativeUtils_I420ToRGBAByte(JNIEnv *env, jclass clazz,
                                                jbyteArray src, jbyteArray dst,
                                                jint width, jint height, jint yRowStride,
-                                               jint uvRowStride, jint uvPixelStride) {
+                                               jint uvRowStride, jint uvPixelStride,
+                                               jint channelOrder) {
     jbyte *_src = env->GetByteArrayElements(src, nullptr);
     jbyte *_dst = env->GetByteArrayElements(dst, nullptr);
     YUV420PToRGBAByte(reinterpret_cast<unsigned char *>(_src),
                       reinterpret_cast<unsigned char *>(_dst),
-                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420);
+                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420,
+                      channelOrder);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseByteArrayElements(dst, _dst, 0);
 }
@@ -56,12 +58,14 @@ JNIEXPORT void JNICALL
 Java_com_qxt_yuv420_NativeUtils_YV12ToRGBAByte(JNIEnv *env, jclass clazz,
                                                jbyteArray src, jbyteArray dst,
                                                jint width, jint height, jint yRowStride,
-                                               jint uvRowStride, jint uvPixelStride) {
+                                               jint uvRowStride, jint uvPixelStride,
+                                               jint channelOrder) {
     jbyte *_src = env->GetByteArrayElements(src, nullptr);
     jbyte *_dst = env->GetByteArrayElements(dst, nullptr);
     YUV420PToRGBAByte(reinterpret_cast<unsigned char *>(_src),
                       reinterpret_cast<unsigned char *>(_dst),
-                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12);
+                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12,
+                      channelOrder);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseByteArrayElements(dst, _dst, 0);
 }
@@ -84,11 +88,12 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_qxt_yuv420_NativeUtils_NV12ToRGBAByte(JNIEnv *env, jclass clazz,
                                                jbyteArray src, jbyteArray dst,
-                                               jint width, jint height) {
+                                               jint width, jint height, jint channelOrder) {
     jbyte *_src = env->GetByteArrayElements(src, NULL);
     jbyte *_dst = env->GetByteArrayElements(dst, NULL);
     YUV420SPToRGBAByte(reinterpret_cast<unsigned char *>(_src),
-                       reinterpret_cast<unsigned char *>(_dst), width, height, YUV420SP_NV12);
+                       reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                       YUV420SP_NV12, channelOrder);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseByteArrayElements(dst, _dst, 0);
 }
@@ -100,7 +105,8 @@ Java_com_qxt_yuv420_NativeUtils_NV12ToRGBAInt(JNIEnv *env, jclass clazz,
                                               jint width, jint height) {
     jbyte *_src = env->GetByteArrayElements(src, NULL);
     jint *_dst = env->GetIntArrayElements(dst, NULL);
-    YUV420SPToRGBAInt(reinterpret_cast<unsigned char *>(_src), _dst, width, height, YUV420SP_NV12);
+    YUV420SPToRGBAInt(reinterpret_cast<unsigned char *>(_src), _dst, width, height, width, width,
+                      YUV420SP_NV12);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseIntArrayElements(dst, _dst, 0);
 }
@@ -109,11 +115,12 @@ extern "C"
 JNIEXPORT void JNICALL
 Java_com_qxt_yuv420_NativeUtils_NV21ToRGBAByte(JNIEnv *env, jclass clazz,
                                                jbyteArray src, jbyteArray dst,
-                                               jint width, jint height) {
+                                               jint width, jint height, jint channelOrder) {
     jbyte *_src = env->GetByteArrayElements(src, NULL);
     jbyte *_dst = env->GetByteArrayElements(dst, NULL);
     YUV420SPToRGBAByte(reinterpret_cast<unsigned char *>(_src),
-                       reinterpret_cast<unsigned char *>(_dst), width, height, YUV420SP_NV21);
+                       reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                       YUV420SP_NV21, channelOrder);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseByteArrayElements(dst, _dst, 0);
 }
@@ -125,11 +132,759 @@ Java_com_qxt_yuv420_NativeUtils_NV21ToRGBAInt(JNIEnv *env, jclass clazz,
                                               jint width, jint height) {
     jbyte *_src = env->GetByteArrayElements(src, NULL);
     jint *_dst = env->GetIntArrayElements(dst, NULL);
-    YUV420SPToRGBAInt(reinterpret_cast<unsigned char *>(_src), _dst, width, height, YUV420SP_NV21);
+    YUV420SPToRGBAInt(reinterpret_cast<unsigned char *>(_src), _dst, width, height, width, width,
+                      YUV420SP_NV21);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseIntArrayElements(dst, _dst, 0);
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I420ToRGB565(JNIEnv *env, jclass clazz,
+                                             jbyteArray src, jbyteArray dst,
+                                             jint width, jint height, jint yRowStride,
+                                             jint uvRowStride, jint uvPixelStride,
+                                             jboolean dither) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToRGB565(reinterpret_cast<unsigned char *>(_src),
+                    reinterpret_cast<unsigned char *>(_dst),
+                    width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420,
+                    dither);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YV12ToRGB565(JNIEnv *env, jclass clazz,
+                                             jbyteArray src, jbyteArray dst,
+                                             jint width, jint height, jint yRowStride,
+                                             jint uvRowStride, jint uvPixelStride,
+                                             jboolean dither) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToRGB565(reinterpret_cast<unsigned char *>(_src),
+                    reinterpret_cast<unsigned char *>(_dst),
+                    width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12,
+                    dither);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV12ToRGB565(JNIEnv *env, jclass clazz,
+                                             jbyteArray src, jbyteArray dst,
+                                             jint width, jint height, jboolean dither) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToRGB565(reinterpret_cast<unsigned char *>(_src),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                     YUV420SP_NV12, dither);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV21ToRGB565(JNIEnv *env, jclass clazz,
+                                             jbyteArray src, jbyteArray dst,
+                                             jint width, jint height, jboolean dither) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToRGB565(reinterpret_cast<unsigned char *>(_src),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                     YUV420SP_NV21, dither);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I420ToRGB24(JNIEnv *env, jclass clazz,
+                                            jbyteArray src, jbyteArray dst,
+                                            jint width, jint height, jint yRowStride,
+                                            jint uvRowStride, jint uvPixelStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToRGB24(reinterpret_cast<unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst),
+                   width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YV12ToRGB24(JNIEnv *env, jclass clazz,
+                                            jbyteArray src, jbyteArray dst,
+                                            jint width, jint height, jint yRowStride,
+                                            jint uvRowStride, jint uvPixelStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToRGB24(reinterpret_cast<unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst),
+                   width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV12ToRGB24(JNIEnv *env, jclass clazz,
+                                            jbyteArray src, jbyteArray dst,
+                                            jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToRGB24(reinterpret_cast<unsigned char *>(_src),
+                    reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                    YUV420SP_NV12);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV21ToRGB24(JNIEnv *env, jclass clazz,
+                                            jbyteArray src, jbyteArray dst,
+                                            jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToRGB24(reinterpret_cast<unsigned char *>(_src),
+                    reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                    YUV420SP_NV21);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I420ToGray(JNIEnv *env, jclass clazz,
+                                           jbyteArray src, jbyteArray dst,
+                                           jint width, jint height, jint yRowStride,
+                                           jint uvRowStride, jint uvPixelStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToGray(reinterpret_cast<unsigned char *>(_src),
+                  reinterpret_cast<unsigned char *>(_dst),
+                  width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YV12ToGray(JNIEnv *env, jclass clazz,
+                                           jbyteArray src, jbyteArray dst,
+                                           jint width, jint height, jint yRowStride,
+                                           jint uvRowStride, jint uvPixelStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420PToGray(reinterpret_cast<unsigned char *>(_src),
+                  reinterpret_cast<unsigned char *>(_dst),
+                  width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV12ToGray(JNIEnv *env, jclass clazz,
+                                           jbyteArray src, jbyteArray dst,
+                                           jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToGray(reinterpret_cast<unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                   YUV420SP_NV12);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV21ToGray(JNIEnv *env, jclass clazz,
+                                           jbyteArray src, jbyteArray dst,
+                                           jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUV420SPToGray(reinterpret_cast<unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                   YUV420SP_NV21);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I420ToRGBAFloat(JNIEnv *env, jclass clazz,
+                                                jbyteArray src, jfloatArray dst,
+                                                jint width, jint height, jint yRowStride,
+                                                jint uvRowStride, jint uvPixelStride,
+                                                jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jfloat *_dst = env->GetFloatArrayElements(dst, NULL);
+    YUV420PToRGBAFloat(reinterpret_cast<unsigned char *>(_src), _dst,
+                       width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420,
+                       linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseFloatArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YV12ToRGBAFloat(JNIEnv *env, jclass clazz,
+                                                jbyteArray src, jfloatArray dst,
+                                                jint width, jint height, jint yRowStride,
+                                                jint uvRowStride, jint uvPixelStride,
+                                                jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jfloat *_dst = env->GetFloatArrayElements(dst, NULL);
+    YUV420PToRGBAFloat(reinterpret_cast<unsigned char *>(_src), _dst,
+                       width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12,
+                       linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseFloatArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV12ToRGBAFloat(JNIEnv *env, jclass clazz,
+                                                jbyteArray src, jfloatArray dst,
+                                                jint width, jint height, jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jfloat *_dst = env->GetFloatArrayElements(dst, NULL);
+    YUV420SPToRGBAFloat(reinterpret_cast<unsigned char *>(_src), _dst, width, height,
+                        width, width, YUV420SP_NV12, linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseFloatArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV21ToRGBAFloat(JNIEnv *env, jclass clazz,
+                                                jbyteArray src, jfloatArray dst,
+                                                jint width, jint height, jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jfloat *_dst = env->GetFloatArrayElements(dst, NULL);
+    YUV420SPToRGBAFloat(reinterpret_cast<unsigned char *>(_src), _dst, width, height,
+                        width, width, YUV420SP_NV21, linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseFloatArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I420ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jshortArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint uvPixelStride,
+                                               jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    YUV420PToRGBAHalf(reinterpret_cast<unsigned char *>(_src),
+                      reinterpret_cast<uint16_t *>(_dst),
+                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_I420,
+                      linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YV12ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jshortArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint uvPixelStride,
+                                               jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    YUV420PToRGBAHalf(reinterpret_cast<unsigned char *>(_src),
+                      reinterpret_cast<uint16_t *>(_dst),
+                      width, height, yRowStride, uvRowStride, uvPixelStride, YUV420P_YV12,
+                      linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV12ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jshortArray dst,
+                                               jint width, jint height, jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    YUV420SPToRGBAHalf(reinterpret_cast<unsigned char *>(_src),
+                       reinterpret_cast<uint16_t *>(_dst), width, height, width, width,
+                       YUV420SP_NV12, linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV21ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jshortArray dst,
+                                               jint width, jint height, jint linearize) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    YUV420SPToRGBAHalf(reinterpret_cast<unsigned char *>(_src),
+                       reinterpret_cast<uint16_t *>(_dst), width, height, width, width,
+                       YUV420SP_NV21, linearize);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I010ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jshortArray src, jbyteArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint channelOrder) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    I010ToRGBAByte(reinterpret_cast<const uint16_t *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride, uvRowStride,
+                   channelOrder);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I010ToRGBA1010102(JNIEnv *env, jclass clazz,
+                                                  jshortArray src, jintArray dst,
+                                                  jint width, jint height, jint yRowStride,
+                                                  jint uvRowStride) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    I010ToRGBA1010102(reinterpret_cast<const uint16_t *>(_src), _dst,
+                      width, height, yRowStride, uvRowStride);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I010ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jshortArray src, jshortArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint linearize) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    I010ToRGBAHalf(reinterpret_cast<const uint16_t *>(_src), reinterpret_cast<uint16_t *>(_dst),
+                   width, height, yRowStride, uvRowStride, linearize);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_P010ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jshortArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    P010ToRGBAByte(reinterpret_cast<const uint16_t *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                   channelOrder);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_P010ToRGBA1010102(JNIEnv *env, jclass clazz,
+                                                  jshortArray src, jintArray dst,
+                                                  jint width, jint height) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    P010ToRGBA1010102(reinterpret_cast<const uint16_t *>(_src), _dst, width, height, width, width);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_P010ToRGBAHalf(JNIEnv *env, jclass clazz,
+                                               jshortArray src, jshortArray dst,
+                                               jint width, jint height, jint linearize) {
+    jshort *_src = env->GetShortArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    P010ToRGBAHalf(reinterpret_cast<const uint16_t *>(_src), reinterpret_cast<uint16_t *>(_dst),
+                   width, height, width, width, linearize);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I422ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    I422ToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride, uvRowStride,
+                   channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I422ToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height, jint yRowStride,
+                                              jint uvRowStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    I422ToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst,
+                  width, height, yRowStride, uvRowStride);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV16ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    NV16ToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, width, width,
+                   channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_NV16ToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    NV16ToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst,
+                  width, height, width, width);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I444ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jint uvRowStride, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    I444ToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride, uvRowStride,
+                   channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_I444ToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height, jint yRowStride,
+                                              jint uvRowStride) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    I444ToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst,
+                  width, height, yRowStride, uvRowStride);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YUY2ToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    YUY2ToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, (width + 1) / 2 * 4,
+                   channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YUY2ToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    YUY2ToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst,
+                  width, height, (width + 1) / 2 * 4);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_UYVYToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    UYVYToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, (width + 1) / 2 * 4,
+                   channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_UYVYToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    UYVYToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst,
+                  width, height, (width + 1) / 2 * 4);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YUV420888ToRGBAByte(JNIEnv *env, jclass clazz,
+                                                    jobject y, jobject u, jobject v,
+                                                    jbyteArray dst, jint width, jint height,
+                                                    jint yRowStride, jint uvRowStride,
+                                                    jint uvPixelStride, jint channelOrder) {
+    jbyte *_dst = env->GetByteArrayElements(dst, nullptr);
+    YUV420ToRGBAByte(static_cast<unsigned char *>(env->GetDirectBufferAddress(y)),
+                     static_cast<unsigned char *>(env->GetDirectBufferAddress(u)),
+                     static_cast<unsigned char *>(env->GetDirectBufferAddress(v)),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride,
+                     uvRowStride, uvPixelStride, channelOrder);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YUV420888ToRGBAInt(JNIEnv *env, jclass clazz,
+                                                   jobject y, jobject u, jobject v,
+                                                   jintArray dst, jint width, jint height,
+                                                   jint yRowStride, jint uvRowStride,
+                                                   jint uvPixelStride) {
+    jint *_dst = env->GetIntArrayElements(dst, nullptr);
+    YUV420ToRGBAInt(static_cast<unsigned char *>(env->GetDirectBufferAddress(y)),
+                    static_cast<unsigned char *>(env->GetDirectBufferAddress(u)),
+                    static_cast<unsigned char *>(env->GetDirectBufferAddress(v)),
+                    _dst, width, height, yRowStride, uvRowStride, uvPixelStride);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_lumaToGray(JNIEnv *env, jclass clazz,
+                                           jbyteArray src, jbyteArray dst,
+                                           jint width, jint height, jint yRowStride,
+                                           jboolean expandRange) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    lumaToGray(reinterpret_cast<unsigned char *>(_src), reinterpret_cast<unsigned char *>(_dst),
+               width, height, yRowStride, expandRange);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_lumaToRGBAByte(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint yRowStride,
+                                               jboolean expandRange, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    lumaToRGBAByte(reinterpret_cast<unsigned char *>(_src),
+                   reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride,
+                   expandRange, channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_lumaToRGBAInt(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jintArray dst,
+                                              jint width, jint height, jint yRowStride,
+                                              jboolean expandRange) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    lumaToRGBAInt(reinterpret_cast<unsigned char *>(_src), _dst, width, height, yRowStride,
+                  expandRange);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_YUV420888LumaToGray(JNIEnv *env, jclass clazz,
+                                                    jobject y, jbyteArray dst,
+                                                    jint width, jint height, jint yRowStride,
+                                                    jboolean expandRange) {
+    jbyte *_dst = env->GetByteArrayElements(dst, nullptr);
+    lumaToGray(static_cast<unsigned char *>(env->GetDirectBufferAddress(y)),
+               reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride, expandRange);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAByteToI420(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAByteToYUV420(reinterpret_cast<const unsigned char *>(_src),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, YUV420P_I420,
+                     channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAByteToNV12(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAByteToYUV420(reinterpret_cast<const unsigned char *>(_src),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, YUV420SP_NV12,
+                     channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAByteToNV21(JNIEnv *env, jclass clazz,
+                                               jbyteArray src, jbyteArray dst,
+                                               jint width, jint height, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAByteToYUV420(reinterpret_cast<const unsigned char *>(_src),
+                     reinterpret_cast<unsigned char *>(_dst), width, height, YUV420SP_NV21,
+                     channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAIntToI420(JNIEnv *env, jclass clazz,
+                                              jintArray src, jbyteArray dst,
+                                              jint width, jint height) {
+    jint *_src = env->GetIntArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAIntToYUV420(_src, reinterpret_cast<unsigned char *>(_dst), width, height,
+                    YUV420P_I420);
+    env->ReleaseIntArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAIntToNV12(JNIEnv *env, jclass clazz,
+                                              jintArray src, jbyteArray dst,
+                                              jint width, jint height) {
+    jint *_src = env->GetIntArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAIntToYUV420(_src, reinterpret_cast<unsigned char *>(_dst), width, height,
+                    YUV420SP_NV12);
+    env->ReleaseIntArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RGBAIntToNV21(JNIEnv *env, jclass clazz,
+                                              jintArray src, jbyteArray dst,
+                                              jint width, jint height) {
+    jint *_src = env->GetIntArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RGBAIntToYUV420(_src, reinterpret_cast<unsigned char *>(_dst), width, height,
+                    YUV420SP_NV21);
+    env->ReleaseIntArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_unpackRAW(JNIEnv *env, jclass clazz,
+                                          jbyteArray src, jshortArray dst,
+                                          jint width, jint height, jint rowStride,
+                                          jint format) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jshort *_dst = env->GetShortArrayElements(dst, NULL);
+    unpackRAW(reinterpret_cast<const unsigned char *>(_src), reinterpret_cast<uint16_t *>(_dst),
+              width, height, rowStride, format);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RAWToRGBAByte(JNIEnv *env, jclass clazz,
+                                              jbyteArray src, jbyteArray dst,
+                                              jint width, jint height, jint rowStride,
+                                              jint format, jint cfa, jint blackLevel,
+                                              jint whiteLevel, jint channelOrder) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RAWToRGBAByte(reinterpret_cast<const unsigned char *>(_src),
+                  reinterpret_cast<unsigned char *>(_dst), width, height, rowStride, format, cfa,
+                  blackLevel, whiteLevel, channelOrder);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RAWToRGBAInt(JNIEnv *env, jclass clazz,
+                                             jbyteArray src, jintArray dst,
+                                             jint width, jint height, jint rowStride,
+                                             jint format, jint cfa, jint blackLevel,
+                                             jint whiteLevel) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jint *_dst = env->GetIntArrayElements(dst, NULL);
+    RAWToRGBAInt(reinterpret_cast<const unsigned char *>(_src), _dst, width, height, rowStride,
+                 format, cfa, blackLevel, whiteLevel);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseIntArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_RAWToNV12(JNIEnv *env, jclass clazz,
+                                          jbyteArray src, jbyteArray dst,
+                                          jint width, jint height, jint rowStride,
+                                          jint format, jint cfa, jint blackLevel,
+                                          jint whiteLevel) {
+    jbyte *_src = env->GetByteArrayElements(src, NULL);
+    jbyte *_dst = env->GetByteArrayElements(dst, NULL);
+    RAWToYUV420(reinterpret_cast<const unsigned char *>(_src),
+                reinterpret_cast<unsigned char *>(_dst), width, height, rowStride, format, cfa,
+                blackLevel, whiteLevel, YUV420SP_NV12);
+    env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_qxt_yuv420_NativeUtils_rotateRGB(JNIEnv *env, jclass clazz,
@@ -192,4 +947,154 @@ Java_com_qxt_yuv420_NativeUtils_rotateYUV420SP(JNIEnv *env, jclass clazz,
                    width, height, degree);
     env->ReleaseByteArrayElements(src, _src, JNI_ABORT);
     env->ReleaseByteArrayElements(dst, _dst, 0);
-}
\ No newline at end of file
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_rotateI010(JNIEnv *env, jclass clazz,
+                                           jshortArray src, jshortArray dst,
+                                           jint width, jint height, jfloat degree) {
+    jshort *_src = env->GetShortArrayElements(src, nullptr);
+    jshort *_dst = env->GetShortArrayElements(dst, nullptr);
+    rotateI010(reinterpret_cast<const uint16_t *>(_src), reinterpret_cast<uint16_t *>(_dst), width,
+               height, degree);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_rotateP010(JNIEnv *env, jclass clazz,
+                                           jshortArray src, jshortArray dst,
+                                           jint width, jint height, jfloat degree) {
+    jshort *_src = env->GetShortArrayElements(src, nullptr);
+    jshort *_dst = env->GetShortArrayElements(dst, nullptr);
+    rotateP010(reinterpret_cast<const uint16_t *>(_src), reinterpret_cast<uint16_t *>(_dst), width,
+               height, degree);
+    env->ReleaseShortArrayElements(src, _src, JNI_ABORT);
+    env->ReleaseShortArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_rotateYUV420888(JNIEnv *env, jclass clazz,
+                                                jobject y, jobject u, jobject v,
+                                                jbyteArray dst, jint width, jint height,
+                                                jint yRowStride, jint uvRowStride,
+                                                jint uvPixelStride, jfloat degree) {
+    jbyte *_dst = env->GetByteArrayElements(dst, nullptr);
+    rotateYUV420(static_cast<unsigned char *>(env->GetDirectBufferAddress(y)),
+                 static_cast<unsigned char *>(env->GetDirectBufferAddress(u)),
+                 static_cast<unsigned char *>(env->GetDirectBufferAddress(v)),
+                 reinterpret_cast<unsigned char *>(_dst), width, height, yRowStride, uvRowStride,
+                 uvPixelStride, degree);
+    env->ReleaseByteArrayElements(dst, _dst, 0);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setConvertEngine(JNIEnv *env, jclass clazz, jint engine) {
+    setConvertEngine(engine);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getConvertEngine(JNIEnv *env, jclass clazz) {
+    return getConvertEngine();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setConvertPrecision(JNIEnv *env, jclass clazz, jint precision) {
+    setConvertPrecision(precision);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getConvertPrecision(JNIEnv *env, jclass clazz) {
+    return getConvertPrecision();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setConvertThreads(JNIEnv *env, jclass clazz, jint threads) {
+    setConvertThreads(threads);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getConvertThreads(JNIEnv *env, jclass clazz) {
+    return getConvertThreads();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setChromaUpsampling(JNIEnv *env, jclass clazz, jint upsampling) {
+    setChromaUpsampling(upsampling);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getChromaUpsampling(JNIEnv *env, jclass clazz) {
+    return getChromaUpsampling();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setColorSpace(JNIEnv *env, jclass clazz, jint matrix,
+                                              jint range) {
+    setColorSpace(matrix, range);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getColorMatrix(JNIEnv *env, jclass clazz) {
+    return getColorMatrix();
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getColorRange(JNIEnv *env, jclass clazz) {
+    return getColorRange();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setChannelOrder(JNIEnv *env, jclass clazz, jint order) {
+    setChannelOrder(order);
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_qxt_yuv420_NativeUtils_getChannelOrder(JNIEnv *env, jclass clazz) {
+    return getChannelOrder();
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_setColorAdjustment(JNIEnv *env, jclass clazz,
+                                                   jfloatArray whiteBalanceGains,
+                                                   jfloatArray colorCorrectionMatrix,
+                                                   jfloat brightness, jfloat contrast,
+                                                   jfloat saturation) {
+    if ((whiteBalanceGains && env->GetArrayLength(whiteBalanceGains) < 3) ||
+        (colorCorrectionMatrix && env->GetArrayLength(colorCorrectionMatrix) < 9)) {
+        return;
+    }
+    jfloat gains[3];
+    jfloat matrix[9];
+    if (whiteBalanceGains) {
+        env->GetFloatArrayRegion(whiteBalanceGains, 0, 3, gains);
+    }
+    if (colorCorrectionMatrix) {
+        env->GetFloatArrayRegion(colorCorrectionMatrix, 0, 9, matrix);
+    }
+    setColorAdjustment(whiteBalanceGains ? gains : nullptr,
+                       colorCorrectionMatrix ? matrix : nullptr, brightness, contrast, saturation);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_qxt_yuv420_NativeUtils_clearColorAdjustment(JNIEnv *env, jclass clazz) {
+    clearColorAdjustment();
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_COLOR_H
+#define NATIVE_COLOR_H
+
+#include "native_utils.h"
+
+/*
+ * Fixed point YUV to RGB coefficients scaled by 1024, one type per color
+ * matrix and range, so every kernel is compiled with its constants inlined:
+ *   nY = max(Y - kYOffset, 0), nU = U - 128, nV = V - 128
+ *   R = kY * nY + kRV * nV
+ *   G = kY * nY + kGV * nV + kGU * nU
+ *   B = kY * nY + kBU * nU
+ * Limited range stretches luma by 255 / 219 and chroma by 255 / 224.
+ * For 8-bit input every sum >> 10 lies in [-275, 550].
+ */
+
+namespace native_utils {
+
+    template<int kMatrixValue, int kRangeValue>
+    struct ColorRange {
+        static const int kMatrix = kMatrixValue;
+        static const int kRange = kRangeValue;
+        static const int kYOffset = kRangeValue == COLOR_RANGE_FULL ? 0 : 16;
+        static const int kY = kRangeValue == COLOR_RANGE_FULL ? 1024 : 1192;
+    };
+
+    template<int kMatrix, int kRange>
+    struct ColorCoefficients;
+
+    //the tensorflow yuv2rgb.cc constants, kept bit-exact with earlier releases
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED> {
+        static const int kRV = 1634;
+        static const int kGU = -400;
+        static const int kGV = -833;
+        static const int kBU = 2066;
+    };
+
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT601, COLOR_RANGE_FULL> {
+        static const int kRV = 1436;
+        static const int kGU = -352;
+        static const int kGV = -731;
+        static const int kBU = 1815;
+    };
+
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED> {
+        static const int kRV = 1836;
+        static const int kGU = -218;
+        static const int kGV = -546;
+        static const int kBU = 2163;
+    };
+
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT709, COLOR_RANGE_FULL> {
+        static const int kRV = 1613;
+        static const int kGU = -192;
+        static const int kGV = -479;
+        static const int kBU = 1900;
+    };
+
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED> {
+        static const int kRV = 1719;
+        static const int kGU = -192;
+        static const int kGV = -666;
+        static const int kBU = 2193;
+    };
+
+    template<>
+    struct ColorCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT2020, COLOR_RANGE_FULL> {
+        static const int kRV = 1510;
+        static const int kGU = -169;
+        static const int kGV = -585;
+        static const int kBU = 1927;
+    };
+
+    typedef ColorCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED> DefaultColorCoefficients;
+
+/*
+ * Fixed point RGB to YUV coefficients scaled by 256, the inverse of the
+ * ColorCoefficients of the same matrix and range:
+ *   Y = (kYR * R + kYG * G + kYB * B + (kYOffset << 8) + 128) >> 8
+ *   U = (kUR * R + kUG * G + kUB * B + RGB_TO_UV_OFFSET) >> 8
+ *   V = (kVR * R + kVG * G + kVB * B + RGB_TO_UV_OFFSET) >> 8
+ * The luma weights add up to 256, or 220 for limited range, and the chroma
+ * weights to 0, so gray stays gray. The chroma offset is 128.5 - 1 / 256
+ * rather than 128.5: full range has a weight of 128, and 128 * 255 + 0x8080
+ * would be 65536 for pure blue or red. With it every sum of 8-bit input lies
+ * in [0, 65535], so the kernels may compute them in wrapping 16-bit lanes.
+ */
+    const int RGB_TO_UV_OFFSET = 0x807f;
+
+    template<int kMatrix, int kRange>
+    struct RGBToYUVCoefficients;
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT601, COLOR_RANGE_LIMITED> {
+        static const int kYR = 66;
+        static const int kYG = 129;
+        static const int kYB = 25;
+        static const int kUR = -38;
+        static const int kUG = -74;
+        static const int kUB = 112;
+        static const int kVR = 112;
+        static const int kVG = -94;
+        static const int kVB = -18;
+    };
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT601, COLOR_RANGE_FULL> {
+        static const int kYR = 77;
+        static const int kYG = 150;
+        static const int kYB = 29;
+        static const int kUR = -43;
+        static const int kUG = -85;
+        static const int kUB = 128;
+        static const int kVR = 128;
+        static const int kVG = -107;
+        static const int kVB = -21;
+    };
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED> {
+        static const int kYR = 47;
+        static const int kYG = 157;
+        static const int kYB = 16;
+        static const int kUR = -26;
+        static const int kUG = -86;
+        static const int kUB = 112;
+        static const int kVR = 112;
+        static const int kVG = -102;
+        static const int kVB = -10;
+    };
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT709, COLOR_RANGE_FULL> {
+        static const int kYR = 54;
+        static const int kYG = 183;
+        static const int kYB = 19;
+        static const int kUR = -29;
+        static const int kUG = -99;
+        static const int kUB = 128;
+        static const int kVR = 128;
+        static const int kVG = -116;
+        static const int kVB = -12;
+    };
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED>
+            : ColorRange<COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED> {
+        static const int kYR = 58;
+        static const int kYG = 149;
+        static const int kYB = 13;
+        static const int kUR = -31;
+        static const int kUG = -81;
+        static const int kUB = 112;
+        static const int kVR = 112;
+        static const int kVG = -103;
+        static const int kVB = -9;
+    };
+
+    template<>
+    struct RGBToYUVCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_FULL>
+            : ColorRange<COLOR_MATRIX_BT2020, COLOR_RANGE_FULL> {
+        static const int kYR = 67;
+        static const int kYG = 174;
+        static const int kYB = 15;
+        static const int kUR = -36;
+        static const int kUG = -92;
+        static const int kUB = 128;
+        static const int kVR = 128;
+        static const int kVG = -118;
+        static const int kVB = -10;
+    };
+
+/*
+ * The coefficients of CONVERT_PRECISION_FAST, 16-bit fixed point scaled by 64
+ * so every term fits an int16 SIMD lane:
+ *   yTerm = (kY * nY) >> 1, with kY scaled by 128 and kY * nY < 65536
+ *   R = clamp((yTerm + kRV * nV) >> 6)
+ *   G = clamp((yTerm + kGV * nV + kGU * nU) >> 6)
+ *   B = clamp((yTerm + kBU * nU) >> 6)
+ * A sum only exceeds INT16_MAX when it clamps to 255 anyway, so the kernels
+ * may saturate it.
+ */
+    template<class Coefficients>
+    struct FastColorCoefficients {
+        static const int kFractionBits = 6;
+        static const int kYOffset = Coefficients::kYOffset;
+        static const int kY = Coefficients::kY >> 3;
+        static const int kRV = (Coefficients::kRV + 8) >> 4;
+        static const int kGU = (Coefficients::kGU + 8) >> 4;
+        static const int kGV = (Coefficients::kGV + 8) >> 4;
+        static const int kBU = (Coefficients::kBU + 8) >> 4;
+
+        static_assert(Coefficients::kY % 8 == 0, "kY must be exact at 7 fraction bits");
+    };
+
+/*
+ * The general affine form of a conversion, filled at runtime when color
+ * adjustments are folded in. For channel c of r, g, b, scaled by 1024:
+ *   c = y[c] * max(Y - yOffset, 0) + u[c] * (U - 128) + v[c] * (V - 128) + offset[c]
+ * The coefficients are 16-bit for the SIMD kernels.
+ */
+    struct ColorTransform {
+        int yOffset;
+        int16_t y[3];
+        int16_t u[3];
+        int16_t v[3];
+        int offset[3];
+    };
+
+/*
+ * Calls function(ColorCoefficients<matrix, range>()) with the coefficient set
+ * picked at runtime, e.g. from a generic lambda. Unknown values are BT.601
+ * limited range.
+ */
+    template<class Function>
+    static inline auto withColorCoefficients(int matrix, int range, const Function &function)
+    -> decltype(function(DefaultColorCoefficients())) {
+        const bool full = range == COLOR_RANGE_FULL;
+        if (matrix == COLOR_MATRIX_BT709) {
+            return full ? function(ColorCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_FULL>())
+                        : function(ColorCoefficients<COLOR_MATRIX_BT709, COLOR_RANGE_LIMITED>());
+        } else if (matrix == COLOR_MATRIX_BT2020) {
+            return full ? function(ColorCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_FULL>())
+                        : function(ColorCoefficients<COLOR_MATRIX_BT2020, COLOR_RANGE_LIMITED>());
+        }
+        return full ? function(ColorCoefficients<COLOR_MATRIX_BT601, COLOR_RANGE_FULL>())
+                    : function(DefaultColorCoefficients());
+    }
+}
+#endif //NATIVE_COLOR_H
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_ROW_H
+#define NATIVE_ROW_H
+
+/*
+ * Row kernels used by native_utils.cpp.
+ * A row kernel converts one row of the image and only handles the widest
+ * multiple of its step, the caller finishes the remaining pixels in C.
+ * All kernels are bit-exact with the scalar engines in native_utils.cpp and
+ * are compiled once per coefficient set of native_color.h.
+ */
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define HAS_NEON_ROW
+#elif defined(__i386__) || defined(__x86_64__)
+#define HAS_X86_ROW
+#endif
+
+#include <stdint.h>
+#include <type_traits>
+
+namespace native_utils {
+
+    /*
+     * ROW_CHROMA_PLANAR: u and v are separate planes, pixel stride 1.
+     * ROW_CHROMA_NV12: interleaved uv plane, srcU points to it and srcV = srcU + 1.
+     * ROW_CHROMA_NV21: interleaved vu plane, srcV points to it and srcU = srcV + 1.
+     * ROW_CHROMA_444: u and v planes with one sample per pixel.
+     * ROW_CHROMA_BILINEAR: u and v planes like planar, the odd pixels take the
+     * rounded average of the samples on both sides, (c[i] + c[i + 1] + 1) >> 1.
+     * The planes hold one more sample past the last pixel pair.
+     */
+    const int ROW_CHROMA_PLANAR = 0;
+    const int ROW_CHROMA_NV12 = 1;
+    const int ROW_CHROMA_NV21 = 2;
+    const int ROW_CHROMA_444 = 3;
+    const int ROW_CHROMA_BILINEAR = 4;
+
+    /*
+     * Byte order of the output pixels, the same values as the CHANNEL_ORDER_*
+     * of native_utils.h. ROW_OUTPUT_ARGB_INT: ARGB ints, i.e. BGRA bytes in
+     * little-endian memory.
+     */
+    const int ROW_OUTPUT_RGBA = 0;
+    const int ROW_OUTPUT_BGRA = 1;
+    const int ROW_OUTPUT_ARGB = 2;
+    const int ROW_OUTPUT_ABGR = 3;
+    const int ROW_OUTPUT_ARGB_INT = ROW_OUTPUT_BGRA;
+
+    //byte position of each channel in a pixel, so the stores permute at compile time
+    template<int kOutput>
+    struct RowOutputOrder {
+        static const int kR = kOutput == ROW_OUTPUT_RGBA ? 0 :
+                              kOutput == ROW_OUTPUT_BGRA ? 2 :
+                              kOutput == ROW_OUTPUT_ARGB ? 1 : 3;
+        static const int kG = kOutput == ROW_OUTPUT_RGBA || kOutput == ROW_OUTPUT_BGRA ? 1 : 2;
+        static const int kB = kOutput == ROW_OUTPUT_RGBA ? 2 :
+                              kOutput == ROW_OUTPUT_BGRA ? 0 :
+                              kOutput == ROW_OUTPUT_ARGB ? 3 : 1;
+        static const int kA = kOutput == ROW_OUTPUT_RGBA || kOutput == ROW_OUTPUT_BGRA ? 3 : 0;
+    };
+
+/*
+ * Calls function(std::integral_constant<int, ROW_OUTPUT_*>()) with the output
+ * picked at runtime. Unknown values are ROW_OUTPUT_RGBA.
+ */
+    template<class Function>
+    static inline auto withRowOutput(int output, const Function &function)
+    -> decltype(function(std::integral_constant<int, ROW_OUTPUT_RGBA>())) {
+        if (output == ROW_OUTPUT_BGRA) {
+            return function(std::integral_constant<int, ROW_OUTPUT_BGRA>());
+        } else if (output == ROW_OUTPUT_ARGB) {
+            return function(std::integral_constant<int, ROW_OUTPUT_ARGB>());
+        } else if (output == ROW_OUTPUT_ABGR) {
+            return function(std::integral_constant<int, ROW_OUTPUT_ABGR>());
+        }
+        return function(std::integral_constant<int, ROW_OUTPUT_RGBA>());
+    }
+
+    typedef void (*YUV420ToRGBARowFunc)(const unsigned char *srcY, const unsigned char *srcU,
+                                        const unsigned char *srcV, unsigned char *dst, int width);
+
+    /*
+     * Returns the best row kernel of this cpu for the chroma layout, output and
+     * COLOR_MATRIX_* / COLOR_RANGE_* of native_utils.h, and its step in pixels,
+     * or nullptr if there is none.
+     */
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBARow(int chroma, int output, int matrix, int range, int *step);
+
+    /*
+     * Row kernels of CONVERT_PRECISION_FAST with 16-bit lanes, bit-exact with
+     * the FastColorCoefficients of native_color.h instead.
+     */
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBAFastRow(int chroma, int output, int matrix, int range, int *step);
+
+    struct ColorTransform;
+
+    /*
+     * Row kernels with the runtime ColorTransform of native_color.h, for
+     * conversions with color adjustments.
+     */
+    typedef void (*YUV420ToRGBATransformRowFunc)(const unsigned char *srcY,
+                                                 const unsigned char *srcU,
+                                                 const unsigned char *srcV, unsigned char *dst,
+                                                 int width, const ColorTransform *transform);
+
+    YUV420ToRGBATransformRowFunc selectYUV420ToRGBATransformRow(int chroma, int output, int *step);
+
+    /*
+     * Vertical half of the bilinear chroma upsampling of one output row, into
+     * ROW_CHROMA_BILINEAR u and v rows which the conversion interpolates
+     * horizontally. near is the chroma row of the output row and far its
+     * vertical neighbour:
+     *   dst[i] = (3 * near[i] + far[i] + 2) >> 2
+     * The chroma layout is ROW_CHROMA_PLANAR, NV12 or NV21, width is in pixels.
+     */
+    typedef void (*BlendChromaRowFunc)(const unsigned char *nearU,
+                                       const unsigned char *nearV,
+                                       const unsigned char *farU,
+                                       const unsigned char *farV,
+                                       unsigned char *dstU, unsigned char *dstV, int width);
+
+    BlendChromaRowFunc selectBlendChromaRow(int chroma, int *step);
+
+    /*
+     * Copy bytes from src to dst with non-temporal stores, which skip the read
+     * for ownership of dst and do not evict the lines still to be read. Meant
+     * for destinations far larger than the cache, with src a row buffer that
+     * stays in it. Handles every byte. Returns nullptr if the cpu has none.
+     */
+    typedef void (*StreamRowFunc)(const unsigned char *src, unsigned char *dst, int bytes);
+
+    StreamRowFunc selectStreamRow();
+
+    /*
+     * Pack a row of RGBA bytes into a smaller output:
+     * ROW_PACK_RGB565: little-endian 16-bit RGB565, like Bitmap.Config.RGB_565.
+     * ROW_PACK_RGB565_DITHER: RGB565 after a 4x4 ordered dither, d = ROW_DITHER_4X4[y & 3][x & 3]
+     * added to r and b as d >> 1 and to g as d >> 2, saturated.
+     * ROW_PACK_RGB24: R, G, B bytes.
+     * ROW_PACK_GRAY: (77 * R + 150 * G + 29 * B + 128) >> 8, the BT.601 luma weights.
+     * y is the image row of the pixels.
+     */
+    const int ROW_PACK_NONE = -1;
+    const int ROW_PACK_RGB565 = 0;
+    const int ROW_PACK_RGB565_DITHER = 1;
+    const int ROW_PACK_RGB24 = 2;
+    const int ROW_PACK_GRAY = 3;
+
+    const unsigned char ROW_DITHER_4X4[4][4] = {
+            {0,  8,  2,  10},
+            {12, 4,  14, 6},
+            {3,  11, 1,  9},
+            {15, 7,  13, 5}
+    };
+
+    typedef void (*PackRowFunc)(const unsigned char *src, unsigned char *dst, int width, int y);
+
+    PackRowFunc selectPackRow(int pack, int *step);
+
+    /*
+     * Luma-only rows, from the Y plane alone. Flags:
+     * ROW_LUMA_EXPAND: limited to full range, min((298 * max(Y - 16, 0)) >> 8, 255),
+     * the luma of the limited range conversions for neutral chroma.
+     * ROW_LUMA_RGBA: gray replicated into r, g and b, alpha 255 last.
+     * ROW_LUMA_ALPHA_FIRST: with ROW_LUMA_RGBA, alpha 255 first.
+     * ROW_LUMA_GRAY alone is a copy, there is no kernel for it.
+     */
+    const int ROW_LUMA_GRAY = 0;
+    const int ROW_LUMA_EXPAND = 1;
+    const int ROW_LUMA_RGBA = 2;
+    const int ROW_LUMA_ALPHA_FIRST = 4;
+
+    typedef void (*LumaRowFunc)(const unsigned char *srcY, unsigned char *dst, int width);
+
+    LumaRowFunc selectLumaRow(int luma, int *step);
+
+    /*
+     * Split a row of packed 4:2:2 into planar y, u and v rows, two pixels per
+     * 4 byte macropixel:
+     * ROW_PACKED_YUY2: Y0 U Y1 V, also called YUYV.
+     * ROW_PACKED_UYVY: U Y0 V Y1.
+     */
+    const int ROW_PACKED_YUY2 = 0;
+    const int ROW_PACKED_UYVY = 1;
+
+    typedef void (*SplitPackedRowFunc)(const unsigned char *src, unsigned char *dstY,
+                                       unsigned char *dstU, unsigned char *dstV, int width);
+
+    SplitPackedRowFunc selectSplitPackedRow(int packed, int *step);
+
+    /*
+     * 10-bit rows of the runtime ColorTransform, 16-bit samples in and RGBA16
+     * out: the 10-bit r, g, b and alpha 1023 in 16-bit lanes. The terms of the
+     * transform are scaled by 4,
+     *   nY = max(Y - 4 * yOffset, 0), nU = U - 512, nV = V - 512
+     *   R = clamp((y[0] * nY + u[0] * nU + v[0] * nV + 4 * offset[0]) >> 10, 0, 1023)
+     * so a sample of 4 times an 8-bit one is 4 times its 8-bit result plus at
+     * most 3. msb: the samples are in the high 10 bits and shifted down first,
+     * as in P010. The chroma layout is ROW_CHROMA_PLANAR, NV12, 444 or BILINEAR.
+     */
+    typedef void (*YUV420ToRGBA16RowFunc)(const uint16_t *srcY, const uint16_t *srcU,
+                                          const uint16_t *srcV, uint16_t *dst, int width,
+                                          const ColorTransform *transform);
+
+    YUV420ToRGBA16RowFunc selectYUV420ToRGBA16Row(int chroma, bool msb, int *step);
+
+    /*
+     * Pack a row of RGBA16 into 4 bytes per pixel, src is uint16_t:
+     * ROW_PACK16_BYTES + ROW_OUTPUT_*: the channels >> 2 in that byte order.
+     * ROW_PACK16_RGBA1010102: the little-endian word r | g << 10 | b << 20 | 3 << 30,
+     * like Bitmap.Config.RGBA_1010102.
+     */
+    const int ROW_PACK16_BYTES = 0;
+    const int ROW_PACK16_RGBA1010102 = 4;
+
+    PackRowFunc selectPack16Row(int pack, int *step);
+
+    /*
+     * RGBA to YUV rows with the RGBToYUVCoefficients of native_color.h. input
+     * is the ROW_OUTPUT_* byte order of the pixels, alpha is ignored.
+     * RGBAToYRowFunc: a row of luma.
+     * RGBAToUVRowFunc: a row of chroma from two rows of pixels, each sample
+     * from the 2x2 block average (a + b + c + d + 2) >> 2 of every channel,
+     * width is in pixels. The chroma layout is ROW_CHROMA_PLANAR, NV12 or NV21,
+     * dstU and dstV are placed like srcU and srcV.
+     */
+    typedef void (*RGBAToYRowFunc)(const unsigned char *src, unsigned char *dstY, int width);
+
+    typedef void (*RGBAToUVRowFunc)(const unsigned char *src0, const unsigned char *src1,
+                                    unsigned char *dstU, unsigned char *dstV, int width);
+
+    RGBAToYRowFunc selectRGBAToYRow(int input, int matrix, int range, int *step);
+
+    RGBAToUVRowFunc selectRGBAToUVRow(int chroma, int input, int matrix, int range, int *step);
+
+    /*
+     * Unpack a row of MIPI packed Bayer samples into 16-bit samples:
+     * ROW_RAW10: 4 pixels in 5 bytes, their high 8 bits then a byte of their
+     * low 2 bits, pixel 0 in bits 0-1.
+     * ROW_RAW12: 2 pixels in 3 bytes, their high 8 bits then a byte of their
+     * low 4 bits, pixel 0 in bits 0-3.
+     * A kernel reads up to 6 bytes past the last group it unpacks, so the
+     * caller leaves the last step pixels of a row to C.
+     */
+    const int ROW_RAW10 = 0;
+    const int ROW_RAW12 = 1;
+
+    typedef void (*UnpackRawRowFunc)(const unsigned char *src, uint16_t *dst, int width);
+
+    UnpackRawRowFunc selectUnpackRawRow(int raw, int *step);
+
+    /*
+     * Bilinear demosaic of a row of 16-bit Bayer samples into pixels of the
+     * ROW_OUTPUT_* byte order. above, row and below are the sample rows, each
+     * with the mirrored neighbour of its first and last sample at [-1] and
+     * [width]. ROW_BAYER_* is the color of the even then the odd columns. With
+     * avg(a, b) = (a + b + 1) >> 1,
+     *   h = avg(left, right), v = avg(above, below), cross = avg(h, v)
+     *   diag = avg(avg(above left, above right), avg(below left, below right))
+     * a red or blue sample gets green cross and the other color diag, a green
+     * sample gets h of the color of its row and v of the other. Each channel
+     * c is then min((max(c - black, 0) * scale) >> 16, 255), scale < 65536.
+     */
+    const int ROW_BAYER_RG = 0;
+    const int ROW_BAYER_GR = 1;
+    const int ROW_BAYER_GB = 2;
+    const int ROW_BAYER_BG = 3;
+
+    typedef void (*DemosaicRowFunc)(const uint16_t *above, const uint16_t *row,
+                                    const uint16_t *below, unsigned char *dst, int width,
+                                    int black, int scale);
+
+    DemosaicRowFunc selectDemosaicRow(int bayer, int output, int *step);
+
+    /*
+     * Transpose a block of step x step elements of bytesPerElement bytes,
+     * dst row j column i is src row i column j. The strides are in bytes and
+     * may be negative to walk the rows upwards, so a rotation by 90 degrees
+     * reverses the source rows and one by 270 the destination rows. 1 byte
+     * elements come in 16x16 blocks, 2 byte ones, interleaved UV pairs and
+     * 10-bit samples, in 8x8 blocks, RGB24 pixels in 4x4 blocks, 8x8 with
+     * NEON, and 4 byte pixels in 4x4 blocks, 8x8 with AVX2.
+     */
+    typedef void (*TransposeBlockFunc)(const unsigned char *src, int srcRowStride,
+                                       unsigned char *dst, int dstRowStride);
+
+    TransposeBlockFunc selectTransposeBlock(int bytesPerElement, int *step);
+
+#ifdef HAS_X86_ROW
+    bool cpuHasSSE41();
+
+    bool cpuHasAVX2();
+#endif
+
+}
+#endif //NATIVE_ROW_H
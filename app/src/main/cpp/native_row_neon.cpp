@@ -0,0 +1,1136 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_row.h"
+#include "native_color.h"
+
+#ifdef HAS_NEON_ROW
+
+#include <stdint.h>
+#include <string.h>
+#include <arm_neon.h>
+
+namespace native_utils {
+
+    const int NEON_ROW_STEP = 16;
+    const int NEON_BLEND_STEP = 16;
+    const int NEON_PACK_STEP = 16;
+    const int NEON_LUMA_STEP = 16;
+    const int NEON_SPLIT_STEP = 32;
+    const int NEON_ROW16_STEP = 8;
+    const int NEON_PACK16_STEP = 8;
+    const int NEON_RGBA_TO_YUV_STEP = 16;
+    const int NEON_RAW10_STEP = 8;
+    const int NEON_RAW12_STEP = 16;
+    const int NEON_DEMOSAIC_STEP = 16;
+
+/*
+ * 16 pixels per loop. The chroma terms are computed once per u/v sample,
+ * duplicated for 4:2:0, and the luma term of each channel is added with a
+ * widening multiply-accumulate. vqshrun + vqmovn clamp to [0, 255] exactly
+ * like the K_MAX_CHANNEL_VALUE clamp and >> 10.
+ */
+    struct ChromaTerms_NEON {
+        int32x4_t r[2];
+        int32x4_t g[2];
+        int32x4_t b[2];
+    };
+
+    static inline uint8x8_t narrowChannel(int32x4_t lo, int32x4_t hi) {
+        return vqmovn_u16(vcombine_u16(vqshrun_n_s32(lo, 10), vqshrun_n_s32(hi, 10)));
+    }
+
+    static inline void centerChroma(uint8x8_t u8, uint8x8_t v8, int16x8_t *u, int16x8_t *v) {
+        const uint8x8_t k128 = vdup_n_u8(128);
+        *u = vreinterpretq_s16_u16(vsubl_u8(u8, k128));
+        *v = vreinterpretq_s16_u16(vsubl_u8(v8, k128));
+    }
+
+/*
+ * Terms policies, the luma offset and gains and the chroma terms of a
+ * conversion: the constants of ColorCoefficients in native_color.h or a
+ * runtime ColorTransform.
+ */
+    template<class Coefficients>
+    struct CoefficientTerms_NEON {
+        inline int yOffset() const {
+            return Coefficients::kYOffset;
+        }
+
+        inline int16_t gain(int) const {
+            return Coefficients::kY;
+        }
+
+        inline ChromaTerms_NEON chroma(uint8x8_t u8, uint8x8_t v8) const {
+            int16x8_t u;
+            int16x8_t v;
+            centerChroma(u8, v8, &u, &v);
+            ChromaTerms_NEON c;
+            c.r[0] = vmull_n_s16(vget_low_s16(v), Coefficients::kRV);
+            c.r[1] = vmull_n_s16(vget_high_s16(v), Coefficients::kRV);
+            c.g[0] = vmlal_n_s16(vmull_n_s16(vget_low_s16(v), Coefficients::kGV),
+                                 vget_low_s16(u), Coefficients::kGU);
+            c.g[1] = vmlal_n_s16(vmull_n_s16(vget_high_s16(v), Coefficients::kGV),
+                                 vget_high_s16(u), Coefficients::kGU);
+            c.b[0] = vmull_n_s16(vget_low_s16(u), Coefficients::kBU);
+            c.b[1] = vmull_n_s16(vget_high_s16(u), Coefficients::kBU);
+            return c;
+        }
+    };
+
+    struct TransformTerms_NEON {
+        explicit TransformTerms_NEON(const ColorTransform &transform) : mTransform(transform) {
+        }
+
+        inline int yOffset() const {
+            return mTransform.yOffset;
+        }
+
+        inline int16_t gain(int channel) const {
+            return mTransform.y[channel];
+        }
+
+        inline void chroma(int channel, int16x4_t u, int16x4_t v, int32x4_t *c) const {
+            *c = vmlal_n_s16(vmlal_n_s16(vdupq_n_s32(mTransform.offset[channel]), u,
+                                         mTransform.u[channel]), v, mTransform.v[channel]);
+        }
+
+        inline ChromaTerms_NEON chroma(uint8x8_t u8, uint8x8_t v8) const {
+            int16x8_t u;
+            int16x8_t v;
+            centerChroma(u8, v8, &u, &v);
+            ChromaTerms_NEON c;
+            for (int i = 0; i < 2; i++) {
+                const int16x4_t u4 = i == 0 ? vget_low_s16(u) : vget_high_s16(u);
+                const int16x4_t v4 = i == 0 ? vget_low_s16(v) : vget_high_s16(v);
+                chroma(0, u4, v4, &c.r[i]);
+                chroma(1, u4, v4, &c.g[i]);
+                chroma(2, u4, v4, &c.b[i]);
+            }
+            return c;
+        }
+
+    private:
+        const ColorTransform mTransform;
+    };
+
+    //c holds the chroma term of pixels 0-3, 4-7, 8-11 and 12-15
+    static inline uint8x16_t
+    lumaPlusTerms(int16x8_t yLo, int16x8_t yHi, const int32x4_t c[4], int16_t gain) {
+        int32x4_t p0 = vmlal_n_s16(c[0], vget_low_s16(yLo), gain);
+        int32x4_t p1 = vmlal_n_s16(c[1], vget_high_s16(yLo), gain);
+        int32x4_t p2 = vmlal_n_s16(c[2], vget_low_s16(yHi), gain);
+        int32x4_t p3 = vmlal_n_s16(c[3], vget_high_s16(yHi), gain);
+        return vcombine_u8(narrowChannel(p0, p1), narrowChannel(p2, p3));
+    }
+
+    //duplicate the terms of 8 chroma samples for 16 pixels
+    static inline uint8x16_t
+    lumaPlusChroma420(int16x8_t yLo, int16x8_t yHi, const int32x4_t chroma[2], int16_t gain) {
+        int32x4x2_t lo = vzipq_s32(chroma[0], chroma[0]);
+        int32x4x2_t hi = vzipq_s32(chroma[1], chroma[1]);
+        const int32x4_t c[4] = {lo.val[0], lo.val[1], hi.val[0], hi.val[1]};
+        return lumaPlusTerms(yLo, yHi, c, gain);
+    }
+
+    static inline uint8x16_t
+    lumaPlusChroma444(int16x8_t yLo, int16x8_t yHi, const int32x4_t chroma0[2],
+                      const int32x4_t chroma1[2], int16_t gain) {
+        const int32x4_t c[4] = {chroma0[0], chroma0[1], chroma1[0], chroma1[1]};
+        return lumaPlusTerms(yLo, yHi, c, gain);
+    }
+
+/*
+ * Load 8 chroma samples of u and v for the pixels starting at column x.
+ */
+    template<int kChroma>
+    static inline void loadChroma(const unsigned char *srcU, const unsigned char *srcV, int x,
+                                  uint8x8_t *u, uint8x8_t *v) {
+        if (kChroma == ROW_CHROMA_PLANAR) {
+            *u = vld1_u8(srcU + (x >> 1));
+            *v = vld1_u8(srcV + (x >> 1));
+        } else if (kChroma == ROW_CHROMA_NV12) {
+            uint8x8x2_t uv = vld2_u8(srcU + x);
+            *u = uv.val[0];
+            *v = uv.val[1];
+        } else if (kChroma == ROW_CHROMA_NV21) {
+            uint8x8x2_t vu = vld2_u8(srcV + x);
+            *u = vu.val[1];
+            *v = vu.val[0];
+        } else {
+            *u = vld1_u8(srcU + x);
+            *v = vld1_u8(srcV + x);
+        }
+    }
+
+/*
+ * Chroma of the 16 pixels starting at column x, for the layouts with chroma
+ * per pixel. The odd pixels of ROW_CHROMA_BILINEAR get the vrhadd of their
+ * sample and the next one, loaded again one sample further.
+ */
+    template<int kChroma>
+    static inline void
+    loadPixelChroma(const unsigned char *srcU, const unsigned char *srcV, int x, uint8x8_t u[2],
+                    uint8x8_t v[2]) {
+        if (kChroma == ROW_CHROMA_BILINEAR) {
+            const uint8x8_t evenU = vld1_u8(srcU + (x >> 1));
+            const uint8x8_t evenV = vld1_u8(srcV + (x >> 1));
+            const uint8x8_t oddU = vrhadd_u8(evenU, vld1_u8(srcU + (x >> 1) + 1));
+            const uint8x8_t oddV = vrhadd_u8(evenV, vld1_u8(srcV + (x >> 1) + 1));
+            const uint8x8x2_t pixelsU = vzip_u8(evenU, oddU);
+            const uint8x8x2_t pixelsV = vzip_u8(evenV, oddV);
+            u[0] = pixelsU.val[0];
+            u[1] = pixelsU.val[1];
+            v[0] = pixelsV.val[0];
+            v[1] = pixelsV.val[1];
+        } else {
+            loadChroma<kChroma>(srcU, srcV, x, &u[0], &v[0]);
+            loadChroma<kChroma>(srcU, srcV, x + 8, &u[1], &v[1]);
+        }
+    }
+
+    //vst4 interleaves the channels in the byte order of kOutput
+    template<int kOutput>
+    static inline void storePixels(unsigned char *dst, uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+        typedef RowOutputOrder<kOutput> Order;
+        uint8x16x4_t pixels;
+        pixels.val[Order::kR] = r;
+        pixels.val[Order::kG] = g;
+        pixels.val[Order::kB] = b;
+        pixels.val[Order::kA] = vdupq_n_u8(0xff);
+        vst4q_u8(dst, pixels);
+    }
+
+    template<int kChroma, int kOutput, class Terms>
+    static inline void
+    convertRow_NEON(const unsigned char *srcY, const unsigned char *srcU,
+                    const unsigned char *srcV, unsigned char *dst, int width, const Terms &terms) {
+        const uint8x16_t kYOffset = vdupq_n_u8(terms.yOffset());
+        for (int x = 0; x < width; x += NEON_ROW_STEP) {
+            uint8x16_t y = vqsubq_u8(vld1q_u8(srcY + x), kYOffset);
+            int16x8_t yLo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y)));
+            int16x8_t yHi = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y)));
+
+            uint8x16_t r;
+            uint8x16_t g;
+            uint8x16_t b;
+            if (kChroma == ROW_CHROMA_444 || kChroma == ROW_CHROMA_BILINEAR) {
+                uint8x8_t u8[2];
+                uint8x8_t v8[2];
+                loadPixelChroma<kChroma>(srcU, srcV, x, u8, v8);
+                const ChromaTerms_NEON c0 = terms.chroma(u8[0], v8[0]);
+                const ChromaTerms_NEON c1 = terms.chroma(u8[1], v8[1]);
+                r = lumaPlusChroma444(yLo, yHi, c0.r, c1.r, terms.gain(0));
+                g = lumaPlusChroma444(yLo, yHi, c0.g, c1.g, terms.gain(1));
+                b = lumaPlusChroma444(yLo, yHi, c0.b, c1.b, terms.gain(2));
+            } else {
+                uint8x8_t u8;
+                uint8x8_t v8;
+                loadChroma<kChroma>(srcU, srcV, x, &u8, &v8);
+                const ChromaTerms_NEON c0 = terms.chroma(u8, v8);
+                r = lumaPlusChroma420(yLo, yHi, c0.r, terms.gain(0));
+                g = lumaPlusChroma420(yLo, yHi, c0.g, terms.gain(1));
+                b = lumaPlusChroma420(yLo, yHi, c0.b, terms.gain(2));
+            }
+
+            storePixels<kOutput>(dst + x * 4, r, g, b);
+        }
+    }
+
+    template<int kChroma, int kOutput, class Coefficients>
+    static void YUV420ToRGBARow_NEON(const unsigned char *srcY, const unsigned char *srcU,
+                                     const unsigned char *srcV, unsigned char *dst, int width) {
+        convertRow_NEON<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                          CoefficientTerms_NEON<Coefficients>());
+    }
+
+    template<int kChroma, int kOutput>
+    static void
+    YUV420ToRGBATransformRow_NEON(const unsigned char *srcY, const unsigned char *srcU,
+                                  const unsigned char *srcV, unsigned char *dst, int width,
+                                  const ColorTransform *transform) {
+        convertRow_NEON<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                          TransformTerms_NEON(*transform));
+    }
+
+/*
+ * CONVERT_PRECISION_FAST, the same loop on 8 lanes of int16 per register.
+ * vqaddq saturates only sums that clamp to 255 anyway and vqshrun does the
+ * >> 6 and the clamp.
+ */
+    struct FastChromaTerms_NEON {
+        int16x8_t r;
+        int16x8_t g;
+        int16x8_t b;
+    };
+
+    template<class Coefficients>
+    static inline FastChromaTerms_NEON fastChroma(uint8x8_t u8, uint8x8_t v8) {
+        int16x8_t u;
+        int16x8_t v;
+        centerChroma(u8, v8, &u, &v);
+        FastChromaTerms_NEON c;
+        c.r = vmulq_n_s16(v, Coefficients::kRV);
+        c.g = vmlaq_n_s16(vmulq_n_s16(v, Coefficients::kGV), u, Coefficients::kGU);
+        c.b = vmulq_n_s16(u, Coefficients::kBU);
+        return c;
+    }
+
+    template<class Coefficients>
+    static inline uint8x16_t fastChannel(int16x8_t yLo, int16x8_t yHi, int16x8_t cLo,
+                                         int16x8_t cHi) {
+        return vcombine_u8(vqshrun_n_s16(vqaddq_s16(yLo, cLo), Coefficients::kFractionBits),
+                           vqshrun_n_s16(vqaddq_s16(yHi, cHi), Coefficients::kFractionBits));
+    }
+
+    template<int kChroma, int kOutput, class Coefficients>
+    static void YUV420ToRGBAFastRow_NEON(const unsigned char *srcY, const unsigned char *srcU,
+                                         const unsigned char *srcV, unsigned char *dst,
+                                         int width) {
+        const uint8x16_t kYOffset = vdupq_n_u8(Coefficients::kYOffset);
+        const uint8x8_t kY = vdup_n_u8(Coefficients::kY);
+        for (int x = 0; x < width; x += NEON_ROW_STEP) {
+            uint8x16_t y = vqsubq_u8(vld1q_u8(srcY + x), kYOffset);
+            int16x8_t yLo = vreinterpretq_s16_u16(vshrq_n_u16(vmull_u8(vget_low_u8(y), kY), 1));
+            int16x8_t yHi = vreinterpretq_s16_u16(vshrq_n_u16(vmull_u8(vget_high_u8(y), kY), 1));
+
+            uint8x16_t r;
+            uint8x16_t g;
+            uint8x16_t b;
+            if (kChroma == ROW_CHROMA_444 || kChroma == ROW_CHROMA_BILINEAR) {
+                uint8x8_t u8[2];
+                uint8x8_t v8[2];
+                loadPixelChroma<kChroma>(srcU, srcV, x, u8, v8);
+                const FastChromaTerms_NEON c0 = fastChroma<Coefficients>(u8[0], v8[0]);
+                const FastChromaTerms_NEON c1 = fastChroma<Coefficients>(u8[1], v8[1]);
+                r = fastChannel<Coefficients>(yLo, yHi, c0.r, c1.r);
+                g = fastChannel<Coefficients>(yLo, yHi, c0.g, c1.g);
+                b = fastChannel<Coefficients>(yLo, yHi, c0.b, c1.b);
+            } else {
+                uint8x8_t u8;
+                uint8x8_t v8;
+                loadChroma<kChroma>(srcU, srcV, x, &u8, &v8);
+                const FastChromaTerms_NEON c0 = fastChroma<Coefficients>(u8, v8);
+                //duplicate the terms of 8 chroma samples for 16 pixels
+                const int16x8x2_t cr = vzipq_s16(c0.r, c0.r);
+                const int16x8x2_t cg = vzipq_s16(c0.g, c0.g);
+                const int16x8x2_t cb = vzipq_s16(c0.b, c0.b);
+                r = fastChannel<Coefficients>(yLo, yHi, cr.val[0], cr.val[1]);
+                g = fastChannel<Coefficients>(yLo, yHi, cg.val[0], cg.val[1]);
+                b = fastChannel<Coefficients>(yLo, yHi, cb.val[0], cb.val[1]);
+            }
+
+            storePixels<kOutput>(dst + x * 4, r, g, b);
+        }
+    }
+
+/*
+ * (3 * near + far + 2) >> 2 for 8 samples without widening, the vrhadd of near
+ * and the vhadd of near and far, stored into the planar u and v rows.
+ */
+    template<int kChroma>
+    static inline void
+    loadBlendedChroma(const unsigned char *nearU, const unsigned char *nearV,
+                      const unsigned char *farU, const unsigned char *farV, int x,
+                      uint8x8_t *u, uint8x8_t *v) {
+        uint8x8_t nu;
+        uint8x8_t nv;
+        uint8x8_t fu;
+        uint8x8_t fv;
+        loadChroma<kChroma>(nearU, nearV, x, &nu, &nv);
+        loadChroma<kChroma>(farU, farV, x, &fu, &fv);
+        *u = vrhadd_u8(nu, vhadd_u8(nu, fu));
+        *v = vrhadd_u8(nv, vhadd_u8(nv, fv));
+    }
+
+    template<int kChroma>
+    static void
+    BlendChromaRow_NEON(const unsigned char *nearU, const unsigned char *nearV,
+                        const unsigned char *farU, const unsigned char *farV,
+                        unsigned char *dstU, unsigned char *dstV, int width) {
+        for (int x = 0; x < width; x += NEON_BLEND_STEP) {
+            uint8x8_t u;
+            uint8x8_t v;
+            loadBlendedChroma<kChroma>(nearU, nearV, farU, farV, x, &u, &v);
+            vst1_u8(dstU + (x >> 1), u);
+            vst1_u8(dstV + (x >> 1), v);
+        }
+    }
+
+/*
+ * vld4 splits 16 pixels into channels. RGB565 is built with shift-inserts,
+ * the low byte g << 3 | b >> 3 and the high byte r | g >> 5, and vst2 stores
+ * them as little-endian halfwords. The dither row repeats every 4 pixels.
+ */
+    template<int kPack>
+    static void PackRow_NEON(const unsigned char *src, unsigned char *dst, int width, int y) {
+        uint8x16_t ditherRB = vdupq_n_u8(0);
+        uint8x16_t ditherG = vdupq_n_u8(0);
+        if (kPack == ROW_PACK_RGB565_DITHER) {
+            uint32_t row;
+            memcpy(&row, ROW_DITHER_4X4[y & 3], sizeof(row));
+            const uint8x16_t dither = vreinterpretq_u8_u32(vdupq_n_u32(row));
+            ditherRB = vshrq_n_u8(dither, 1);
+            ditherG = vshrq_n_u8(dither, 2);
+        }
+        for (int x = 0; x < width; x += NEON_PACK_STEP) {
+            const uint8x16x4_t rgba = vld4q_u8(src + x * 4);
+            if (kPack == ROW_PACK_RGB24) {
+                uint8x16x3_t rgb;
+                rgb.val[0] = rgba.val[0];
+                rgb.val[1] = rgba.val[1];
+                rgb.val[2] = rgba.val[2];
+                vst3q_u8(dst + x * 3, rgb);
+            } else if (kPack == ROW_PACK_GRAY) {
+                uint16x8_t lo = vmull_u8(vget_low_u8(rgba.val[0]), vdup_n_u8(77));
+                uint16x8_t hi = vmull_u8(vget_high_u8(rgba.val[0]), vdup_n_u8(77));
+                lo = vmlal_u8(lo, vget_low_u8(rgba.val[1]), vdup_n_u8(150));
+                hi = vmlal_u8(hi, vget_high_u8(rgba.val[1]), vdup_n_u8(150));
+                lo = vmlal_u8(lo, vget_low_u8(rgba.val[2]), vdup_n_u8(29));
+                hi = vmlal_u8(hi, vget_high_u8(rgba.val[2]), vdup_n_u8(29));
+                vst1q_u8(dst + x, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+            } else {
+                uint8x16_t r = rgba.val[0];
+                uint8x16_t g = rgba.val[1];
+                uint8x16_t b = rgba.val[2];
+                if (kPack == ROW_PACK_RGB565_DITHER) {
+                    r = vqaddq_u8(r, ditherRB);
+                    g = vqaddq_u8(g, ditherG);
+                    b = vqaddq_u8(b, ditherRB);
+                }
+                uint8x16x2_t rgb565;
+                rgb565.val[0] = vsriq_n_u8(vshlq_n_u8(g, 3), b, 3);
+                rgb565.val[1] = vsriq_n_u8(r, g, 5);
+                vst2q_u8(dst + x * 2, rgb565);
+            }
+        }
+    }
+
+/*
+ * The expansion splits 298 into 256 + 42, so the product fits in 16 bits:
+ * (298 * y) >> 8 == y + ((42 * y) >> 8), saturated by vqadd.
+ */
+    template<int kLuma>
+    static void LumaRow_NEON(const unsigned char *srcY, unsigned char *dst, int width) {
+        for (int x = 0; x < width; x += NEON_LUMA_STEP) {
+            uint8x16_t y = vld1q_u8(srcY + x);
+            if (kLuma & ROW_LUMA_EXPAND) {
+                y = vqsubq_u8(y, vdupq_n_u8(16));
+                const uint16x8_t lo = vmull_u8(vget_low_u8(y), vdup_n_u8(42));
+                const uint16x8_t hi = vmull_u8(vget_high_u8(y), vdup_n_u8(42));
+                y = vqaddq_u8(y, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+            }
+            if (kLuma & ROW_LUMA_RGBA) {
+                uint8x16x4_t rgba;
+                const int alpha = kLuma & ROW_LUMA_ALPHA_FIRST ? 0 : 3;
+                rgba.val[0] = y;
+                rgba.val[1] = y;
+                rgba.val[2] = y;
+                rgba.val[3] = y;
+                rgba.val[alpha] = vdupq_n_u8(0xff);
+                vst4q_u8(dst + x * 4, rgba);
+            } else {
+                vst1q_u8(dst + x, y);
+            }
+        }
+    }
+
+    //vld4 takes the 4 bytes of 16 macropixels apart, vst2 interleaves the two y of each
+    template<int kPacked>
+    static void SplitPackedRow_NEON(const unsigned char *src, unsigned char *dstY,
+                                    unsigned char *dstU, unsigned char *dstV, int width) {
+        const int y = kPacked == ROW_PACKED_YUY2 ? 0 : 1;
+        const int u = kPacked == ROW_PACKED_YUY2 ? 1 : 0;
+        for (int x = 0; x < width; x += NEON_SPLIT_STEP) {
+            const uint8x16x4_t packed = vld4q_u8(src + x * 2);
+            uint8x16x2_t luma;
+            luma.val[0] = packed.val[y];
+            luma.val[1] = packed.val[y + 2];
+            vst2q_u8(dstY + x, luma);
+            vst1q_u8(dstU + (x >> 1), packed.val[u]);
+            vst1q_u8(dstV + (x >> 1), packed.val[u + 2]);
+        }
+    }
+
+/*
+ * RGBA to YUV, 16 pixels per loop, vld4 splits the channels. Luma is a
+ * widening multiply-accumulate of the unsigned weights. The 2x2 chroma
+ * blocks are pairwise widening adds of both rows and a rounding shift, the
+ * chroma weights are signed and wrap in the 16-bit lanes, see
+ * RGBToYUVCoefficients.
+ */
+    template<int kInput, class Coefficients>
+    static void RGBAToYRow_NEON(const unsigned char *src, unsigned char *dstY, int width) {
+        typedef RowOutputOrder<kInput> Order;
+        typedef Coefficients C;
+        const uint16x8_t offset = vdupq_n_u16((C::kYOffset << 8) + 128);
+        const uint8x8_t kR = vdup_n_u8(C::kYR);
+        const uint8x8_t kG = vdup_n_u8(C::kYG);
+        const uint8x8_t kB = vdup_n_u8(C::kYB);
+        for (int x = 0; x < width; x += NEON_RGBA_TO_YUV_STEP) {
+            const uint8x16x4_t p = vld4q_u8(src + x * 4);
+            uint16x8_t lo = vmlal_u8(offset, vget_low_u8(p.val[Order::kR]), kR);
+            uint16x8_t hi = vmlal_u8(offset, vget_high_u8(p.val[Order::kR]), kR);
+            lo = vmlal_u8(lo, vget_low_u8(p.val[Order::kG]), kG);
+            hi = vmlal_u8(hi, vget_high_u8(p.val[Order::kG]), kG);
+            lo = vmlal_u8(lo, vget_low_u8(p.val[Order::kB]), kB);
+            hi = vmlal_u8(hi, vget_high_u8(p.val[Order::kB]), kB);
+            vst1q_u8(dstY + x, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+        }
+    }
+
+    static inline uint8x8_t weighChroma(uint16x8_t r, uint16x8_t g, uint16x8_t b, int kR,
+                                        int kG, int kB) {
+        uint16x8_t sum = vmlaq_n_u16(vdupq_n_u16(RGB_TO_UV_OFFSET), r, static_cast<uint16_t>(kR));
+        sum = vmlaq_n_u16(sum, g, static_cast<uint16_t>(kG));
+        sum = vmlaq_n_u16(sum, b, static_cast<uint16_t>(kB));
+        return vshrn_n_u16(sum, 8);
+    }
+
+    template<int kChroma, int kInput, class Coefficients>
+    static void RGBAToUVRow_NEON(const unsigned char *src0, const unsigned char *src1,
+                                 unsigned char *dstU, unsigned char *dstV, int width) {
+        typedef RowOutputOrder<kInput> Order;
+        typedef Coefficients C;
+        for (int x = 0; x < width; x += NEON_RGBA_TO_YUV_STEP) {
+            const uint8x16x4_t p0 = vld4q_u8(src0 + x * 4);
+            const uint8x16x4_t p1 = vld4q_u8(src1 + x * 4);
+            const uint16x8_t r = vrshrq_n_u16(
+                    vpadalq_u8(vpaddlq_u8(p0.val[Order::kR]), p1.val[Order::kR]), 2);
+            const uint16x8_t g = vrshrq_n_u16(
+                    vpadalq_u8(vpaddlq_u8(p0.val[Order::kG]), p1.val[Order::kG]), 2);
+            const uint16x8_t b = vrshrq_n_u16(
+                    vpadalq_u8(vpaddlq_u8(p0.val[Order::kB]), p1.val[Order::kB]), 2);
+            const uint8x8_t u = weighChroma(r, g, b, C::kUR, C::kUG, C::kUB);
+            const uint8x8_t v = weighChroma(r, g, b, C::kVR, C::kVG, C::kVB);
+            if (kChroma == ROW_CHROMA_PLANAR) {
+                vst1_u8(dstU + (x >> 1), u);
+                vst1_u8(dstV + (x >> 1), v);
+            } else {
+                uint8x8x2_t uv;
+                uv.val[0] = kChroma == ROW_CHROMA_NV12 ? u : v;
+                uv.val[1] = kChroma == ROW_CHROMA_NV12 ? v : u;
+                vst2_u8((kChroma == ROW_CHROMA_NV12 ? dstU : dstV) + x, uv);
+            }
+        }
+    }
+
+/*
+ * 10-bit rows, 8 pixels per loop on 16-bit lanes. The 4:2:0 chroma samples are
+ * duplicated before the terms, which keeps one code path for every layout. The
+ * odd pixels of ROW_CHROMA_BILINEAR get vrhadd before the msb shift, as in C.
+ */
+    template<int kChroma, bool kMsb>
+    static inline void loadChroma16(const uint16_t *srcU, const uint16_t *srcV, int x,
+                                    uint16x8_t *u, uint16x8_t *v) {
+        if (kChroma == ROW_CHROMA_444) {
+            *u = vld1q_u16(srcU + x);
+            *v = vld1q_u16(srcV + x);
+        } else {
+            uint16x4_t u4;
+            uint16x4_t v4;
+            if (kChroma == ROW_CHROMA_NV12) {
+                const uint16x4x2_t uv = vld2_u16(srcU + x);
+                u4 = uv.val[0];
+                v4 = uv.val[1];
+            } else {
+                u4 = vld1_u16(srcU + (x >> 1));
+                v4 = vld1_u16(srcV + (x >> 1));
+            }
+            uint16x4_t oddU = u4;
+            uint16x4_t oddV = v4;
+            if (kChroma == ROW_CHROMA_BILINEAR) {
+                oddU = vrhadd_u16(u4, vld1_u16(srcU + (x >> 1) + 1));
+                oddV = vrhadd_u16(v4, vld1_u16(srcV + (x >> 1) + 1));
+            }
+            const uint16x4x2_t uu = vzip_u16(u4, oddU);
+            const uint16x4x2_t vv = vzip_u16(v4, oddV);
+            *u = vcombine_u16(uu.val[0], uu.val[1]);
+            *v = vcombine_u16(vv.val[0], vv.val[1]);
+        }
+        if (kMsb) {
+            *u = vshrq_n_u16(*u, 6);
+            *v = vshrq_n_u16(*v, 6);
+        }
+    }
+
+    static inline uint16x8_t
+    channel16(const ColorTransform &t, int channel, int16x8_t y, int16x8_t u, int16x8_t v) {
+        const int32x4_t offset = vdupq_n_s32(t.offset[channel] * 4);
+        int32x4_t lo = vmlal_n_s16(offset, vget_low_s16(y), t.y[channel]);
+        int32x4_t hi = vmlal_n_s16(offset, vget_high_s16(y), t.y[channel]);
+        lo = vmlal_n_s16(lo, vget_low_s16(u), t.u[channel]);
+        hi = vmlal_n_s16(hi, vget_high_s16(u), t.u[channel]);
+        lo = vmlal_n_s16(lo, vget_low_s16(v), t.v[channel]);
+        hi = vmlal_n_s16(hi, vget_high_s16(v), t.v[channel]);
+        return vminq_u16(vcombine_u16(vqshrun_n_s32(lo, 10), vqshrun_n_s32(hi, 10)),
+                         vdupq_n_u16(1023));
+    }
+
+    template<int kChroma, bool kMsb>
+    static void
+    YUV420ToRGBA16Row_NEON(const uint16_t *srcY, const uint16_t *srcU, const uint16_t *srcV,
+                           uint16_t *dst, int width, const ColorTransform *transform) {
+        const ColorTransform t = *transform;
+        const uint16x8_t kYOffset = vdupq_n_u16(static_cast<uint16_t>(t.yOffset * 4));
+        const uint16x8_t k512 = vdupq_n_u16(512);
+        for (int x = 0; x < width; x += NEON_ROW16_STEP) {
+            uint16x8_t y8 = vld1q_u16(srcY + x);
+            if (kMsb) {
+                y8 = vshrq_n_u16(y8, 6);
+            }
+            const int16x8_t y = vreinterpretq_s16_u16(vqsubq_u16(y8, kYOffset));
+            uint16x8_t u8;
+            uint16x8_t v8;
+            loadChroma16<kChroma, kMsb>(srcU, srcV, x, &u8, &v8);
+            const int16x8_t u = vreinterpretq_s16_u16(vsubq_u16(u8, k512));
+            const int16x8_t v = vreinterpretq_s16_u16(vsubq_u16(v8, k512));
+            uint16x8x4_t pixels;
+            pixels.val[0] = channel16(t, 0, y, u, v);
+            pixels.val[1] = channel16(t, 1, y, u, v);
+            pixels.val[2] = channel16(t, 2, y, u, v);
+            pixels.val[3] = vdupq_n_u16(1023);
+            vst4q_u16(dst + x * 4, pixels);
+        }
+    }
+
+    template<int kPack>
+    static void Pack16Row_NEON(const unsigned char *src, unsigned char *dst, int width, int) {
+        const uint16_t *pSrc = reinterpret_cast<const uint16_t *>(src);
+        for (int x = 0; x < width; x += NEON_PACK16_STEP) {
+            const uint16x8x4_t rgba = vld4q_u16(pSrc + x * 4);
+            if (kPack == ROW_PACK16_RGBA1010102) {
+                const uint32x4_t alpha = vdupq_n_u32(0xc0000000u);
+                uint32x4_t lo = vorrq_u32(alpha, vmovl_u16(vget_low_u16(rgba.val[0])));
+                uint32x4_t hi = vorrq_u32(alpha, vmovl_u16(vget_high_u16(rgba.val[0])));
+                lo = vorrq_u32(lo, vshll_n_u16(vget_low_u16(rgba.val[1]), 10));
+                hi = vorrq_u32(hi, vshll_n_u16(vget_high_u16(rgba.val[1]), 10));
+                lo = vorrq_u32(lo, vshlq_n_u32(vmovl_u16(vget_low_u16(rgba.val[2])), 20));
+                hi = vorrq_u32(hi, vshlq_n_u32(vmovl_u16(vget_high_u16(rgba.val[2])), 20));
+                vst1q_u8(dst + x * 4, vreinterpretq_u8_u32(lo));
+                vst1q_u8(dst + x * 4 + 16, vreinterpretq_u8_u32(hi));
+            } else {
+                typedef RowOutputOrder<kPack - ROW_PACK16_BYTES> Order;
+                uint8x8x4_t pixels;
+                pixels.val[Order::kR] = vshrn_n_u16(rgba.val[0], 2);
+                pixels.val[Order::kG] = vshrn_n_u16(rgba.val[1], 2);
+                pixels.val[Order::kB] = vshrn_n_u16(rgba.val[2], 2);
+                pixels.val[Order::kA] = vdup_n_u8(0xff);
+                vst4_u8(dst + x * 4, pixels);
+            }
+        }
+    }
+
+/*
+ * RAW10 unpacks 8 pixels from a 16 byte load, vtbl gathers the high bits and
+ * the byte of low bits of each pixel and vshl shifts the low bits per lane.
+ * RAW12 unpacks 16 pixels, vld3 splits the even and odd high bits and the low
+ * bits and vst2 interleaves the pixels again.
+ */
+    static const uint8_t RAW10_HIGH[8] = {0, 1, 2, 3, 5, 6, 7, 8};
+    static const uint8_t RAW10_LOW[8] = {4, 4, 4, 4, 9, 9, 9, 9};
+    static const int16_t RAW10_LOW_SHIFT[8] = {0, -2, -4, -6, 0, -2, -4, -6};
+
+    template<int kRaw>
+    static void UnpackRawRow_NEON(const unsigned char *src, uint16_t *dst, int width) {
+        if (kRaw == ROW_RAW10) {
+            const uint8x8_t kHigh = vld1_u8(RAW10_HIGH);
+            const uint8x8_t kLow = vld1_u8(RAW10_LOW);
+            const int16x8_t kLowShift = vld1q_s16(RAW10_LOW_SHIFT);
+            const uint16x8_t kLowMask = vdupq_n_u16(3);
+            for (int x = 0; x < width; x += NEON_RAW10_STEP) {
+                const uint8x16_t packed = vld1q_u8(src + x / 4 * 5);
+                uint8x8x2_t table;
+                table.val[0] = vget_low_u8(packed);
+                table.val[1] = vget_high_u8(packed);
+                const uint16x8_t low = vshlq_u16(vmovl_u8(vtbl2_u8(table, kLow)), kLowShift);
+                vst1q_u16(dst + x, vorrq_u16(vshll_n_u8(vtbl2_u8(table, kHigh), 2),
+                                             vandq_u16(low, kLowMask)));
+            }
+        } else {
+            const uint8x8_t kLowMask = vdup_n_u8(15);
+            for (int x = 0; x < width; x += NEON_RAW12_STEP) {
+                const uint8x8x3_t packed = vld3_u8(src + x / 2 * 3);
+                uint16x8x2_t pixels;
+                pixels.val[0] = vorrq_u16(vshll_n_u8(packed.val[0], 4),
+                                          vmovl_u8(vand_u8(packed.val[2], kLowMask)));
+                pixels.val[1] = vorrq_u16(vshll_n_u8(packed.val[1], 4),
+                                          vmovl_u8(vshr_n_u8(packed.val[2], 4)));
+                vst2q_u16(dst + x, pixels);
+            }
+        }
+    }
+
+/*
+ * 8 pixels per half with vrhadd, the even and odd columns are computed alike
+ * and selected with vbsl. The levels are vqsub and the high half of vmull,
+ * vqmovn saturates to bytes.
+ */
+    static const uint16_t BAYER_EVEN_LANES[8] = {0xffff, 0, 0xffff, 0, 0xffff, 0, 0xffff, 0};
+
+    static inline uint8x8_t
+    applyLevels(uint16x8_t c, uint16x8_t black, uint16x4_t scale) {
+        c = vqsubq_u16(c, black);
+        const uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(c), scale), 16);
+        const uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(c), scale), 16);
+        return vqmovn_u16(vcombine_u16(lo, hi));
+    }
+
+    template<int kBayer>
+    static inline void
+    demosaic8(const uint16_t *above, const uint16_t *row, const uint16_t *below,
+              uint16x8_t black, uint16x4_t scale, uint8x8_t *r, uint8x8_t *g, uint8x8_t *b) {
+        const bool kEvenGreen = kBayer == ROW_BAYER_GR || kBayer == ROW_BAYER_GB;
+        const bool kRedRow = kBayer == ROW_BAYER_RG || kBayer == ROW_BAYER_GR;
+        const uint16x8_t c = vld1q_u16(row);
+        const uint16x8_t h = vrhaddq_u16(vld1q_u16(row - 1), vld1q_u16(row + 1));
+        const uint16x8_t v = vrhaddq_u16(vld1q_u16(above), vld1q_u16(below));
+        const uint16x8_t cross = vrhaddq_u16(h, v);
+        const uint16x8_t diag = vrhaddq_u16(vrhaddq_u16(vld1q_u16(above - 1),
+                                                        vld1q_u16(above + 1)),
+                                            vrhaddq_u16(vld1q_u16(below - 1),
+                                                        vld1q_u16(below + 1)));
+        //own is the color of this row, other the color of the rows above and below
+        const uint16x8_t even = vld1q_u16(BAYER_EVEN_LANES);
+        const uint8x8_t own = applyLevels(kEvenGreen ? vbslq_u16(even, h, c)
+                                                     : vbslq_u16(even, c, h), black, scale);
+        const uint8x8_t green = applyLevels(kEvenGreen ? vbslq_u16(even, c, cross)
+                                                       : vbslq_u16(even, cross, c),
+                                            black, scale);
+        const uint8x8_t other = applyLevels(kEvenGreen ? vbslq_u16(even, v, diag)
+                                                       : vbslq_u16(even, diag, v),
+                                            black, scale);
+        *r = kRedRow ? own : other;
+        *g = green;
+        *b = kRedRow ? other : own;
+    }
+
+    template<int kBayer, int kOutput>
+    static void DemosaicRow_NEON(const uint16_t *above, const uint16_t *row,
+                                 const uint16_t *below, unsigned char *dst, int width, int black,
+                                 int scale) {
+        const uint16x8_t kBlack = vdupq_n_u16(static_cast<uint16_t>(black));
+        const uint16x4_t kScale = vdup_n_u16(static_cast<uint16_t>(scale));
+        for (int x = 0; x < width; x += NEON_DEMOSAIC_STEP) {
+            uint8x8_t r0, g0, b0, r1, g1, b1;
+            demosaic8<kBayer>(above + x, row + x, below + x, kBlack, kScale, &r0, &g0, &b0);
+            demosaic8<kBayer>(above + x + 8, row + x + 8, below + x + 8, kBlack, kScale,
+                              &r1, &g1, &b1);
+            storePixels<kOutput>(dst + x * 4, vcombine_u8(r0, r1), vcombine_u8(g0, g1),
+                                 vcombine_u8(b0, b1));
+        }
+    }
+
+/*
+ * Zipping register i with register i + 4 of 8 into registers 2i and 2i + 1
+ * rotates the bits of the element index by one, 3 rounds turn rows into
+ * columns: 8 rows of 16 bytes end up as 2 destination rows per register, 8
+ * rows of 8 16-bit elements as one. 8 rows fit in the registers of 32-bit arm
+ * too, and the rounds are written out so that they stay there whether the
+ * loops get unrolled or not.
+ */
+    template<int kBytesPerElement>
+    static inline void interleave(uint8x16_t a, uint8x16_t b, uint8x16_t *lo, uint8x16_t *hi) {
+        if (kBytesPerElement == 1) {
+            const uint8x16x2_t zipped = vzipq_u8(a, b);
+            *lo = zipped.val[0];
+            *hi = zipped.val[1];
+        } else {
+            const uint16x8x2_t zipped = vzipq_u16(vreinterpretq_u16_u8(a),
+                                                  vreinterpretq_u16_u8(b));
+            *lo = vreinterpretq_u8_u16(zipped.val[0]);
+            *hi = vreinterpretq_u8_u16(zipped.val[1]);
+        }
+    }
+
+    template<int kBytesPerElement>
+    static inline void transposeRound(const uint8x16_t r[8], uint8x16_t next[8]) {
+        interleave<kBytesPerElement>(r[0], r[4], &next[0], &next[1]);
+        interleave<kBytesPerElement>(r[1], r[5], &next[2], &next[3]);
+        interleave<kBytesPerElement>(r[2], r[6], &next[4], &next[5]);
+        interleave<kBytesPerElement>(r[3], r[7], &next[6], &next[7]);
+    }
+
+    template<int kBytesPerElement>
+    static inline void transposeRows8(const unsigned char *src, int srcRowStride,
+                                      uint8x16_t r[8]) {
+        uint8x16_t a[8];
+        uint8x16_t b[8];
+        for (int i = 0; i < 8; i++) {
+            a[i] = vld1q_u8(src + i * srcRowStride);
+        }
+        transposeRound<kBytesPerElement>(a, b);
+        transposeRound<kBytesPerElement>(b, a);
+        transposeRound<kBytesPerElement>(a, r);
+    }
+
+    template<int kBytesPerElement>
+    static void TransposeBlock_NEON(const unsigned char *src, int srcRowStride,
+                                    unsigned char *dst, int dstRowStride) {
+        uint8x16_t r[8];
+        if (kBytesPerElement == 2) {
+            transposeRows8<2>(src, srcRowStride, r);
+            for (int i = 0; i < 8; i++) {
+                vst1q_u8(dst + i * dstRowStride, r[i]);
+            }
+            return;
+        }
+        for (int half = 0; half < 2; half++) {
+            transposeRows8<1>(src + half * 8 * srcRowStride, srcRowStride, r);
+            unsigned char *pDst = dst + half * 8;
+            for (int i = 0; i < 8; i++) {
+                vst1_u8(pDst + i * 2 * dstRowStride, vget_low_u8(r[i]));
+                vst1_u8(pDst + (i * 2 + 1) * dstRowStride, vget_high_u8(r[i]));
+            }
+        }
+    }
+
+    //32-bit elements: rows 0/1 and 2/3 transposed in 2x2 blocks, then the halves swapped
+    static void TransposeBlock32_NEON(const unsigned char *src, int srcRowStride,
+                                      unsigned char *dst, int dstRowStride) {
+        const uint32x4x2_t t01 = vtrnq_u32(vreinterpretq_u32_u8(vld1q_u8(src)),
+                                           vreinterpretq_u32_u8(vld1q_u8(src + srcRowStride)));
+        const uint32x4x2_t t23 = vtrnq_u32(
+                vreinterpretq_u32_u8(vld1q_u8(src + srcRowStride * 2)),
+                vreinterpretq_u32_u8(vld1q_u8(src + srcRowStride * 3)));
+        vst1q_u8(dst, vreinterpretq_u8_u32(
+                vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0]))));
+        vst1q_u8(dst + dstRowStride, vreinterpretq_u8_u32(
+                vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1]))));
+        vst1q_u8(dst + dstRowStride * 2, vreinterpretq_u8_u32(
+                vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0]))));
+        vst1q_u8(dst + dstRowStride * 3, vreinterpretq_u8_u32(
+                vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1]))));
+    }
+
+    //8x8 bytes in 3 rounds of 2x2 transposes of 8, 16 and 32-bit elements
+    static inline void transposeBytes8x8(uint8x8_t r[8]) {
+        const uint8x8x2_t t0 = vtrn_u8(r[0], r[1]);
+        const uint8x8x2_t t1 = vtrn_u8(r[2], r[3]);
+        const uint8x8x2_t t2 = vtrn_u8(r[4], r[5]);
+        const uint8x8x2_t t3 = vtrn_u8(r[6], r[7]);
+        const uint16x4x2_t u0 = vtrn_u16(vreinterpret_u16_u8(t0.val[0]),
+                                         vreinterpret_u16_u8(t1.val[0]));
+        const uint16x4x2_t u1 = vtrn_u16(vreinterpret_u16_u8(t0.val[1]),
+                                         vreinterpret_u16_u8(t1.val[1]));
+        const uint16x4x2_t u2 = vtrn_u16(vreinterpret_u16_u8(t2.val[0]),
+                                         vreinterpret_u16_u8(t3.val[0]));
+        const uint16x4x2_t u3 = vtrn_u16(vreinterpret_u16_u8(t2.val[1]),
+                                         vreinterpret_u16_u8(t3.val[1]));
+        const uint32x2x2_t v0 = vtrn_u32(vreinterpret_u32_u16(u0.val[0]),
+                                         vreinterpret_u32_u16(u2.val[0]));
+        const uint32x2x2_t v1 = vtrn_u32(vreinterpret_u32_u16(u1.val[0]),
+                                         vreinterpret_u32_u16(u3.val[0]));
+        const uint32x2x2_t v2 = vtrn_u32(vreinterpret_u32_u16(u0.val[1]),
+                                         vreinterpret_u32_u16(u2.val[1]));
+        const uint32x2x2_t v3 = vtrn_u32(vreinterpret_u32_u16(u1.val[1]),
+                                         vreinterpret_u32_u16(u3.val[1]));
+        r[0] = vreinterpret_u8_u32(v0.val[0]);
+        r[1] = vreinterpret_u8_u32(v1.val[0]);
+        r[2] = vreinterpret_u8_u32(v2.val[0]);
+        r[3] = vreinterpret_u8_u32(v3.val[0]);
+        r[4] = vreinterpret_u8_u32(v0.val[1]);
+        r[5] = vreinterpret_u8_u32(v1.val[1]);
+        r[6] = vreinterpret_u8_u32(v2.val[1]);
+        r[7] = vreinterpret_u8_u32(v3.val[1]);
+    }
+
+    //RGB24: vld3 splits 8 pixels of a row into channels, each channel is transposed on its own
+    static void TransposeBlock24_NEON(const unsigned char *src, int srcRowStride,
+                                      unsigned char *dst, int dstRowStride) {
+        uint8x8x3_t rows[8];
+        for (int i = 0; i < 8; i++) {
+            rows[i] = vld3_u8(src + i * srcRowStride);
+        }
+        for (int c = 0; c < 3; c++) {
+            uint8x8_t channel[8];
+            for (int i = 0; i < 8; i++) {
+                channel[i] = rows[i].val[c];
+            }
+            transposeBytes8x8(channel);
+            for (int i = 0; i < 8; i++) {
+                rows[i].val[c] = channel[i];
+            }
+        }
+        for (int i = 0; i < 8; i++) {
+            vst3_u8(dst + i * dstRowStride, rows[i]);
+        }
+    }
+
+#ifdef __aarch64__
+/*
+ * The non-temporal store builtin becomes stnp on arm64, its q register pairs
+ * are aligned to 16 bytes like the vector type. The head and the tail are
+ * copied with memcpy.
+ */
+    static void StreamRow_NEON(const unsigned char *src, unsigned char *dst, int bytes) {
+        int x = static_cast<int>(-reinterpret_cast<uintptr_t>(dst) & 15);
+        x = x < bytes ? x : bytes;
+        memcpy(dst, src, x);
+        for (; x + 64 <= bytes; x += 64) {
+            uint8x16_t *pDst = reinterpret_cast<uint8x16_t *>(dst + x);
+            __builtin_nontemporal_store(vld1q_u8(src + x), pDst);
+            __builtin_nontemporal_store(vld1q_u8(src + x + 16), pDst + 1);
+            __builtin_nontemporal_store(vld1q_u8(src + x + 32), pDst + 2);
+            __builtin_nontemporal_store(vld1q_u8(src + x + 48), pDst + 3);
+        }
+        memcpy(dst + x, src + x, bytes - x);
+    }
+#endif
+
+    template<int kChroma, class Coefficients, bool kFast>
+    static inline YUV420ToRGBARowFunc selectRow(int output) {
+        typedef FastColorCoefficients<Coefficients> FastCoefficients;
+        return withRowOutput(output, [](auto order) -> YUV420ToRGBARowFunc {
+            const int kOutput = decltype(order)::value;
+            return kFast ? YUV420ToRGBAFastRow_NEON<kChroma, kOutput, FastCoefficients>
+                         : YUV420ToRGBARow_NEON<kChroma, kOutput, Coefficients>;
+        });
+    }
+
+    template<class Coefficients, bool kFast>
+    static inline YUV420ToRGBARowFunc selectChromaRow(int chroma, int output) {
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectRow<ROW_CHROMA_PLANAR, Coefficients, kFast>(output);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectRow<ROW_CHROMA_NV12, Coefficients, kFast>(output);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectRow<ROW_CHROMA_NV21, Coefficients, kFast>(output);
+        } else if (chroma == ROW_CHROMA_444) {
+            return selectRow<ROW_CHROMA_444, Coefficients, kFast>(output);
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return selectRow<ROW_CHROMA_BILINEAR, Coefficients, kFast>(output);
+        }
+        return nullptr;
+    }
+
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBARow(int chroma, int output, int matrix, int range, int *step) {
+        *step = NEON_ROW_STEP;
+        return withColorCoefficients(matrix, range, [chroma, output](auto coefficients) {
+            return selectChromaRow<decltype(coefficients), false>(chroma, output);
+        });
+    }
+
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBAFastRow(int chroma, int output, int matrix, int range, int *step) {
+        *step = NEON_ROW_STEP;
+        return withColorCoefficients(matrix, range, [chroma, output](auto coefficients) {
+            return selectChromaRow<decltype(coefficients), true>(chroma, output);
+        });
+    }
+
+    template<int kChroma>
+    static inline YUV420ToRGBATransformRowFunc selectTransformRow(int output) {
+        return withRowOutput(output, [](auto order) -> YUV420ToRGBATransformRowFunc {
+            return YUV420ToRGBATransformRow_NEON<kChroma, decltype(order)::value>;
+        });
+    }
+
+    YUV420ToRGBATransformRowFunc selectYUV420ToRGBATransformRow(int chroma, int output, int *step) {
+        *step = NEON_ROW_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectTransformRow<ROW_CHROMA_PLANAR>(output);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectTransformRow<ROW_CHROMA_NV12>(output);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectTransformRow<ROW_CHROMA_NV21>(output);
+        } else if (chroma == ROW_CHROMA_444) {
+            return selectTransformRow<ROW_CHROMA_444>(output);
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return selectTransformRow<ROW_CHROMA_BILINEAR>(output);
+        }
+        return nullptr;
+    }
+
+    BlendChromaRowFunc selectBlendChromaRow(int chroma, int *step) {
+        *step = NEON_BLEND_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return BlendChromaRow_NEON<ROW_CHROMA_PLANAR>;
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return BlendChromaRow_NEON<ROW_CHROMA_NV12>;
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return BlendChromaRow_NEON<ROW_CHROMA_NV21>;
+        }
+        return nullptr;
+    }
+
+    PackRowFunc selectPackRow(int pack, int *step) {
+        *step = NEON_PACK_STEP;
+        if (pack == ROW_PACK_RGB565) {
+            return PackRow_NEON<ROW_PACK_RGB565>;
+        } else if (pack == ROW_PACK_RGB565_DITHER) {
+            return PackRow_NEON<ROW_PACK_RGB565_DITHER>;
+        } else if (pack == ROW_PACK_RGB24) {
+            return PackRow_NEON<ROW_PACK_RGB24>;
+        } else if (pack == ROW_PACK_GRAY) {
+            return PackRow_NEON<ROW_PACK_GRAY>;
+        }
+        return nullptr;
+    }
+
+    LumaRowFunc selectLumaRow(int luma, int *step) {
+        *step = NEON_LUMA_STEP;
+        if (luma == ROW_LUMA_EXPAND) {
+            return LumaRow_NEON<ROW_LUMA_EXPAND>;
+        } else if (luma == ROW_LUMA_RGBA) {
+            return LumaRow_NEON<ROW_LUMA_RGBA>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_EXPAND)) {
+            return LumaRow_NEON<ROW_LUMA_RGBA | ROW_LUMA_EXPAND>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST)) {
+            return LumaRow_NEON<ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST | ROW_LUMA_EXPAND)) {
+            return LumaRow_NEON<ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST | ROW_LUMA_EXPAND>;
+        }
+        return nullptr;
+    }
+
+    SplitPackedRowFunc selectSplitPackedRow(int packed, int *step) {
+        *step = NEON_SPLIT_STEP;
+        if (packed == ROW_PACKED_YUY2) {
+            return SplitPackedRow_NEON<ROW_PACKED_YUY2>;
+        } else if (packed == ROW_PACKED_UYVY) {
+            return SplitPackedRow_NEON<ROW_PACKED_UYVY>;
+        }
+        return nullptr;
+    }
+
+    YUV420ToRGBA16RowFunc selectYUV420ToRGBA16Row(int chroma, bool msb, int *step) {
+        *step = NEON_ROW16_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return msb ? YUV420ToRGBA16Row_NEON<ROW_CHROMA_PLANAR, true>
+                       : YUV420ToRGBA16Row_NEON<ROW_CHROMA_PLANAR, false>;
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return msb ? YUV420ToRGBA16Row_NEON<ROW_CHROMA_NV12, true>
+                       : YUV420ToRGBA16Row_NEON<ROW_CHROMA_NV12, false>;
+        } else if (chroma == ROW_CHROMA_444) {
+            return msb ? YUV420ToRGBA16Row_NEON<ROW_CHROMA_444, true>
+                       : YUV420ToRGBA16Row_NEON<ROW_CHROMA_444, false>;
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return msb ? YUV420ToRGBA16Row_NEON<ROW_CHROMA_BILINEAR, true>
+                       : YUV420ToRGBA16Row_NEON<ROW_CHROMA_BILINEAR, false>;
+        }
+        return nullptr;
+    }
+
+    PackRowFunc selectPack16Row(int pack, int *step) {
+        *step = NEON_PACK16_STEP;
+        if (pack == ROW_PACK16_RGBA1010102) {
+            return Pack16Row_NEON<ROW_PACK16_RGBA1010102>;
+        }
+        return withRowOutput(pack - ROW_PACK16_BYTES, [](auto order) -> PackRowFunc {
+            return Pack16Row_NEON<ROW_PACK16_BYTES + decltype(order)::value>;
+        });
+    }
+
+    RGBAToYRowFunc selectRGBAToYRow(int input, int matrix, int range, int *step) {
+        *step = NEON_RGBA_TO_YUV_STEP;
+        return withColorCoefficients(matrix, range, [input](auto coefficients) {
+            typedef decltype(coefficients) C;
+            typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+            return withRowOutput(input, [](auto order) -> RGBAToYRowFunc {
+                return RGBAToYRow_NEON<decltype(order)::value, Coefficients>;
+            });
+        });
+    }
+
+    template<int kChroma>
+    static inline RGBAToUVRowFunc selectUVRow(int input, int matrix, int range) {
+        return withColorCoefficients(matrix, range, [input](auto coefficients) {
+            typedef decltype(coefficients) C;
+            typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+            return withRowOutput(input, [](auto order) -> RGBAToUVRowFunc {
+                return RGBAToUVRow_NEON<kChroma, decltype(order)::value, Coefficients>;
+            });
+        });
+    }
+
+    RGBAToUVRowFunc selectRGBAToUVRow(int chroma, int input, int matrix, int range, int *step) {
+        *step = NEON_RGBA_TO_YUV_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectUVRow<ROW_CHROMA_PLANAR>(input, matrix, range);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectUVRow<ROW_CHROMA_NV12>(input, matrix, range);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectUVRow<ROW_CHROMA_NV21>(input, matrix, range);
+        }
+        return nullptr;
+    }
+
+    UnpackRawRowFunc selectUnpackRawRow(int raw, int *step) {
+        if (raw == ROW_RAW10) {
+            *step = NEON_RAW10_STEP;
+            return UnpackRawRow_NEON<ROW_RAW10>;
+        } else if (raw == ROW_RAW12) {
+            *step = NEON_RAW12_STEP;
+            return UnpackRawRow_NEON<ROW_RAW12>;
+        }
+        return nullptr;
+    }
+
+    template<int kBayer>
+    static inline DemosaicRowFunc selectBayerRow(int output) {
+        return withRowOutput(output, [](auto order) -> DemosaicRowFunc {
+            return DemosaicRow_NEON<kBayer, decltype(order)::value>;
+        });
+    }
+
+    DemosaicRowFunc selectDemosaicRow(int bayer, int output, int *step) {
+        *step = NEON_DEMOSAIC_STEP;
+        if (bayer == ROW_BAYER_RG) {
+            return selectBayerRow<ROW_BAYER_RG>(output);
+        } else if (bayer == ROW_BAYER_GR) {
+            return selectBayerRow<ROW_BAYER_GR>(output);
+        } else if (bayer == ROW_BAYER_GB) {
+            return selectBayerRow<ROW_BAYER_GB>(output);
+        } else if (bayer == ROW_BAYER_BG) {
+            return selectBayerRow<ROW_BAYER_BG>(output);
+        }
+        return nullptr;
+    }
+
+    TransposeBlockFunc selectTransposeBlock(int bytesPerElement, int *step) {
+        if (bytesPerElement == 1) {
+            *step = 16;
+            return TransposeBlock_NEON<1>;
+        }
+        if (bytesPerElement == 2) {
+            *step = 8;
+            return TransposeBlock_NEON<2>;
+        }
+        if (bytesPerElement == 3) {
+            *step = 8;
+            return TransposeBlock24_NEON;
+        }
+        if (bytesPerElement == 4) {
+            *step = 4;
+            return TransposeBlock32_NEON;
+        }
+        return nullptr;
+    }
+
+    //32-bit arm has no non-temporal stores
+    StreamRowFunc selectStreamRow() {
+#ifdef __aarch64__
+        return StreamRow_NEON;
+#else
+        return nullptr;
+#endif
+    }
+}
+
+#endif //HAS_NEON_ROW
@@ -0,0 +1,1660 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_row.h"
+#include "native_color.h"
+
+#ifdef HAS_X86_ROW
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+/*
+ * The x86 ABIs are built for the baseline instruction set only, so every
+ * kernel is compiled with a target attribute and selected at runtime.
+ */
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+namespace native_utils {
+
+    const int SSE41_ROW_STEP = 16;
+    const int AVX2_ROW_STEP = 32;
+    const int SSE41_BLEND_STEP = 32;
+    const int AVX2_BLEND_STEP = 64;
+    const int SSE41_PACK_STEP = 16;
+    const int SSE41_LUMA_STEP = 16;
+    const int SSE41_SPLIT_STEP = 16;
+    const int SSE41_ROW16_STEP = 8;
+    const int SSE41_PACK16_STEP = 8;
+    const int SSE41_RGBA_TO_YUV_STEP = 16;
+    const int SSE41_RAW_STEP = 8;
+    const int SSE41_DEMOSAIC_STEP = 16;
+
+    //two int16 coefficients for one pmaddwd pair
+    static inline int coeffPair(int lo, int hi) {
+        return static_cast<int>((lo & 0xffff) | (static_cast<unsigned int>(hi) << 16));
+    }
+
+    bool cpuHasSSE41() {
+        static const bool hasSSE41 = __builtin_cpu_supports("sse4.1");
+        return hasSSE41;
+    }
+
+    bool cpuHasAVX2() {
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        return hasAVX2;
+    }
+
+/*
+ * 8 pixels of 16-bit y, u, v per channel. pmaddwd gives the exact 32-bit sums,
+ * packssdw + packuswb later clamp to [0, 255] like the K_MAX_CHANNEL_VALUE
+ * clamp and >> 10.
+ */
+    TARGET_SSE41 static inline __m128i madd_SSE41(__m128i a, __m128i b, __m128i coeffs, bool hi) {
+        return _mm_madd_epi16(hi ? _mm_unpackhi_epi16(a, b) : _mm_unpacklo_epi16(a, b), coeffs);
+    }
+
+    TARGET_SSE41 static inline __m128i narrow_SSE41(__m128i lo, __m128i hi) {
+        return _mm_packs_epi32(_mm_srai_epi32(lo, 10), _mm_srai_epi32(hi, 10));
+    }
+
+/*
+ * Terms policies, the luma offset and the 32-bit sums of a channel for the
+ * low or high 4 pixels: the constants of ColorCoefficients in native_color.h
+ * or a runtime ColorTransform.
+ */
+    template<class Coefficients>
+    struct CoefficientTerms_SSE41 {
+        TARGET_SSE41 CoefficientTerms_SSE41()
+                : mR(_mm_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kRV))),
+                  mG(_mm_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kGV))),
+                  mGU(_mm_set1_epi32(coeffPair(Coefficients::kGU, 0))),
+                  mB(_mm_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kBU))),
+                  mZero(_mm_setzero_si128()) {
+        }
+
+        inline int yOffset() const {
+            return Coefficients::kYOffset;
+        }
+
+        TARGET_SSE41 inline __m128i channel(int c, __m128i y, __m128i u, __m128i v, bool hi) const {
+            if (c == 0) {
+                return madd_SSE41(y, v, mR, hi);
+            } else if (c == 1) {
+                return _mm_add_epi32(madd_SSE41(y, v, mG, hi), madd_SSE41(u, mZero, mGU, hi));
+            }
+            return madd_SSE41(y, u, mB, hi);
+        }
+
+    private:
+        const __m128i mR;
+        const __m128i mG;
+        const __m128i mGU;
+        const __m128i mB;
+        const __m128i mZero;
+    };
+
+    struct TransformTerms_SSE41 {
+        TARGET_SSE41 explicit TransformTerms_SSE41(const ColorTransform &transform)
+                : mYOffset(transform.yOffset), mZero(_mm_setzero_si128()) {
+            for (int c = 0; c < 3; c++) {
+                mYV[c] = _mm_set1_epi32(coeffPair(transform.y[c], transform.v[c]));
+                mU[c] = _mm_set1_epi32(coeffPair(transform.u[c], 0));
+                mOffset[c] = _mm_set1_epi32(transform.offset[c]);
+            }
+        }
+
+        inline int yOffset() const {
+            return mYOffset;
+        }
+
+        TARGET_SSE41 inline __m128i channel(int c, __m128i y, __m128i u, __m128i v, bool hi) const {
+            return _mm_add_epi32(_mm_add_epi32(madd_SSE41(y, v, mYV[c], hi),
+                                                madd_SSE41(u, mZero, mU[c], hi)), mOffset[c]);
+        }
+
+    private:
+        const int mYOffset;
+        const __m128i mZero;
+        __m128i mYV[3];
+        __m128i mU[3];
+        __m128i mOffset[3];
+    };
+
+    //split 16 interleaved NV12 or NV21 pairs into u and v
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    splitChroma_SSE41(__m128i c0, __m128i c1, __m128i *u, __m128i *v) {
+        const __m128i kEven = _mm_set1_epi16(0xff);
+        __m128i even = _mm_packus_epi16(_mm_and_si128(c0, kEven), _mm_and_si128(c1, kEven));
+        __m128i odd = _mm_packus_epi16(_mm_srli_epi16(c0, 8), _mm_srli_epi16(c1, 8));
+        *u = kChroma == ROW_CHROMA_NV12 ? even : odd;
+        *v = kChroma == ROW_CHROMA_NV12 ? odd : even;
+    }
+
+/*
+ * Load 16 chroma samples of u and v starting at column x, for the AVX2
+ * kernel, or 8 samples in the low half, for the SSE4.1 kernel. The rows of
+ * ROW_CHROMA_BILINEAR load like planar ones.
+ */
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    loadChroma16_SSE41(const unsigned char *srcU, const unsigned char *srcV, int x,
+                       __m128i *u, __m128i *v) {
+        if (kChroma == ROW_CHROMA_PLANAR || kChroma == ROW_CHROMA_BILINEAR) {
+            *u = _mm_loadu_si128((const __m128i *) (srcU + (x >> 1)));
+            *v = _mm_loadu_si128((const __m128i *) (srcV + (x >> 1)));
+        } else {
+            const unsigned char *src = kChroma == ROW_CHROMA_NV12 ? srcU : srcV;
+            splitChroma_SSE41<kChroma>(_mm_loadu_si128((const __m128i *) (src + x)),
+                                       _mm_loadu_si128((const __m128i *) (src + x + 16)), u, v);
+        }
+    }
+
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    loadChroma8_SSE41(const unsigned char *srcU, const unsigned char *srcV, int x,
+                      __m128i *u, __m128i *v) {
+        if (kChroma == ROW_CHROMA_PLANAR || kChroma == ROW_CHROMA_BILINEAR) {
+            *u = _mm_loadl_epi64((const __m128i *) (srcU + (x >> 1)));
+            *v = _mm_loadl_epi64((const __m128i *) (srcV + (x >> 1)));
+        } else {
+            const __m128i kEven = _mm_set1_epi16(0xff);
+            const unsigned char *src = kChroma == ROW_CHROMA_NV12 ? srcU : srcV;
+            __m128i c = _mm_loadu_si128((const __m128i *) (src + x));
+            __m128i even = _mm_packus_epi16(_mm_and_si128(c, kEven), c);
+            __m128i odd = _mm_packus_epi16(_mm_srli_epi16(c, 8), c);
+            *u = kChroma == ROW_CHROMA_NV12 ? even : odd;
+            *v = kChroma == ROW_CHROMA_NV12 ? odd : even;
+        }
+    }
+
+/*
+ * Chroma of 16 pixels starting at column x, duplicated for 4:2:0. The odd
+ * pixels of ROW_CHROMA_BILINEAR get the pavgb of their sample and the next
+ * one, loaded again one sample further.
+ */
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    loadPixelChroma16_SSE41(const unsigned char *srcU, const unsigned char *srcV, int x,
+                            __m128i *u, __m128i *v) {
+        if (kChroma == ROW_CHROMA_444) {
+            *u = _mm_loadu_si128((const __m128i *) (srcU + x));
+            *v = _mm_loadu_si128((const __m128i *) (srcV + x));
+        } else {
+            loadChroma8_SSE41<kChroma>(srcU, srcV, x, u, v);
+            __m128i oddU = *u;
+            __m128i oddV = *v;
+            if (kChroma == ROW_CHROMA_BILINEAR) {
+                loadChroma8_SSE41<kChroma>(srcU + 1, srcV + 1, x, &oddU, &oddV);
+                oddU = _mm_avg_epu8(*u, oddU);
+                oddV = _mm_avg_epu8(*v, oddV);
+            }
+            *u = _mm_unpacklo_epi8(*u, oddU);
+            *v = _mm_unpacklo_epi8(*v, oddV);
+        }
+    }
+
+/*
+ * Chroma of 32 pixels starting at column x, pixels 0-15 in u[0] and v[0].
+ */
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    loadPixelChroma32_SSE41(const unsigned char *srcU, const unsigned char *srcV, int x,
+                            __m128i u[2], __m128i v[2]) {
+        if (kChroma == ROW_CHROMA_444) {
+            loadPixelChroma16_SSE41<kChroma>(srcU, srcV, x, &u[0], &v[0]);
+            loadPixelChroma16_SSE41<kChroma>(srcU, srcV, x + 16, &u[1], &v[1]);
+        } else {
+            __m128i u8;
+            __m128i v8;
+            loadChroma16_SSE41<kChroma>(srcU, srcV, x, &u8, &v8);
+            __m128i oddU = u8;
+            __m128i oddV = v8;
+            if (kChroma == ROW_CHROMA_BILINEAR) {
+                loadChroma16_SSE41<kChroma>(srcU + 1, srcV + 1, x, &oddU, &oddV);
+                oddU = _mm_avg_epu8(u8, oddU);
+                oddV = _mm_avg_epu8(v8, oddV);
+            }
+            u[0] = _mm_unpacklo_epi8(u8, oddU);
+            u[1] = _mm_unpackhi_epi8(u8, oddU);
+            v[0] = _mm_unpacklo_epi8(v8, oddV);
+            v[1] = _mm_unpackhi_epi8(v8, oddV);
+        }
+    }
+
+/*
+ * Interleave 16 pixels of r, g, b and alpha in the byte order of kOutput, the
+ * channels are only renamed at compile time so every order costs the same.
+ */
+    template<int kOutput>
+    TARGET_SSE41 static inline void
+    storePixels16_SSE41(unsigned char *dst, __m128i r, __m128i g, __m128i b, __m128i alpha) {
+        typedef RowOutputOrder<kOutput> Order;
+        __m128i c[4];
+        c[Order::kR] = r;
+        c[Order::kG] = g;
+        c[Order::kB] = b;
+        c[Order::kA] = alpha;
+        __m128i *pDst = (__m128i *) dst;
+        for (int i = 0; i < 2; i++) {
+            const __m128i c01 = i == 0 ? _mm_unpacklo_epi8(c[0], c[1])
+                                       : _mm_unpackhi_epi8(c[0], c[1]);
+            const __m128i c23 = i == 0 ? _mm_unpacklo_epi8(c[2], c[3])
+                                       : _mm_unpackhi_epi8(c[2], c[3]);
+            _mm_storeu_si128(pDst + i * 2, _mm_unpacklo_epi16(c01, c23));
+            _mm_storeu_si128(pDst + i * 2 + 1, _mm_unpackhi_epi16(c01, c23));
+        }
+    }
+
+    template<int kChroma, int kOutput, class Terms>
+    TARGET_SSE41 static inline void
+    convertRow_SSE41(const unsigned char *srcY, const unsigned char *srcU,
+                     const unsigned char *srcV, unsigned char *dst, int width, const Terms &terms) {
+        const __m128i kYOffset = _mm_set1_epi8(static_cast<char>(terms.yOffset()));
+        const __m128i k128 = _mm_set1_epi16(128);
+        const __m128i kAlpha = _mm_set1_epi8(-1);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_ROW_STEP) {
+            __m128i y = _mm_subs_epu8(_mm_loadu_si128((const __m128i *) (srcY + x)), kYOffset);
+            __m128i u;
+            __m128i v;
+            loadPixelChroma16_SSE41<kChroma>(srcU, srcV, x, &u, &v);
+
+            __m128i rgb[2][3];
+            for (int i = 0; i < 2; i++) {
+                __m128i y16 = i == 0 ? _mm_cvtepu8_epi16(y) : _mm_unpackhi_epi8(y, zero);
+                __m128i u16 = _mm_sub_epi16(
+                        i == 0 ? _mm_cvtepu8_epi16(u) : _mm_unpackhi_epi8(u, zero), k128);
+                __m128i v16 = _mm_sub_epi16(
+                        i == 0 ? _mm_cvtepu8_epi16(v) : _mm_unpackhi_epi8(v, zero), k128);
+                for (int c = 0; c < 3; c++) {
+                    rgb[i][c] = narrow_SSE41(terms.channel(c, y16, u16, v16, false),
+                                             terms.channel(c, y16, u16, v16, true));
+                }
+            }
+            __m128i r = _mm_packus_epi16(rgb[0][0], rgb[1][0]);
+            __m128i g = _mm_packus_epi16(rgb[0][1], rgb[1][1]);
+            __m128i b = _mm_packus_epi16(rgb[0][2], rgb[1][2]);
+            storePixels16_SSE41<kOutput>(dst + x * 4, r, g, b, kAlpha);
+        }
+    }
+
+    TARGET_AVX2 static inline __m256i madd_AVX2(__m256i a, __m256i b, __m256i coeffs, bool hi) {
+        return _mm256_madd_epi16(hi ? _mm256_unpackhi_epi16(a, b) : _mm256_unpacklo_epi16(a, b),
+                                 coeffs);
+    }
+
+    TARGET_AVX2 static inline __m256i narrow_AVX2(__m256i lo, __m256i hi) {
+        return _mm256_packs_epi32(_mm256_srai_epi32(lo, 10), _mm256_srai_epi32(hi, 10));
+    }
+
+    template<class Coefficients>
+    struct CoefficientTerms_AVX2 {
+        TARGET_AVX2 CoefficientTerms_AVX2()
+                : mR(_mm256_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kRV))),
+                  mG(_mm256_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kGV))),
+                  mGU(_mm256_set1_epi32(coeffPair(Coefficients::kGU, 0))),
+                  mB(_mm256_set1_epi32(coeffPair(Coefficients::kY, Coefficients::kBU))),
+                  mZero(_mm256_setzero_si256()) {
+        }
+
+        inline int yOffset() const {
+            return Coefficients::kYOffset;
+        }
+
+        TARGET_AVX2 inline __m256i channel(int c, __m256i y, __m256i u, __m256i v, bool hi) const {
+            if (c == 0) {
+                return madd_AVX2(y, v, mR, hi);
+            } else if (c == 1) {
+                return _mm256_add_epi32(madd_AVX2(y, v, mG, hi), madd_AVX2(u, mZero, mGU, hi));
+            }
+            return madd_AVX2(y, u, mB, hi);
+        }
+
+    private:
+        const __m256i mR;
+        const __m256i mG;
+        const __m256i mGU;
+        const __m256i mB;
+        const __m256i mZero;
+    };
+
+    struct TransformTerms_AVX2 {
+        TARGET_AVX2 explicit TransformTerms_AVX2(const ColorTransform &transform)
+                : mYOffset(transform.yOffset), mZero(_mm256_setzero_si256()) {
+            for (int c = 0; c < 3; c++) {
+                mYV[c] = _mm256_set1_epi32(coeffPair(transform.y[c], transform.v[c]));
+                mU[c] = _mm256_set1_epi32(coeffPair(transform.u[c], 0));
+                mOffset[c] = _mm256_set1_epi32(transform.offset[c]);
+            }
+        }
+
+        inline int yOffset() const {
+            return mYOffset;
+        }
+
+        TARGET_AVX2 inline __m256i channel(int c, __m256i y, __m256i u, __m256i v, bool hi) const {
+            return _mm256_add_epi32(_mm256_add_epi32(madd_AVX2(y, v, mYV[c], hi),
+                                                madd_AVX2(u, mZero, mU[c], hi)), mOffset[c]);
+        }
+
+    private:
+        const int mYOffset;
+        const __m256i mZero;
+        __m256i mYV[3];
+        __m256i mU[3];
+        __m256i mOffset[3];
+    };
+
+/*
+ * Same as storePixels16_SSE41 for 32 pixels. unpack works inside each 128-bit
+ * lane, one vperm2i128 per 8 output pixels puts them back in order. kSplit is
+ * the layout left by packuswb of two 16 pixel halves, pixels 0-7, 16-23 |
+ * 8-15, 24-31 in each channel, instead of pixels 0-15 | 16-31.
+ */
+    template<int kOutput, bool kSplit>
+    TARGET_AVX2 static inline void
+    storePixels32_AVX2(unsigned char *dst, __m256i r, __m256i g, __m256i b, __m256i alpha) {
+        typedef RowOutputOrder<kOutput> Order;
+        __m256i c[4];
+        c[Order::kR] = r;
+        c[Order::kG] = g;
+        c[Order::kB] = b;
+        c[Order::kA] = alpha;
+        __m256i *pDst = (__m256i *) dst;
+        for (int i = 0; i < 2; i++) {
+            const __m256i c01 = i == 0 ? _mm256_unpacklo_epi8(c[0], c[1])
+                                       : _mm256_unpackhi_epi8(c[0], c[1]);
+            const __m256i c23 = i == 0 ? _mm256_unpacklo_epi8(c[2], c[3])
+                                       : _mm256_unpackhi_epi8(c[2], c[3]);
+            const __m256i lo = _mm256_unpacklo_epi16(c01, c23);
+            const __m256i hi = _mm256_unpackhi_epi16(c01, c23);
+            const int first = kSplit ? i * 2 : i;
+            const int second = kSplit ? i * 2 + 1 : i + 2;
+            _mm256_storeu_si256(pDst + first, _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(pDst + second, _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+    }
+
+/*
+ * unpack and pack work inside each 128-bit lane, so after packuswb a channel
+ * holds pixels 0-7, 16-23 | 8-15, 24-31.
+ */
+    template<int kChroma, int kOutput, class Terms>
+    TARGET_AVX2 static inline void
+    convertRow_AVX2(const unsigned char *srcY, const unsigned char *srcU,
+                    const unsigned char *srcV, unsigned char *dst, int width, const Terms &terms) {
+        const __m128i kYOffset = _mm_set1_epi8(static_cast<char>(terms.yOffset()));
+        const __m256i k128 = _mm256_set1_epi16(128);
+        const __m256i kAlpha = _mm256_set1_epi8(-1);
+        for (int x = 0; x < width; x += AVX2_ROW_STEP) {
+            __m128i u[2];
+            __m128i v[2];
+            loadPixelChroma32_SSE41<kChroma>(srcU, srcV, x, u, v);
+
+            __m256i rgb[2][3];
+            for (int i = 0; i < 2; i++) {
+                __m128i y8 = _mm_loadu_si128((const __m128i *) (srcY + x + i * 16));
+                __m256i y16 = _mm256_cvtepu8_epi16(_mm_subs_epu8(y8, kYOffset));
+                __m256i u16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(u[i]), k128);
+                __m256i v16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(v[i]), k128);
+                for (int c = 0; c < 3; c++) {
+                    rgb[i][c] = narrow_AVX2(terms.channel(c, y16, u16, v16, false),
+                                            terms.channel(c, y16, u16, v16, true));
+                }
+            }
+            __m256i r = _mm256_packus_epi16(rgb[0][0], rgb[1][0]);
+            __m256i g = _mm256_packus_epi16(rgb[0][1], rgb[1][1]);
+            __m256i b = _mm256_packus_epi16(rgb[0][2], rgb[1][2]);
+            storePixels32_AVX2<kOutput, true>(dst + x * 4, r, g, b, kAlpha);
+        }
+    }
+
+    template<int kChroma, int kOutput, class Coefficients>
+    TARGET_SSE41 static void
+    YUV420ToRGBARow_SSE41(const unsigned char *srcY, const unsigned char *srcU,
+                          const unsigned char *srcV, unsigned char *dst, int width) {
+        convertRow_SSE41<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                           CoefficientTerms_SSE41<Coefficients>());
+    }
+
+    template<int kChroma, int kOutput>
+    TARGET_SSE41 static void
+    YUV420ToRGBATransformRow_SSE41(const unsigned char *srcY, const unsigned char *srcU,
+                                   const unsigned char *srcV, unsigned char *dst, int width,
+                                   const ColorTransform *transform) {
+        convertRow_SSE41<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                           TransformTerms_SSE41(*transform));
+    }
+
+    template<int kChroma, int kOutput, class Coefficients>
+    TARGET_AVX2 static void
+    YUV420ToRGBARow_AVX2(const unsigned char *srcY, const unsigned char *srcU,
+                         const unsigned char *srcV, unsigned char *dst, int width) {
+        convertRow_AVX2<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                          CoefficientTerms_AVX2<Coefficients>());
+    }
+
+    template<int kChroma, int kOutput>
+    TARGET_AVX2 static void
+    YUV420ToRGBATransformRow_AVX2(const unsigned char *srcY, const unsigned char *srcU,
+                                  const unsigned char *srcV, unsigned char *dst, int width,
+                                  const ColorTransform *transform) {
+        convertRow_AVX2<kChroma, kOutput>(srcY, srcU, srcV, dst, width,
+                                          TransformTerms_AVX2(*transform));
+    }
+
+/*
+ * CONVERT_PRECISION_FAST on 8 or 16 lanes of int16. kY * nY fits uint16, so
+ * pmullw + psrlw give the luma term, paddsw saturates only sums that clamp to
+ * 255 anyway and psraw + packuswb do the >> 6 and the clamp.
+ */
+    template<class Coefficients>
+    struct FastTerms_SSE41 {
+        TARGET_SSE41 FastTerms_SSE41()
+                : mY(_mm_set1_epi16(Coefficients::kY)),
+                  mRV(_mm_set1_epi16(Coefficients::kRV)),
+                  mGU(_mm_set1_epi16(Coefficients::kGU)),
+                  mGV(_mm_set1_epi16(Coefficients::kGV)),
+                  mBU(_mm_set1_epi16(Coefficients::kBU)),
+                  m128(_mm_set1_epi16(128)) {
+        }
+
+        TARGET_SSE41 inline __m128i luma(__m128i y16) const {
+            return _mm_srli_epi16(_mm_mullo_epi16(y16, mY), 1);
+        }
+
+        //r, g, b terms of 8 chroma samples
+        TARGET_SSE41 inline void chroma(__m128i u8, __m128i v8, __m128i c[3]) const {
+            const __m128i u = _mm_sub_epi16(_mm_cvtepu8_epi16(u8), m128);
+            const __m128i v = _mm_sub_epi16(_mm_cvtepu8_epi16(v8), m128);
+            c[0] = _mm_mullo_epi16(v, mRV);
+            c[1] = _mm_add_epi16(_mm_mullo_epi16(u, mGU), _mm_mullo_epi16(v, mGV));
+            c[2] = _mm_mullo_epi16(u, mBU);
+        }
+
+        TARGET_SSE41 static inline __m128i channel(__m128i yLo, __m128i yHi, __m128i cLo,
+                                                   __m128i cHi) {
+            return _mm_packus_epi16(
+                    _mm_srai_epi16(_mm_adds_epi16(yLo, cLo), Coefficients::kFractionBits),
+                    _mm_srai_epi16(_mm_adds_epi16(yHi, cHi), Coefficients::kFractionBits));
+        }
+
+    private:
+        const __m128i mY;
+        const __m128i mRV;
+        const __m128i mGU;
+        const __m128i mGV;
+        const __m128i mBU;
+        const __m128i m128;
+    };
+
+    template<int kChroma, int kOutput, class Coefficients>
+    TARGET_SSE41 static void
+    YUV420ToRGBAFastRow_SSE41(const unsigned char *srcY, const unsigned char *srcU,
+                              const unsigned char *srcV, unsigned char *dst, int width) {
+        const FastTerms_SSE41<Coefficients> terms;
+        const __m128i kYOffset = _mm_set1_epi8(static_cast<char>(Coefficients::kYOffset));
+        const __m128i kAlpha = _mm_set1_epi8(-1);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_ROW_STEP) {
+            __m128i y = _mm_subs_epu8(_mm_loadu_si128((const __m128i *) (srcY + x)), kYOffset);
+            const __m128i yLo = terms.luma(_mm_cvtepu8_epi16(y));
+            const __m128i yHi = terms.luma(_mm_unpackhi_epi8(y, zero));
+
+            __m128i lo[3];
+            __m128i hi[3];
+            __m128i u;
+            __m128i v;
+            if (kChroma == ROW_CHROMA_444 || kChroma == ROW_CHROMA_BILINEAR) {
+                loadPixelChroma16_SSE41<kChroma>(srcU, srcV, x, &u, &v);
+                terms.chroma(u, v, lo);
+                terms.chroma(_mm_unpackhi_epi64(u, u), _mm_unpackhi_epi64(v, v), hi);
+            } else {
+                //duplicate the terms of 8 chroma samples for 16 pixels
+                loadChroma8_SSE41<kChroma>(srcU, srcV, x, &u, &v);
+                terms.chroma(u, v, lo);
+                for (int c = 0; c < 3; c++) {
+                    hi[c] = _mm_unpackhi_epi16(lo[c], lo[c]);
+                    lo[c] = _mm_unpacklo_epi16(lo[c], lo[c]);
+                }
+            }
+            __m128i r = terms.channel(yLo, yHi, lo[0], hi[0]);
+            __m128i g = terms.channel(yLo, yHi, lo[1], hi[1]);
+            __m128i b = terms.channel(yLo, yHi, lo[2], hi[2]);
+            storePixels16_SSE41<kOutput>(dst + x * 4, r, g, b, kAlpha);
+        }
+    }
+
+    template<class Coefficients>
+    struct FastTerms_AVX2 {
+        TARGET_AVX2 FastTerms_AVX2()
+                : mY(_mm256_set1_epi16(Coefficients::kY)),
+                  mRV(_mm256_set1_epi16(Coefficients::kRV)),
+                  mGU(_mm256_set1_epi16(Coefficients::kGU)),
+                  mGV(_mm256_set1_epi16(Coefficients::kGV)),
+                  mBU(_mm256_set1_epi16(Coefficients::kBU)),
+                  m128(_mm256_set1_epi16(128)) {
+        }
+
+        TARGET_AVX2 inline __m256i luma(__m256i y16) const {
+            return _mm256_srli_epi16(_mm256_mullo_epi16(y16, mY), 1);
+        }
+
+        //r, g, b terms of 16 chroma samples
+        TARGET_AVX2 inline void chroma(__m256i u16, __m256i v16, __m256i c[3]) const {
+            const __m256i u = _mm256_sub_epi16(u16, m128);
+            const __m256i v = _mm256_sub_epi16(v16, m128);
+            c[0] = _mm256_mullo_epi16(v, mRV);
+            c[1] = _mm256_add_epi16(_mm256_mullo_epi16(u, mGU), _mm256_mullo_epi16(v, mGV));
+            c[2] = _mm256_mullo_epi16(u, mBU);
+        }
+
+        TARGET_AVX2 static inline __m256i channel(__m256i yLo, __m256i yHi, __m256i cLo,
+                                                  __m256i cHi) {
+            return _mm256_packus_epi16(
+                    _mm256_srai_epi16(_mm256_adds_epi16(yLo, cLo), Coefficients::kFractionBits),
+                    _mm256_srai_epi16(_mm256_adds_epi16(yHi, cHi), Coefficients::kFractionBits));
+        }
+
+    private:
+        const __m256i mY;
+        const __m256i mRV;
+        const __m256i mGU;
+        const __m256i mGV;
+        const __m256i mBU;
+        const __m256i m128;
+    };
+
+/*
+ * Luma is unpacked inside the 128-bit lanes, pixels 0-7, 16-23 in yLo and
+ * 8-15, 24-31 in yHi, and so is the duplicated 4:2:0 chroma. packuswb then
+ * puts the channels back in pixel order.
+ */
+    template<int kChroma, int kOutput, class Coefficients>
+    TARGET_AVX2 static void
+    YUV420ToRGBAFastRow_AVX2(const unsigned char *srcY, const unsigned char *srcU,
+                             const unsigned char *srcV, unsigned char *dst, int width) {
+        const FastTerms_AVX2<Coefficients> terms;
+        const __m256i kYOffset = _mm256_set1_epi8(static_cast<char>(Coefficients::kYOffset));
+        const __m256i kAlpha = _mm256_set1_epi8(-1);
+        const __m256i zero = _mm256_setzero_si256();
+        for (int x = 0; x < width; x += AVX2_ROW_STEP) {
+            __m256i y = _mm256_subs_epu8(_mm256_loadu_si256((const __m256i *) (srcY + x)),
+                                         kYOffset);
+            const __m256i yLo = terms.luma(_mm256_unpacklo_epi8(y, zero));
+            const __m256i yHi = terms.luma(_mm256_unpackhi_epi8(y, zero));
+
+            __m256i lo[3];
+            __m256i hi[3];
+            if (kChroma == ROW_CHROMA_444 || kChroma == ROW_CHROMA_BILINEAR) {
+                __m128i u[2];
+                __m128i v[2];
+                loadPixelChroma32_SSE41<kChroma>(srcU, srcV, x, u, v);
+                const __m256i u8 = _mm256_set_m128i(u[1], u[0]);
+                const __m256i v8 = _mm256_set_m128i(v[1], v[0]);
+                terms.chroma(_mm256_unpacklo_epi8(u8, zero), _mm256_unpacklo_epi8(v8, zero), lo);
+                terms.chroma(_mm256_unpackhi_epi8(u8, zero), _mm256_unpackhi_epi8(v8, zero), hi);
+            } else {
+                __m128i u;
+                __m128i v;
+                loadChroma16_SSE41<kChroma>(srcU, srcV, x, &u, &v);
+                terms.chroma(_mm256_cvtepu8_epi16(u), _mm256_cvtepu8_epi16(v), lo);
+                for (int c = 0; c < 3; c++) {
+                    hi[c] = _mm256_unpackhi_epi16(lo[c], lo[c]);
+                    lo[c] = _mm256_unpacklo_epi16(lo[c], lo[c]);
+                }
+            }
+            __m256i r = terms.channel(yLo, yHi, lo[0], hi[0]);
+            __m256i g = terms.channel(yLo, yHi, lo[1], hi[1]);
+            __m256i b = terms.channel(yLo, yHi, lo[2], hi[2]);
+            storePixels32_AVX2<kOutput, false>(dst + x * 4, r, g, b, kAlpha);
+        }
+    }
+
+/*
+ * (3 * near + far + 2) >> 2 for 16 samples without widening: with the floor
+ * of (near + far) / 2 from pavgb, pavgb(near, floor) is the same value, as
+ * 3 * near + far + 2 is odd whenever near + far is. NV12 and NV21 pairs are
+ * blended as they are and split once.
+ */
+    TARGET_SSE41 static inline __m128i blendChroma_SSE41(__m128i near, __m128i far) {
+        const __m128i kOne = _mm_set1_epi8(1);
+        const __m128i half = _mm_sub_epi8(_mm_avg_epu8(near, far),
+                                          _mm_and_si128(_mm_xor_si128(near, far), kOne));
+        return _mm_avg_epu8(near, half);
+    }
+
+    template<int kChroma>
+    TARGET_SSE41 static inline void
+    loadBlendedChroma_SSE41(const unsigned char *nearU, const unsigned char *nearV,
+                            const unsigned char *farU, const unsigned char *farV, int x,
+                            __m128i *u, __m128i *v) {
+        if (kChroma == ROW_CHROMA_PLANAR) {
+            *u = blendChroma_SSE41(_mm_loadu_si128((const __m128i *) (nearU + (x >> 1))),
+                                   _mm_loadu_si128((const __m128i *) (farU + (x >> 1))));
+            *v = blendChroma_SSE41(_mm_loadu_si128((const __m128i *) (nearV + (x >> 1))),
+                                   _mm_loadu_si128((const __m128i *) (farV + (x >> 1))));
+        } else {
+            const unsigned char *near = kChroma == ROW_CHROMA_NV12 ? nearU : nearV;
+            const unsigned char *far = kChroma == ROW_CHROMA_NV12 ? farU : farV;
+            const __m128i c0 = blendChroma_SSE41(_mm_loadu_si128((const __m128i *) (near + x)),
+                                                 _mm_loadu_si128((const __m128i *) (far + x)));
+            const __m128i c1 = blendChroma_SSE41(
+                    _mm_loadu_si128((const __m128i *) (near + x + 16)),
+                    _mm_loadu_si128((const __m128i *) (far + x + 16)));
+            splitChroma_SSE41<kChroma>(c0, c1, u, v);
+        }
+    }
+
+    template<int kChroma>
+    TARGET_SSE41 static void
+    BlendChromaRow_SSE41(const unsigned char *nearU, const unsigned char *nearV,
+                         const unsigned char *farU, const unsigned char *farV,
+                         unsigned char *dstU, unsigned char *dstV, int width) {
+        for (int x = 0; x < width; x += SSE41_BLEND_STEP) {
+            __m128i u;
+            __m128i v;
+            loadBlendedChroma_SSE41<kChroma>(nearU, nearV, farU, farV, x, &u, &v);
+            _mm_storeu_si128((__m128i *) (dstU + (x >> 1)), u);
+            _mm_storeu_si128((__m128i *) (dstV + (x >> 1)), v);
+        }
+    }
+
+/*
+ * Same as BlendChromaRow_SSE41 on 32 samples. packuswb splits the pairs inside
+ * each lane, vpermq puts the samples back in order.
+ */
+    TARGET_AVX2 static inline __m256i blendChroma_AVX2(__m256i near, __m256i far) {
+        const __m256i kOne = _mm256_set1_epi8(1);
+        const __m256i half = _mm256_sub_epi8(_mm256_avg_epu8(near, far),
+                                             _mm256_and_si256(_mm256_xor_si256(near, far), kOne));
+        return _mm256_avg_epu8(near, half);
+    }
+
+    template<int kChroma>
+    TARGET_AVX2 static inline void
+    loadBlendedChroma_AVX2(const unsigned char *nearU, const unsigned char *nearV,
+                           const unsigned char *farU, const unsigned char *farV, int x,
+                           __m256i *u, __m256i *v) {
+        if (kChroma == ROW_CHROMA_PLANAR) {
+            *u = blendChroma_AVX2(_mm256_loadu_si256((const __m256i *) (nearU + (x >> 1))),
+                                  _mm256_loadu_si256((const __m256i *) (farU + (x >> 1))));
+            *v = blendChroma_AVX2(_mm256_loadu_si256((const __m256i *) (nearV + (x >> 1))),
+                                  _mm256_loadu_si256((const __m256i *) (farV + (x >> 1))));
+        } else {
+            const __m256i kEven = _mm256_set1_epi16(0xff);
+            const unsigned char *near = kChroma == ROW_CHROMA_NV12 ? nearU : nearV;
+            const unsigned char *far = kChroma == ROW_CHROMA_NV12 ? farU : farV;
+            const __m256i c0 = blendChroma_AVX2(
+                    _mm256_loadu_si256((const __m256i *) (near + x)),
+                    _mm256_loadu_si256((const __m256i *) (far + x)));
+            const __m256i c1 = blendChroma_AVX2(
+                    _mm256_loadu_si256((const __m256i *) (near + x + 32)),
+                    _mm256_loadu_si256((const __m256i *) (far + x + 32)));
+            __m256i even = _mm256_packus_epi16(_mm256_and_si256(c0, kEven),
+                                               _mm256_and_si256(c1, kEven));
+            __m256i odd = _mm256_packus_epi16(_mm256_srli_epi16(c0, 8),
+                                              _mm256_srli_epi16(c1, 8));
+            even = _mm256_permute4x64_epi64(even, 0xd8);
+            odd = _mm256_permute4x64_epi64(odd, 0xd8);
+            *u = kChroma == ROW_CHROMA_NV12 ? even : odd;
+            *v = kChroma == ROW_CHROMA_NV12 ? odd : even;
+        }
+    }
+
+    template<int kChroma>
+    TARGET_AVX2 static void
+    BlendChromaRow_AVX2(const unsigned char *nearU, const unsigned char *nearV,
+                        const unsigned char *farU, const unsigned char *farV,
+                        unsigned char *dstU, unsigned char *dstV, int width) {
+        for (int x = 0; x < width; x += AVX2_BLEND_STEP) {
+            __m256i u;
+            __m256i v;
+            loadBlendedChroma_AVX2<kChroma>(nearU, nearV, farU, farV, x, &u, &v);
+            _mm256_storeu_si256((__m256i *) (dstU + (x >> 1)), u);
+            _mm256_storeu_si256((__m256i *) (dstV + (x >> 1)), v);
+        }
+    }
+
+/*
+ * movntdq needs 16-byte aligned stores, the head and the tail are copied
+ * with memcpy. sfence orders the streamed stores before the stores of the
+ * caller, e.g. the release of the worker that converted the row.
+ */
+    TARGET_SSE41 static void StreamRow_SSE41(const unsigned char *src, unsigned char *dst,
+                                             int bytes) {
+        int x = static_cast<int>(-reinterpret_cast<uintptr_t>(dst) & 15);
+        x = x < bytes ? x : bytes;
+        memcpy(dst, src, x);
+        for (; x + 64 <= bytes; x += 64) {
+            const __m128i *pSrc = (const __m128i *) (src + x);
+            __m128i *pDst = (__m128i *) (dst + x);
+            _mm_stream_si128(pDst, _mm_loadu_si128(pSrc));
+            _mm_stream_si128(pDst + 1, _mm_loadu_si128(pSrc + 1));
+            _mm_stream_si128(pDst + 2, _mm_loadu_si128(pSrc + 2));
+            _mm_stream_si128(pDst + 3, _mm_loadu_si128(pSrc + 3));
+        }
+        memcpy(dst + x, src + x, bytes - x);
+        _mm_sfence();
+    }
+
+/*
+ * 4 pixels per register. RGB565 and gray are computed in the 32-bit lanes of
+ * the pixels and narrowed with packusdw, RGB24 drops the alpha bytes with
+ * pshufb and joins the 12 byte groups with byte shifts. The dither row
+ * repeats every 4 pixels, so it is one register of saturating adds.
+ */
+    template<int kPack>
+    TARGET_SSE41 static void PackRow_SSE41(const unsigned char *src, unsigned char *dst, int width,
+                                           int y) {
+        const unsigned char *d = ROW_DITHER_4X4[y & 3];
+        const __m128i kDither = kPack == ROW_PACK_RGB565_DITHER
+                                ? _mm_setr_epi8(d[0] >> 1, d[0] >> 2, d[0] >> 1, 0,
+                                                d[1] >> 1, d[1] >> 2, d[1] >> 1, 0,
+                                                d[2] >> 1, d[2] >> 2, d[2] >> 1, 0,
+                                                d[3] >> 1, d[3] >> 2, d[3] >> 1, 0)
+                                : _mm_setzero_si128();
+        const __m128i kRGB = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                           -1, -1, -1, -1);
+        const __m128i kWeights = _mm_setr_epi16(77, 150, 29, 0, 77, 150, 29, 0);
+        const __m128i k128 = _mm_set1_epi32(128);
+        const __m128i kR = _mm_set1_epi32(0xf800);
+        const __m128i kG = _mm_set1_epi32(0x07e0);
+        const __m128i kB = _mm_set1_epi32(0x001f);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_PACK_STEP) {
+            const __m128i *pSrc = (const __m128i *) (src + x * 4);
+            __m128i p[4];
+            for (int i = 0; i < 4; i++) {
+                p[i] = _mm_loadu_si128(pSrc + i);
+            }
+            if (kPack == ROW_PACK_RGB24) {
+                for (int i = 0; i < 4; i++) {
+                    p[i] = _mm_shuffle_epi8(p[i], kRGB);
+                }
+                __m128i *pDst = (__m128i *) (dst + x * 3);
+                _mm_storeu_si128(pDst, _mm_or_si128(p[0], _mm_slli_si128(p[1], 12)));
+                _mm_storeu_si128(pDst + 1, _mm_or_si128(_mm_srli_si128(p[1], 4),
+                                                        _mm_slli_si128(p[2], 8)));
+                _mm_storeu_si128(pDst + 2, _mm_or_si128(_mm_srli_si128(p[2], 8),
+                                                        _mm_slli_si128(p[3], 4)));
+            } else if (kPack == ROW_PACK_GRAY) {
+                for (int i = 0; i < 4; i++) {
+                    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(p[i], zero), kWeights);
+                    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(p[i], zero), kWeights);
+                    p[i] = _mm_srli_epi32(_mm_add_epi32(_mm_hadd_epi32(lo, hi), k128), 8);
+                }
+                _mm_storeu_si128((__m128i *) (dst + x),
+                                 _mm_packus_epi16(_mm_packus_epi32(p[0], p[1]),
+                                                  _mm_packus_epi32(p[2], p[3])));
+            } else {
+                for (int i = 0; i < 4; i++) {
+                    const __m128i c = _mm_adds_epu8(p[i], kDither);
+                    p[i] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi32(c, 8), kR),
+                                                     _mm_and_si128(_mm_srli_epi32(c, 5), kG)),
+                                        _mm_and_si128(_mm_srli_epi32(c, 19), kB));
+                }
+                __m128i *pDst = (__m128i *) (dst + x * 2);
+                _mm_storeu_si128(pDst, _mm_packus_epi32(p[0], p[1]));
+                _mm_storeu_si128(pDst + 1, _mm_packus_epi32(p[2], p[3]));
+            }
+        }
+    }
+
+/*
+ * The expansion is (42 * y) >> 8 from pmulhuw of y << 8, added to y with
+ * saturation, see LumaRow_NEON. The RGBA pixels are interleaved with two
+ * rounds of unpacks, gray with gray and gray with alpha.
+ */
+    template<int kLuma>
+    TARGET_SSE41 static void LumaRow_SSE41(const unsigned char *srcY, unsigned char *dst,
+                                           int width) {
+        const __m128i k16 = _mm_set1_epi8(16);
+        const __m128i k42 = _mm_set1_epi16(42);
+        const __m128i kAlpha = _mm_set1_epi8(-1);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_LUMA_STEP) {
+            __m128i y = _mm_loadu_si128((const __m128i *) (srcY + x));
+            if (kLuma & ROW_LUMA_EXPAND) {
+                y = _mm_subs_epu8(y, k16);
+                const __m128i lo = _mm_mulhi_epu16(_mm_unpacklo_epi8(zero, y), k42);
+                const __m128i hi = _mm_mulhi_epu16(_mm_unpackhi_epi8(zero, y), k42);
+                y = _mm_adds_epu8(y, _mm_packus_epi16(lo, hi));
+            }
+            if (kLuma & ROW_LUMA_RGBA) {
+                const __m128i ggLo = _mm_unpacklo_epi8(y, y);
+                const __m128i ggHi = _mm_unpackhi_epi8(y, y);
+                __m128i *pDst = (__m128i *) (dst + x * 4);
+                if (kLuma & ROW_LUMA_ALPHA_FIRST) {
+                    const __m128i agLo = _mm_unpacklo_epi8(kAlpha, y);
+                    const __m128i agHi = _mm_unpackhi_epi8(kAlpha, y);
+                    _mm_storeu_si128(pDst, _mm_unpacklo_epi16(agLo, ggLo));
+                    _mm_storeu_si128(pDst + 1, _mm_unpackhi_epi16(agLo, ggLo));
+                    _mm_storeu_si128(pDst + 2, _mm_unpacklo_epi16(agHi, ggHi));
+                    _mm_storeu_si128(pDst + 3, _mm_unpackhi_epi16(agHi, ggHi));
+                } else {
+                    const __m128i gaLo = _mm_unpacklo_epi8(y, kAlpha);
+                    const __m128i gaHi = _mm_unpackhi_epi8(y, kAlpha);
+                    _mm_storeu_si128(pDst, _mm_unpacklo_epi16(ggLo, gaLo));
+                    _mm_storeu_si128(pDst + 1, _mm_unpackhi_epi16(ggLo, gaLo));
+                    _mm_storeu_si128(pDst + 2, _mm_unpacklo_epi16(ggHi, gaHi));
+                    _mm_storeu_si128(pDst + 3, _mm_unpackhi_epi16(ggHi, gaHi));
+                }
+            } else {
+                _mm_storeu_si128((__m128i *) (dst + x), y);
+            }
+        }
+    }
+
+/*
+ * 8 macropixels per loop. The y bytes are the even or odd bytes of the row,
+ * taken with a mask or a shift and narrowed with packuswb, and the chroma
+ * pairs are split the same way once more.
+ */
+    template<int kPacked>
+    TARGET_SSE41 static void SplitPackedRow_SSE41(const unsigned char *src, unsigned char *dstY,
+                                                  unsigned char *dstU, unsigned char *dstV,
+                                                  int width) {
+        const __m128i kLow = _mm_set1_epi16(0x00ff);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_SPLIT_STEP) {
+            const __m128i a = _mm_loadu_si128((const __m128i *) (src + x * 2));
+            const __m128i b = _mm_loadu_si128((const __m128i *) (src + x * 2 + 16));
+            const __m128i even = _mm_packus_epi16(_mm_and_si128(a, kLow), _mm_and_si128(b, kLow));
+            const __m128i odd = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+            const __m128i luma = kPacked == ROW_PACKED_YUY2 ? even : odd;
+            const __m128i chroma = kPacked == ROW_PACKED_YUY2 ? odd : even;
+            _mm_storeu_si128((__m128i *) (dstY + x), luma);
+            _mm_storel_epi64((__m128i *) (dstU + (x >> 1)),
+                             _mm_packus_epi16(_mm_and_si128(chroma, kLow), zero));
+            _mm_storel_epi64((__m128i *) (dstV + (x >> 1)),
+                             _mm_packus_epi16(_mm_srli_epi16(chroma, 8), zero));
+        }
+    }
+
+/*
+ * RGBA to YUV, 16 pixels per loop. pshufb gathers the channels of each group
+ * of 4 pixels and two rounds of unpacks join them into one register per
+ * channel. The weighted sums wrap in 16-bit lanes, see RGBToYUVCoefficients.
+ * The 2x2 sums of the chroma rows are pmaddubsw of each row with ones.
+ */
+    template<int kInput>
+    TARGET_SSE41 static inline void
+    loadChannels_SSE41(const unsigned char *src, __m128i *r, __m128i *g, __m128i *b) {
+        typedef RowOutputOrder<kInput> Order;
+        const __m128i kGather = _mm_setr_epi8(
+                Order::kR, Order::kR + 4, Order::kR + 8, Order::kR + 12,
+                Order::kG, Order::kG + 4, Order::kG + 8, Order::kG + 12,
+                Order::kB, Order::kB + 4, Order::kB + 8, Order::kB + 12,
+                Order::kA, Order::kA + 4, Order::kA + 8, Order::kA + 12);
+        __m128i p[4];
+        for (int i = 0; i < 4; i++) {
+            p[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (src + i * 16)), kGather);
+        }
+        const __m128i rg0 = _mm_unpacklo_epi32(p[0], p[1]);
+        const __m128i ba0 = _mm_unpackhi_epi32(p[0], p[1]);
+        const __m128i rg1 = _mm_unpacklo_epi32(p[2], p[3]);
+        const __m128i ba1 = _mm_unpackhi_epi32(p[2], p[3]);
+        *r = _mm_unpacklo_epi64(rg0, rg1);
+        *g = _mm_unpackhi_epi64(rg0, rg1);
+        *b = _mm_unpacklo_epi64(ba0, ba1);
+    }
+
+    TARGET_SSE41 static inline __m128i
+    weigh_SSE41(__m128i r, __m128i g, __m128i b, int kR, int kG, int kB, int offset) {
+        const __m128i sum = _mm_add_epi16(
+                _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(kR)),
+                              _mm_mullo_epi16(g, _mm_set1_epi16(kG))),
+                _mm_add_epi16(_mm_mullo_epi16(b, _mm_set1_epi16(kB)), _mm_set1_epi16(offset)));
+        return _mm_srli_epi16(sum, 8);
+    }
+
+    template<int kInput, class Coefficients>
+    TARGET_SSE41 static void RGBAToYRow_SSE41(const unsigned char *src, unsigned char *dstY,
+                                              int width) {
+        typedef Coefficients C;
+        const int offset = (C::kYOffset << 8) + 128;
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_RGBA_TO_YUV_STEP) {
+            __m128i r, g, b;
+            loadChannels_SSE41<kInput>(src + x * 4, &r, &g, &b);
+            const __m128i lo = weigh_SSE41(_mm_cvtepu8_epi16(r), _mm_cvtepu8_epi16(g),
+                                           _mm_cvtepu8_epi16(b), C::kYR, C::kYG, C::kYB, offset);
+            const __m128i hi = weigh_SSE41(_mm_unpackhi_epi8(r, zero), _mm_unpackhi_epi8(g, zero),
+                                           _mm_unpackhi_epi8(b, zero), C::kYR, C::kYG, C::kYB,
+                                           offset);
+            _mm_storeu_si128((__m128i *) (dstY + x), _mm_packus_epi16(lo, hi));
+        }
+    }
+
+    //(a + b + c + d + 2) >> 2 of the 2x2 blocks of 16 pixels of two rows
+    TARGET_SSE41 static inline __m128i average2x2_SSE41(__m128i row0, __m128i row1) {
+        const __m128i ones = _mm_set1_epi8(1);
+        const __m128i sum = _mm_add_epi16(_mm_maddubs_epi16(row0, ones),
+                                          _mm_maddubs_epi16(row1, ones));
+        return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+    }
+
+    template<int kChroma, int kInput, class Coefficients>
+    TARGET_SSE41 static void
+    RGBAToUVRow_SSE41(const unsigned char *src0, const unsigned char *src1, unsigned char *dstU,
+                      unsigned char *dstV, int width) {
+        typedef Coefficients C;
+        const __m128i kInterleave = kChroma == ROW_CHROMA_NV21
+                                    ? _mm_setr_epi8(8, 0, 9, 1, 10, 2, 11, 3,
+                                                    12, 4, 13, 5, 14, 6, 15, 7)
+                                    : _mm_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11,
+                                                    4, 12, 5, 13, 6, 14, 7, 15);
+        for (int x = 0; x < width; x += SSE41_RGBA_TO_YUV_STEP) {
+            __m128i r0, g0, b0, r1, g1, b1;
+            loadChannels_SSE41<kInput>(src0 + x * 4, &r0, &g0, &b0);
+            loadChannels_SSE41<kInput>(src1 + x * 4, &r1, &g1, &b1);
+            const __m128i r = average2x2_SSE41(r0, r1);
+            const __m128i g = average2x2_SSE41(g0, g1);
+            const __m128i b = average2x2_SSE41(b0, b1);
+            const __m128i u = weigh_SSE41(r, g, b, C::kUR, C::kUG, C::kUB, RGB_TO_UV_OFFSET);
+            const __m128i v = weigh_SSE41(r, g, b, C::kVR, C::kVG, C::kVB, RGB_TO_UV_OFFSET);
+            const __m128i uv = _mm_packus_epi16(u, v);
+            if (kChroma == ROW_CHROMA_PLANAR) {
+                _mm_storel_epi64((__m128i *) (dstU + (x >> 1)), uv);
+                _mm_storel_epi64((__m128i *) (dstV + (x >> 1)), _mm_unpackhi_epi64(uv, uv));
+            } else {
+                unsigned char *dst = kChroma == ROW_CHROMA_NV12 ? dstU : dstV;
+                _mm_storeu_si128((__m128i *) (dst + x), _mm_shuffle_epi8(uv, kInterleave));
+            }
+        }
+    }
+
+/*
+ * 10-bit rows, 8 pixels per loop with the TransformTerms_SSE41 of the
+ * transform scaled to 10 bits. The 4:2:0 chroma samples are duplicated before
+ * the terms, pshufb splits and duplicates the interleaved pairs. The odd
+ * pixels of ROW_CHROMA_BILINEAR get pavgw before the msb shift, as in C.
+ */
+    template<int kChroma, bool kMsb>
+    TARGET_SSE41 static inline void
+    loadChroma16_SSE41(const uint16_t *srcU, const uint16_t *srcV, int x, __m128i *u,
+                       __m128i *v) {
+        if (kChroma == ROW_CHROMA_444) {
+            *u = _mm_loadu_si128((const __m128i *) (srcU + x));
+            *v = _mm_loadu_si128((const __m128i *) (srcV + x));
+        } else if (kChroma == ROW_CHROMA_NV12) {
+            const __m128i uv = _mm_loadu_si128((const __m128i *) (srcU + x));
+            *u = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5,
+                                                    8, 9, 8, 9, 12, 13, 12, 13));
+            *v = _mm_shuffle_epi8(uv, _mm_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7,
+                                                    10, 11, 10, 11, 14, 15, 14, 15));
+        } else {
+            const __m128i u4 = _mm_loadl_epi64((const __m128i *) (srcU + (x >> 1)));
+            const __m128i v4 = _mm_loadl_epi64((const __m128i *) (srcV + (x >> 1)));
+            __m128i oddU = u4;
+            __m128i oddV = v4;
+            if (kChroma == ROW_CHROMA_BILINEAR) {
+                oddU = _mm_avg_epu16(u4, _mm_loadl_epi64((const __m128i *) (srcU + (x >> 1) + 1)));
+                oddV = _mm_avg_epu16(v4, _mm_loadl_epi64((const __m128i *) (srcV + (x >> 1) + 1)));
+            }
+            *u = _mm_unpacklo_epi16(u4, oddU);
+            *v = _mm_unpacklo_epi16(v4, oddV);
+        }
+        if (kMsb) {
+            *u = _mm_srli_epi16(*u, 6);
+            *v = _mm_srli_epi16(*v, 6);
+        }
+    }
+
+    template<int kChroma, bool kMsb>
+    TARGET_SSE41 static void
+    YUV420ToRGBA16Row_SSE41(const uint16_t *srcY, const uint16_t *srcU, const uint16_t *srcV,
+                            uint16_t *dst, int width, const ColorTransform *transform) {
+        ColorTransform scaled = *transform;
+        scaled.yOffset *= 4;
+        for (int c = 0; c < 3; c++) {
+            scaled.offset[c] *= 4;
+        }
+        const TransformTerms_SSE41 terms(scaled);
+        const __m128i kYOffset = _mm_set1_epi16(static_cast<int16_t>(terms.yOffset()));
+        const __m128i k512 = _mm_set1_epi16(512);
+        const __m128i kMax = _mm_set1_epi16(1023);
+        const __m128i zero = _mm_setzero_si128();
+        for (int x = 0; x < width; x += SSE41_ROW16_STEP) {
+            __m128i y = _mm_loadu_si128((const __m128i *) (srcY + x));
+            if (kMsb) {
+                y = _mm_srli_epi16(y, 6);
+            }
+            y = _mm_subs_epu16(y, kYOffset);
+            __m128i u;
+            __m128i v;
+            loadChroma16_SSE41<kChroma, kMsb>(srcU, srcV, x, &u, &v);
+            u = _mm_sub_epi16(u, k512);
+            v = _mm_sub_epi16(v, k512);
+            __m128i c[3];
+            for (int i = 0; i < 3; i++) {
+                c[i] = narrow_SSE41(terms.channel(i, y, u, v, false),
+                                    terms.channel(i, y, u, v, true));
+                c[i] = _mm_min_epi16(_mm_max_epi16(c[i], zero), kMax);
+            }
+            const __m128i rgLo = _mm_unpacklo_epi16(c[0], c[1]);
+            const __m128i rgHi = _mm_unpackhi_epi16(c[0], c[1]);
+            const __m128i baLo = _mm_unpacklo_epi16(c[2], kMax);
+            const __m128i baHi = _mm_unpackhi_epi16(c[2], kMax);
+            __m128i *pDst = (__m128i *) (dst + x * 4);
+            _mm_storeu_si128(pDst, _mm_unpacklo_epi32(rgLo, baLo));
+            _mm_storeu_si128(pDst + 1, _mm_unpackhi_epi32(rgLo, baLo));
+            _mm_storeu_si128(pDst + 2, _mm_unpacklo_epi32(rgHi, baHi));
+            _mm_storeu_si128(pDst + 3, _mm_unpackhi_epi32(rgHi, baHi));
+        }
+    }
+
+/*
+ * 2 pixels per register. The bytes are the channels >> 2 narrowed with
+ * packuswb and permuted with pshufb. RGBA1010102 gets r + (g << 10) and b
+ * from pmaddwd, b is moved up by 20 bits within the 64-bit lane.
+ */
+    template<int kPack>
+    TARGET_SSE41 static void Pack16Row_SSE41(const unsigned char *src, unsigned char *dst,
+                                             int width, int) {
+        typedef RowOutputOrder<kPack - ROW_PACK16_BYTES> Order;
+        char order[16];
+        for (int i = 0; i < 16; i += 4) {
+            order[i + Order::kR] = static_cast<char>(i);
+            order[i + Order::kG] = static_cast<char>(i + 1);
+            order[i + Order::kB] = static_cast<char>(i + 2);
+            order[i + Order::kA] = static_cast<char>(i + 3);
+        }
+        const __m128i kOrder = _mm_loadu_si128((const __m128i *) order);
+        const __m128i kWeights = _mm_setr_epi16(1, 1024, 1, 0, 1, 1024, 1, 0);
+        const __m128i kBlue = _mm_setr_epi32(0, -1, 0, -1);
+        const __m128i kAlpha = _mm_set1_epi32(static_cast<int>(0xc0000000u));
+        for (int x = 0; x < width; x += SSE41_PACK16_STEP) {
+            const __m128i *pSrc = (const __m128i *) (src + x * 8);
+            __m128i p[4];
+            for (int i = 0; i < 4; i++) {
+                p[i] = _mm_loadu_si128(pSrc + i);
+            }
+            __m128i *pDst = (__m128i *) (dst + x * 4);
+            if (kPack == ROW_PACK16_RGBA1010102) {
+                for (int i = 0; i < 4; i++) {
+                    const __m128i t = _mm_madd_epi16(p[i], kWeights);
+                    p[i] = _mm_or_si128(t, _mm_srli_epi64(_mm_and_si128(t, kBlue), 12));
+                    p[i] = _mm_shuffle_epi32(p[i], _MM_SHUFFLE(2, 0, 2, 0));
+                }
+                _mm_storeu_si128(pDst, _mm_or_si128(_mm_unpacklo_epi64(p[0], p[1]), kAlpha));
+                _mm_storeu_si128(pDst + 1, _mm_or_si128(_mm_unpacklo_epi64(p[2], p[3]), kAlpha));
+            } else {
+                for (int i = 0; i < 4; i++) {
+                    p[i] = _mm_srli_epi16(p[i], 2);
+                }
+                _mm_storeu_si128(pDst, _mm_shuffle_epi8(_mm_packus_epi16(p[0], p[1]), kOrder));
+                _mm_storeu_si128(pDst + 1,
+                                 _mm_shuffle_epi8(_mm_packus_epi16(p[2], p[3]), kOrder));
+            }
+        }
+    }
+
+/*
+ * 8 pixels per loop from a 16 byte load. pshufb moves the high bits and the
+ * byte of low bits into the 16-bit lanes, pmullw moves the low bits of each
+ * lane to the same place so one shift and mask extract them.
+ */
+    template<int kRaw>
+    TARGET_SSE41 static void UnpackRawRow_SSE41(const unsigned char *src, uint16_t *dst,
+                                                int width) {
+        const char z = -128;
+        const __m128i kHigh = kRaw == ROW_RAW10
+                              ? _mm_setr_epi8(0, z, 1, z, 2, z, 3, z, 5, z, 6, z, 7, z, 8, z)
+                              : _mm_setr_epi8(0, z, 1, z, 3, z, 4, z, 6, z, 7, z, 9, z, 10, z);
+        const __m128i kLow = kRaw == ROW_RAW10
+                             ? _mm_setr_epi8(4, z, 4, z, 4, z, 4, z, 9, z, 9, z, 9, z, 9, z)
+                             : _mm_setr_epi8(2, z, 2, z, 5, z, 5, z, 8, z, 8, z, 11, z, 11, z);
+        const __m128i kLowScale = kRaw == ROW_RAW10 ? _mm_setr_epi16(64, 16, 4, 1, 64, 16, 4, 1)
+                                                    : _mm_setr_epi16(16, 1, 16, 1, 16, 1, 16, 1);
+        const int lowShift = kRaw == ROW_RAW10 ? 6 : 4;
+        const int highShift = kRaw == ROW_RAW10 ? 2 : 4;
+        const __m128i kLowMask = _mm_set1_epi16(kRaw == ROW_RAW10 ? 3 : 15);
+        const int groupBytes = kRaw == ROW_RAW10 ? 10 : 12;
+        for (int x = 0; x < width; x += SSE41_RAW_STEP) {
+            const __m128i packed = _mm_loadu_si128(
+                    (const __m128i *) (src + x / SSE41_RAW_STEP * groupBytes));
+            const __m128i high = _mm_slli_epi16(_mm_shuffle_epi8(packed, kHigh), highShift);
+            __m128i low = _mm_mullo_epi16(_mm_shuffle_epi8(packed, kLow), kLowScale);
+            low = _mm_and_si128(_mm_srli_epi16(low, lowShift), kLowMask);
+            _mm_storeu_si128((__m128i *) (dst + x), _mm_or_si128(high, low));
+        }
+    }
+
+/*
+ * 8 pixels per half with pavgw, the even and odd columns are computed alike
+ * and blended afterwards. The levels are psubusw and pmulhuw, the halves are
+ * narrowed with packuswb and interleaved by storePixels16_SSE41.
+ */
+    template<int kBayer>
+    TARGET_SSE41 static inline void
+    demosaic8_SSE41(const uint16_t *above, const uint16_t *row, const uint16_t *below,
+                    __m128i black, __m128i scale, __m128i *r, __m128i *g, __m128i *b) {
+        const bool kEvenGreen = kBayer == ROW_BAYER_GR || kBayer == ROW_BAYER_GB;
+        const bool kRedRow = kBayer == ROW_BAYER_RG || kBayer == ROW_BAYER_GR;
+        const __m128i c = _mm_loadu_si128((const __m128i *) row);
+        const __m128i h = _mm_avg_epu16(_mm_loadu_si128((const __m128i *) (row - 1)),
+                                        _mm_loadu_si128((const __m128i *) (row + 1)));
+        const __m128i v = _mm_avg_epu16(_mm_loadu_si128((const __m128i *) above),
+                                        _mm_loadu_si128((const __m128i *) below));
+        const __m128i cross = _mm_avg_epu16(h, v);
+        const __m128i diag = _mm_avg_epu16(
+                _mm_avg_epu16(_mm_loadu_si128((const __m128i *) (above - 1)),
+                              _mm_loadu_si128((const __m128i *) (above + 1))),
+                _mm_avg_epu16(_mm_loadu_si128((const __m128i *) (below - 1)),
+                              _mm_loadu_si128((const __m128i *) (below + 1))));
+        //own is the color of this row, other the color of the rows above and below
+        __m128i own;
+        __m128i green;
+        __m128i other;
+        if (kEvenGreen) {
+            own = _mm_blend_epi16(h, c, 0xaa);
+            green = _mm_blend_epi16(c, cross, 0xaa);
+            other = _mm_blend_epi16(v, diag, 0xaa);
+        } else {
+            own = _mm_blend_epi16(c, h, 0xaa);
+            green = _mm_blend_epi16(cross, c, 0xaa);
+            other = _mm_blend_epi16(diag, v, 0xaa);
+        }
+        const __m128i kMax = _mm_set1_epi16(255);
+        own = _mm_min_epu16(_mm_mulhi_epu16(_mm_subs_epu16(own, black), scale), kMax);
+        green = _mm_min_epu16(_mm_mulhi_epu16(_mm_subs_epu16(green, black), scale), kMax);
+        other = _mm_min_epu16(_mm_mulhi_epu16(_mm_subs_epu16(other, black), scale), kMax);
+        *r = kRedRow ? own : other;
+        *g = green;
+        *b = kRedRow ? other : own;
+    }
+
+    template<int kBayer, int kOutput>
+    TARGET_SSE41 static void
+    DemosaicRow_SSE41(const uint16_t *above, const uint16_t *row, const uint16_t *below,
+                      unsigned char *dst, int width, int black, int scale) {
+        const __m128i kBlack = _mm_set1_epi16(static_cast<int16_t>(black));
+        const __m128i kScale = _mm_set1_epi16(static_cast<int16_t>(scale));
+        const __m128i alpha = _mm_set1_epi8(-1);
+        for (int x = 0; x < width; x += SSE41_DEMOSAIC_STEP) {
+            __m128i r0, g0, b0, r1, g1, b1;
+            demosaic8_SSE41<kBayer>(above + x, row + x, below + x, kBlack, kScale,
+                                    &r0, &g0, &b0);
+            demosaic8_SSE41<kBayer>(above + x + 8, row + x + 8, below + x + 8, kBlack, kScale,
+                                    &r1, &g1, &b1);
+            storePixels16_SSE41<kOutput>(dst + x * 4, _mm_packus_epi16(r0, r1),
+                                         _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1),
+                                         alpha);
+        }
+    }
+
+/*
+ * Interleaving register i with register i + 4 of 8 into registers 2i and
+ * 2i + 1 rotates the bits of the element index by one, 3 rounds turn rows into
+ * columns: 8 rows of 16 bytes end up as 2 destination rows per register, 8
+ * rows of 8 16-bit elements as one. The rounds are written out so that the
+ * registers never go through the stack whether the loops get unrolled or not.
+ */
+    template<int kBytesPerElement>
+    TARGET_SSE41 static inline void interleave_SSE41(__m128i a, __m128i b, __m128i *lo,
+                                                     __m128i *hi) {
+        if (kBytesPerElement == 1) {
+            *lo = _mm_unpacklo_epi8(a, b);
+            *hi = _mm_unpackhi_epi8(a, b);
+        } else {
+            *lo = _mm_unpacklo_epi16(a, b);
+            *hi = _mm_unpackhi_epi16(a, b);
+        }
+    }
+
+    template<int kBytesPerElement>
+    TARGET_SSE41 static inline void transposeRound_SSE41(const __m128i r[8], __m128i next[8]) {
+        interleave_SSE41<kBytesPerElement>(r[0], r[4], &next[0], &next[1]);
+        interleave_SSE41<kBytesPerElement>(r[1], r[5], &next[2], &next[3]);
+        interleave_SSE41<kBytesPerElement>(r[2], r[6], &next[4], &next[5]);
+        interleave_SSE41<kBytesPerElement>(r[3], r[7], &next[6], &next[7]);
+    }
+
+    template<int kBytesPerElement>
+    TARGET_SSE41 static inline void transposeRows8_SSE41(const unsigned char *src, int srcRowStride,
+                                                         __m128i r[8]) {
+        __m128i a[8];
+        __m128i b[8];
+        for (int i = 0; i < 8; i++) {
+            a[i] = _mm_loadu_si128((const __m128i *) (src + i * srcRowStride));
+        }
+        transposeRound_SSE41<kBytesPerElement>(a, b);
+        transposeRound_SSE41<kBytesPerElement>(b, a);
+        transposeRound_SSE41<kBytesPerElement>(a, r);
+    }
+
+    template<int kBytesPerElement>
+    TARGET_SSE41 static void TransposeBlock_SSE41(const unsigned char *src, int srcRowStride,
+                                                  unsigned char *dst, int dstRowStride) {
+        __m128i r[8];
+        if (kBytesPerElement == 2) {
+            transposeRows8_SSE41<2>(src, srcRowStride, r);
+            for (int i = 0; i < 8; i++) {
+                _mm_storeu_si128((__m128i *) (dst + i * dstRowStride), r[i]);
+            }
+            return;
+        }
+        for (int half = 0; half < 2; half++) {
+            transposeRows8_SSE41<1>(src + half * 8 * srcRowStride, srcRowStride, r);
+            unsigned char *pDst = dst + half * 8;
+            for (int i = 0; i < 8; i++) {
+                _mm_storel_epi64((__m128i *) (pDst + i * 2 * dstRowStride), r[i]);
+                _mm_storel_epi64((__m128i *) (pDst + (i * 2 + 1) * dstRowStride),
+                                 _mm_unpackhi_epi64(r[i], r[i]));
+            }
+        }
+    }
+
+    //32-bit elements: pairs of rows interleaved, then pairs of pairs
+    TARGET_SSE41 static inline void transposeRows4_SSE41(__m128i r0, __m128i r1, __m128i r2,
+                                                         __m128i r3, __m128i c[4]) {
+        const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+        const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+        const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+        const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+        c[0] = _mm_unpacklo_epi64(t0, t2);
+        c[1] = _mm_unpackhi_epi64(t0, t2);
+        c[2] = _mm_unpacklo_epi64(t1, t3);
+        c[3] = _mm_unpackhi_epi64(t1, t3);
+    }
+
+    TARGET_SSE41 static void TransposeBlock32_SSE41(const unsigned char *src, int srcRowStride,
+                                                    unsigned char *dst, int dstRowStride) {
+        __m128i c[4];
+        transposeRows4_SSE41(_mm_loadu_si128((const __m128i *) src),
+                             _mm_loadu_si128((const __m128i *) (src + srcRowStride)),
+                             _mm_loadu_si128((const __m128i *) (src + srcRowStride * 2)),
+                             _mm_loadu_si128((const __m128i *) (src + srcRowStride * 3)), c);
+        _mm_storeu_si128((__m128i *) dst, c[0]);
+        _mm_storeu_si128((__m128i *) (dst + dstRowStride), c[1]);
+        _mm_storeu_si128((__m128i *) (dst + dstRowStride * 2), c[2]);
+        _mm_storeu_si128((__m128i *) (dst + dstRowStride * 3), c[3]);
+    }
+
+    //4 RGB24 pixels spread to 32 bits, the 12 bytes are read and written exactly
+    TARGET_SSE41 static inline __m128i loadRGB24_SSE41(const unsigned char *src) {
+        int last;
+        memcpy(&last, src + 8, 4);
+        return _mm_shuffle_epi8(
+                _mm_insert_epi32(_mm_loadl_epi64((const __m128i *) src), last, 2),
+                _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1));
+    }
+
+    TARGET_SSE41 static inline void storeRGB24_SSE41(unsigned char *dst, __m128i pixels) {
+        pixels = _mm_shuffle_epi8(pixels, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,
+                                                        -1, -1, -1, -1));
+        const int last = _mm_extract_epi32(pixels, 2);
+        _mm_storel_epi64((__m128i *) dst, pixels);
+        memcpy(dst + 8, &last, 4);
+    }
+
+    TARGET_SSE41 static void TransposeBlock24_SSE41(const unsigned char *src, int srcRowStride,
+                                                    unsigned char *dst, int dstRowStride) {
+        __m128i c[4];
+        transposeRows4_SSE41(loadRGB24_SSE41(src), loadRGB24_SSE41(src + srcRowStride),
+                             loadRGB24_SSE41(src + srcRowStride * 2),
+                             loadRGB24_SSE41(src + srcRowStride * 3), c);
+        storeRGB24_SSE41(dst, c[0]);
+        storeRGB24_SSE41(dst + dstRowStride, c[1]);
+        storeRGB24_SSE41(dst + dstRowStride * 2, c[2]);
+        storeRGB24_SSE41(dst + dstRowStride * 3, c[3]);
+    }
+
+    TARGET_AVX2 static inline void transposeRows4_AVX2(const unsigned char *src, int srcRowStride,
+                                                       __m256i c[4]) {
+        const __m256i r0 = _mm256_loadu_si256((const __m256i *) src);
+        const __m256i r1 = _mm256_loadu_si256((const __m256i *) (src + srcRowStride));
+        const __m256i r2 = _mm256_loadu_si256((const __m256i *) (src + srcRowStride * 2));
+        const __m256i r3 = _mm256_loadu_si256((const __m256i *) (src + srcRowStride * 3));
+        const __m256i t0 = _mm256_unpacklo_epi32(r0, r1);
+        const __m256i t1 = _mm256_unpackhi_epi32(r0, r1);
+        const __m256i t2 = _mm256_unpacklo_epi32(r2, r3);
+        const __m256i t3 = _mm256_unpackhi_epi32(r2, r3);
+        c[0] = _mm256_unpacklo_epi64(t0, t2);
+        c[1] = _mm256_unpackhi_epi64(t0, t2);
+        c[2] = _mm256_unpacklo_epi64(t1, t3);
+        c[3] = _mm256_unpackhi_epi64(t1, t3);
+    }
+
+    TARGET_AVX2 static inline void storeColumns_AVX2(unsigned char *dst, int dstRowStride,
+                                                     __m256i lo, __m256i hi) {
+        _mm256_storeu_si256((__m256i *) dst, _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *) (dst + dstRowStride * 4),
+                            _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+
+    /*
+     * The unpacks stay within 128-bit lanes, so each half of 4 rows becomes
+     * columns i and i + 4 in the low and high lane of its register i, and the
+     * lanes of the two halves are paired up when storing.
+     */
+    TARGET_AVX2 static void TransposeBlock32_AVX2(const unsigned char *src, int srcRowStride,
+                                                  unsigned char *dst, int dstRowStride) {
+        __m256i lo[4];
+        __m256i hi[4];
+        transposeRows4_AVX2(src, srcRowStride, lo);
+        transposeRows4_AVX2(src + srcRowStride * 4, srcRowStride, hi);
+        storeColumns_AVX2(dst, dstRowStride, lo[0], hi[0]);
+        storeColumns_AVX2(dst + dstRowStride, dstRowStride, lo[1], hi[1]);
+        storeColumns_AVX2(dst + dstRowStride * 2, dstRowStride, lo[2], hi[2]);
+        storeColumns_AVX2(dst + dstRowStride * 3, dstRowStride, lo[3], hi[3]);
+    }
+
+    template<int kChroma, class Coefficients, bool kFast>
+    static inline YUV420ToRGBARowFunc selectRow(int output, int *step) {
+        typedef FastColorCoefficients<Coefficients> FastCoefficients;
+        if (cpuHasAVX2()) {
+            *step = AVX2_ROW_STEP;
+            return withRowOutput(output, [](auto order) -> YUV420ToRGBARowFunc {
+                const int kOutput = decltype(order)::value;
+                return kFast ? YUV420ToRGBAFastRow_AVX2<kChroma, kOutput, FastCoefficients>
+                             : YUV420ToRGBARow_AVX2<kChroma, kOutput, Coefficients>;
+            });
+        } else if (cpuHasSSE41()) {
+            *step = SSE41_ROW_STEP;
+            return withRowOutput(output, [](auto order) -> YUV420ToRGBARowFunc {
+                const int kOutput = decltype(order)::value;
+                return kFast ? YUV420ToRGBAFastRow_SSE41<kChroma, kOutput, FastCoefficients>
+                             : YUV420ToRGBARow_SSE41<kChroma, kOutput, Coefficients>;
+            });
+        }
+        return nullptr;
+    }
+
+    template<class Coefficients, bool kFast>
+    static inline YUV420ToRGBARowFunc selectChromaRow(int chroma, int output, int *step) {
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectRow<ROW_CHROMA_PLANAR, Coefficients, kFast>(output, step);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectRow<ROW_CHROMA_NV12, Coefficients, kFast>(output, step);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectRow<ROW_CHROMA_NV21, Coefficients, kFast>(output, step);
+        } else if (chroma == ROW_CHROMA_444) {
+            return selectRow<ROW_CHROMA_444, Coefficients, kFast>(output, step);
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return selectRow<ROW_CHROMA_BILINEAR, Coefficients, kFast>(output, step);
+        }
+        return nullptr;
+    }
+
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBARow(int chroma, int output, int matrix, int range, int *step) {
+        return withColorCoefficients(matrix, range, [chroma, output, step](auto coefficients) {
+            return selectChromaRow<decltype(coefficients), false>(chroma, output, step);
+        });
+    }
+
+    YUV420ToRGBARowFunc
+    selectYUV420ToRGBAFastRow(int chroma, int output, int matrix, int range, int *step) {
+        return withColorCoefficients(matrix, range, [chroma, output, step](auto coefficients) {
+            return selectChromaRow<decltype(coefficients), true>(chroma, output, step);
+        });
+    }
+
+    template<int kChroma>
+    static inline YUV420ToRGBATransformRowFunc selectTransformRow(int output, int *step) {
+        if (cpuHasAVX2()) {
+            *step = AVX2_ROW_STEP;
+            return withRowOutput(output, [](auto order) -> YUV420ToRGBATransformRowFunc {
+                return YUV420ToRGBATransformRow_AVX2<kChroma, decltype(order)::value>;
+            });
+        } else if (cpuHasSSE41()) {
+            *step = SSE41_ROW_STEP;
+            return withRowOutput(output, [](auto order) -> YUV420ToRGBATransformRowFunc {
+                return YUV420ToRGBATransformRow_SSE41<kChroma, decltype(order)::value>;
+            });
+        }
+        return nullptr;
+    }
+
+    YUV420ToRGBATransformRowFunc selectYUV420ToRGBATransformRow(int chroma, int output, int *step) {
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectTransformRow<ROW_CHROMA_PLANAR>(output, step);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectTransformRow<ROW_CHROMA_NV12>(output, step);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectTransformRow<ROW_CHROMA_NV21>(output, step);
+        } else if (chroma == ROW_CHROMA_444) {
+            return selectTransformRow<ROW_CHROMA_444>(output, step);
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return selectTransformRow<ROW_CHROMA_BILINEAR>(output, step);
+        }
+        return nullptr;
+    }
+
+    template<int kChroma>
+    static inline BlendChromaRowFunc selectBlendRow(int *step) {
+        if (cpuHasAVX2()) {
+            *step = AVX2_BLEND_STEP;
+            return BlendChromaRow_AVX2<kChroma>;
+        } else if (cpuHasSSE41()) {
+            *step = SSE41_BLEND_STEP;
+            return BlendChromaRow_SSE41<kChroma>;
+        }
+        return nullptr;
+    }
+
+    BlendChromaRowFunc selectBlendChromaRow(int chroma, int *step) {
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectBlendRow<ROW_CHROMA_PLANAR>(step);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectBlendRow<ROW_CHROMA_NV12>(step);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectBlendRow<ROW_CHROMA_NV21>(step);
+        }
+        return nullptr;
+    }
+
+    SplitPackedRowFunc selectSplitPackedRow(int packed, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_SPLIT_STEP;
+        if (packed == ROW_PACKED_YUY2) {
+            return SplitPackedRow_SSE41<ROW_PACKED_YUY2>;
+        } else if (packed == ROW_PACKED_UYVY) {
+            return SplitPackedRow_SSE41<ROW_PACKED_UYVY>;
+        }
+        return nullptr;
+    }
+
+    YUV420ToRGBA16RowFunc selectYUV420ToRGBA16Row(int chroma, bool msb, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_ROW16_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return msb ? YUV420ToRGBA16Row_SSE41<ROW_CHROMA_PLANAR, true>
+                       : YUV420ToRGBA16Row_SSE41<ROW_CHROMA_PLANAR, false>;
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return msb ? YUV420ToRGBA16Row_SSE41<ROW_CHROMA_NV12, true>
+                       : YUV420ToRGBA16Row_SSE41<ROW_CHROMA_NV12, false>;
+        } else if (chroma == ROW_CHROMA_444) {
+            return msb ? YUV420ToRGBA16Row_SSE41<ROW_CHROMA_444, true>
+                       : YUV420ToRGBA16Row_SSE41<ROW_CHROMA_444, false>;
+        } else if (chroma == ROW_CHROMA_BILINEAR) {
+            return msb ? YUV420ToRGBA16Row_SSE41<ROW_CHROMA_BILINEAR, true>
+                       : YUV420ToRGBA16Row_SSE41<ROW_CHROMA_BILINEAR, false>;
+        }
+        return nullptr;
+    }
+
+    StreamRowFunc selectStreamRow() {
+        return cpuHasSSE41() ? StreamRow_SSE41 : nullptr;
+    }
+
+    PackRowFunc selectPackRow(int pack, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_PACK_STEP;
+        if (pack == ROW_PACK_RGB565) {
+            return PackRow_SSE41<ROW_PACK_RGB565>;
+        } else if (pack == ROW_PACK_RGB565_DITHER) {
+            return PackRow_SSE41<ROW_PACK_RGB565_DITHER>;
+        } else if (pack == ROW_PACK_RGB24) {
+            return PackRow_SSE41<ROW_PACK_RGB24>;
+        } else if (pack == ROW_PACK_GRAY) {
+            return PackRow_SSE41<ROW_PACK_GRAY>;
+        }
+        return nullptr;
+    }
+
+    PackRowFunc selectPack16Row(int pack, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_PACK16_STEP;
+        if (pack == ROW_PACK16_RGBA1010102) {
+            return Pack16Row_SSE41<ROW_PACK16_RGBA1010102>;
+        }
+        return withRowOutput(pack - ROW_PACK16_BYTES, [](auto order) -> PackRowFunc {
+            return Pack16Row_SSE41<ROW_PACK16_BYTES + decltype(order)::value>;
+        });
+    }
+
+    LumaRowFunc selectLumaRow(int luma, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_LUMA_STEP;
+        if (luma == ROW_LUMA_EXPAND) {
+            return LumaRow_SSE41<ROW_LUMA_EXPAND>;
+        } else if (luma == ROW_LUMA_RGBA) {
+            return LumaRow_SSE41<ROW_LUMA_RGBA>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_EXPAND)) {
+            return LumaRow_SSE41<ROW_LUMA_RGBA | ROW_LUMA_EXPAND>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST)) {
+            return LumaRow_SSE41<ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST>;
+        } else if (luma == (ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST | ROW_LUMA_EXPAND)) {
+            return LumaRow_SSE41<ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST | ROW_LUMA_EXPAND>;
+        }
+        return nullptr;
+    }
+
+    RGBAToYRowFunc selectRGBAToYRow(int input, int matrix, int range, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_RGBA_TO_YUV_STEP;
+        return withColorCoefficients(matrix, range, [input](auto coefficients) {
+            typedef decltype(coefficients) C;
+            typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+            return withRowOutput(input, [](auto order) -> RGBAToYRowFunc {
+                return RGBAToYRow_SSE41<decltype(order)::value, Coefficients>;
+            });
+        });
+    }
+
+    template<int kChroma>
+    static inline RGBAToUVRowFunc selectUVRow(int input, int matrix, int range) {
+        return withColorCoefficients(matrix, range, [input](auto coefficients) {
+            typedef decltype(coefficients) C;
+            typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+            return withRowOutput(input, [](auto order) -> RGBAToUVRowFunc {
+                return RGBAToUVRow_SSE41<kChroma, decltype(order)::value, Coefficients>;
+            });
+        });
+    }
+
+    RGBAToUVRowFunc selectRGBAToUVRow(int chroma, int input, int matrix, int range, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_RGBA_TO_YUV_STEP;
+        if (chroma == ROW_CHROMA_PLANAR) {
+            return selectUVRow<ROW_CHROMA_PLANAR>(input, matrix, range);
+        } else if (chroma == ROW_CHROMA_NV12) {
+            return selectUVRow<ROW_CHROMA_NV12>(input, matrix, range);
+        } else if (chroma == ROW_CHROMA_NV21) {
+            return selectUVRow<ROW_CHROMA_NV21>(input, matrix, range);
+        }
+        return nullptr;
+    }
+
+    UnpackRawRowFunc selectUnpackRawRow(int raw, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_RAW_STEP;
+        if (raw == ROW_RAW10) {
+            return UnpackRawRow_SSE41<ROW_RAW10>;
+        } else if (raw == ROW_RAW12) {
+            return UnpackRawRow_SSE41<ROW_RAW12>;
+        }
+        return nullptr;
+    }
+
+    template<int kBayer>
+    static inline DemosaicRowFunc selectBayerRow(int output) {
+        return withRowOutput(output, [](auto order) -> DemosaicRowFunc {
+            return DemosaicRow_SSE41<kBayer, decltype(order)::value>;
+        });
+    }
+
+    DemosaicRowFunc selectDemosaicRow(int bayer, int output, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        *step = SSE41_DEMOSAIC_STEP;
+        if (bayer == ROW_BAYER_RG) {
+            return selectBayerRow<ROW_BAYER_RG>(output);
+        } else if (bayer == ROW_BAYER_GR) {
+            return selectBayerRow<ROW_BAYER_GR>(output);
+        } else if (bayer == ROW_BAYER_GB) {
+            return selectBayerRow<ROW_BAYER_GB>(output);
+        } else if (bayer == ROW_BAYER_BG) {
+            return selectBayerRow<ROW_BAYER_BG>(output);
+        }
+        return nullptr;
+    }
+
+    TransposeBlockFunc selectTransposeBlock(int bytesPerElement, int *step) {
+        if (!cpuHasSSE41()) {
+            return nullptr;
+        }
+        if (bytesPerElement == 1) {
+            *step = 16;
+            return TransposeBlock_SSE41<1>;
+        }
+        if (bytesPerElement == 2) {
+            *step = 8;
+            return TransposeBlock_SSE41<2>;
+        }
+        if (bytesPerElement == 3) {
+            *step = 4;
+            return TransposeBlock24_SSE41;
+        }
+        if (bytesPerElement == 4) {
+            if (cpuHasAVX2()) {
+                *step = 8;
+                return TransposeBlock32_AVX2;
+            }
+            *step = 4;
+            return TransposeBlock32_SSE41;
+        }
+        return nullptr;
+    }
+}
+
+#endif //HAS_X86_ROW
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sched.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "native_thread_pool.h"
+
+namespace native_utils {
+
+    //spinning time before a worker parks, or the caller yields while waiting for the workers
+    const std::chrono::microseconds WORKER_SPIN_TIME(50);
+    //cpuRelax calls between clock reads, pause alone takes 100+ cycles on recent x86
+    const int WORKER_SPIN_CHECK = 64;
+
+    static inline void cpuRelax() {
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    //spins until done() or for WORKER_SPIN_TIME, returns whether done() became true
+    template<class Done>
+    static inline bool spinUntil(const Done &done) {
+        const auto deadline = std::chrono::steady_clock::now() + WORKER_SPIN_TIME;
+        for (;;) {
+            for (int i = 0; i < WORKER_SPIN_CHECK; i++) {
+                if (done()) {
+                    return true;
+                }
+                cpuRelax();
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return done();
+            }
+        }
+    }
+
+    static void pinToCpu(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        //fails for offline cpus, the worker then just stays unpinned
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+
+    int getCpuCount() {
+        const long count = sysconf(_SC_NPROCESSORS_CONF);
+        return count > 0 ? static_cast<int>(count) : 1;
+    }
+
+/*
+ * Every job is published by bumping mGeneration. All workers take part in
+ * every job, pull indices from mNext and decrement mRemaining when done, so
+ * the job fields are never written while a worker may still read them.
+ */
+    class WorkerPool {
+    public:
+        WorkerPool() : mGeneration(0), mNext(0), mRemaining(0), mStop(false), mParked(0),
+                       mTask(nullptr), mContext(nullptr), mCount(0) {
+        }
+
+        void run(int threads, int count, ParallelTask task, void *context) {
+            std::unique_lock<std::mutex> lock(mRunMutex, std::try_to_lock);
+            if (!lock.owns_lock() || threads <= 1 || count <= 1) {
+                for (int i = 0; i < count; i++) {
+                    task(context, i);
+                }
+                return;
+            }
+            resize(threads - 1);
+            mTask = task;
+            mContext = context;
+            mCount = count;
+            mNext.store(0, std::memory_order_relaxed);
+            mRemaining.store(static_cast<int>(mWorkers.size()), std::memory_order_relaxed);
+            publish();
+            work();
+            const auto finished = [this] {
+                return mRemaining.load(std::memory_order_acquire) <= 0;
+            };
+            if (!spinUntil(finished)) {
+                while (!finished()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    private:
+        void publish() {
+            mGeneration.fetch_add(1, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(mParkMutex);
+            if (mParked > 0) {
+                mWake.notify_all();
+            }
+        }
+
+        void work() {
+            for (int i = mNext.fetch_add(1, std::memory_order_relaxed); i < mCount;
+                 i = mNext.fetch_add(1, std::memory_order_relaxed)) {
+                mTask(mContext, i);
+            }
+        }
+
+        unsigned int waitForJob(unsigned int seen) {
+            unsigned int generation = seen;
+            if (spinUntil([this, seen, &generation] {
+                generation = mGeneration.load(std::memory_order_acquire);
+                return generation != seen;
+            })) {
+                return generation;
+            }
+            std::unique_lock<std::mutex> lock(mParkMutex);
+            mParked++;
+            mWake.wait(lock, [this, seen] {
+                return mGeneration.load(std::memory_order_acquire) != seen;
+            });
+            mParked--;
+            return mGeneration.load(std::memory_order_acquire);
+        }
+
+        void workerLoop(int cpu, unsigned int seen) {
+            pinToCpu(cpu);
+            for (;;) {
+                seen = waitForJob(seen);
+                if (mStop.load(std::memory_order_relaxed)) {
+                    return;
+                }
+                work();
+                mRemaining.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        /*
+         * Workers are pinned from the last cpu down, the big cores on most
+         * big.LITTLE socs, the calling thread is left to the scheduler.
+         */
+        void resize(int workers) {
+            if (static_cast<int>(mWorkers.size()) == workers) {
+                return;
+            }
+            if (!mWorkers.empty()) {
+                mStop.store(true, std::memory_order_relaxed);
+                publish();
+                for (std::thread &worker : mWorkers) {
+                    worker.join();
+                }
+                mWorkers.clear();
+                mStop.store(false, std::memory_order_relaxed);
+            }
+            const int cpuCount = getCpuCount();
+            const unsigned int generation = mGeneration.load(std::memory_order_relaxed);
+            for (int i = 0; i < workers; i++) {
+                const int cpu = cpuCount - 1 - i % cpuCount;
+                mWorkers.emplace_back(&WorkerPool::workerLoop, this, cpu, generation);
+            }
+        }
+
+        std::mutex mRunMutex;
+        std::vector<std::thread> mWorkers;
+        std::atomic<unsigned int> mGeneration;
+        std::atomic<int> mNext;
+        std::atomic<int> mRemaining;
+        std::atomic<bool> mStop;
+
+        std::mutex mParkMutex;
+        std::condition_variable mWake;
+        int mParked;
+
+        ParallelTask mTask;
+        void *mContext;
+        int mCount;
+    };
+
+    void runParallel(int threads, int count, ParallelTask task, void *context) {
+        //never destroyed, parked workers must not hold up process exit
+        static WorkerPool *pool = new WorkerPool();
+        pool->run(threads, count, task, context);
+    }
+}
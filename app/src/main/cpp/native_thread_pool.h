@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NATIVE_THREAD_POOL_H
+#define NATIVE_THREAD_POOL_H
+
+/*
+ * A process wide pool of persistent worker threads used by native_utils.cpp.
+ * Workers are pinned to a cpu, spin for a short while after a job and then
+ * park on a condition variable, so back to back frames do not pay for a wake
+ * up and idle workers do not burn a core.
+ */
+
+namespace native_utils {
+
+    typedef void (*ParallelTask)(void *context, int index);
+
+    /*
+     * Number of cpus of the device.
+     */
+    int getCpuCount();
+
+    /*
+     * Runs task(context, i) for every i in [0, count) on threads threads, the
+     * calling thread included, and returns when all of them are done.
+     * Runs on the calling thread alone when threads <= 1 or when another
+     * thread is already using the pool.
+     */
+    void runParallel(int threads, int count, ParallelTask task, void *context);
+
+    template<class Function>
+    static inline void parallelFor(int threads, int count, const Function &function) {
+        runParallel(threads, count, [](void *context, int index) {
+            (*static_cast<const Function *>(context))(index);
+        }, const_cast<Function *>(&function));
+    }
+}
+#endif //NATIVE_THREAD_POOL_H
@@ -15,19 +15,99 @@
  * limitations under the License.
  */
 
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include "native_utils.h"
+#include "native_color.h"
+#include "native_row.h"
+#include "native_thread_pool.h"
 
 namespace native_utils {
 
+    //set from any thread while conversions run on others
+    static std::atomic<int> sConvertEngine(CONVERT_ENGINE_ARITHMETIC);
+    static std::atomic<int> sConvertPrecision(CONVERT_PRECISION_EXACT);
+    static std::atomic<int> sConvertThreads(CONVERT_THREADS_AUTO);
+    static std::atomic<int> sChromaUpsampling(CHROMA_UPSAMPLING_NEAREST);
+    static std::atomic<int> sColorMatrix(COLOR_MATRIX_BT601);
+    static std::atomic<int> sColorRange(COLOR_RANGE_LIMITED);
+    static std::atomic<int> sChannelOrder(CHANNEL_ORDER_RGBA);
+
+/*
+ * Color adjustments folded into the conversions, see setColorAdjustment.
+ * matrix is the row-major color correction matrix.
+ */
+    struct ColorAdjustment {
+        float gains[3];
+        float matrix[9];
+        float brightness;
+        float contrast;
+        float saturation;
+    };
+
+    //folds into the plain coefficients of a color space
+    static const ColorAdjustment kIdentityColorAdjustment = {
+            {1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f},
+            0.0f, 1.0f, 1.0f};
+
+    static std::mutex sColorAdjustmentMutex;
+    static bool sColorAdjusted = false;
+    static ColorAdjustment sColorAdjustment;
+
+/*
+ * Frames below PARALLEL_MIN_PIXELS are converted on the calling thread, waking
+ * the workers costs more than it saves. Larger frames are split in about
+ * BANDS_PER_THREAD bands per thread so a slow core does not hold up the rest.
+ */
+    const int PARALLEL_MIN_PIXELS = 640 * 480;
+    const int BANDS_PER_THREAD = 4;
+    const int MIN_BAND_ROWS = 16;
+
+/*
+ * Destinations larger than the last level cache, and at least
+ * STREAM_MIN_BYTES, are written with non-temporal stores: the rows are
+ * converted into a buffer that stays in cache and streamed out from there.
+ * A destination that fits in the cache is faster to write through it.
+ */
+    const int STREAM_MIN_BYTES = 8 * 1024 * 1024;
+    const int MAX_CACHE_INDEX = 8;
+
+/*
+ * 90 and 270 degree rotations turn source rows into destination columns, so
+ * they go tile by tile: a square tile whose source and destination lines fit
+ * in half of the L1 cache, ROTATE_DEFAULT_L1_BYTES if sysfs does not tell.
+ */
+    const int ROTATE_DEFAULT_L1_BYTES = 32 * 1024;
+    const int ROTATE_MIN_TILE = 16;
+    const int ROTATE_MAX_TILE = 256;
+
+    //rows of packed 4:2:2 split into planes at a time, 2 bytes per pixel
+    const int PACKED_STRIP_ROWS = 8;
+
 /*
  * This function come from:
  * https://github.com/tensorflow/tensorflow/blob/master/tensorflow/examples/android/jni/yuv2rgb.cc
+ *
+ * It is split into a chroma part and a luma part, so the four pixels of a
+ * 2x2 block share the chroma products. The coefficients are one of the sets
+ * of native_color.h.
  */
-    static inline int YUV2RGBA(int nY, int nU, int nV) {
-        nY -= 16;
+    struct ChromaTerms {
+        int r;
+        int g;
+        int b;
+    };
+
+    template<class Coefficients>
+    static inline ChromaTerms YUV2RGBAChroma(int nU, int nV) {
         nU -= 128;
         nV -= 128;
-        if (nY < 0) nY = 0;
 
         // This is the floating point equivalent. We do the conversion in integer
         // because some Android devices do not have floating point in hardware.
@@ -35,464 +115,2387 @@ namespace native_utils {
         // nG = (int)(1.164 * nY - 0.813 * nV - 0.391 * nU);
         // nB = (int)(1.164 * nY + 1.596 * nV);
 
-        int nR = 1192 * nY + 1634 * nV;
-        int nG = 1192 * nY - 833 * nV - 400 * nU;
-        int nB = 1192 * nY + 2066 * nU;
+        ChromaTerms c;
+        c.r = Coefficients::kRV * nV;
+        c.g = Coefficients::kGV * nV + Coefficients::kGU * nU;
+        c.b = Coefficients::kBU * nU;
+        return c;
+    }
+
+    static inline unsigned int clampChannel(int c) {
+        c = c > K_MAX_CHANNEL_VALUE ? K_MAX_CHANNEL_VALUE : (c < 0 ? 0 : c);
+        return static_cast<unsigned int>(c >> 10) & 0xff;
+    }
+
+/*
+ * Output policies, one store per pixel.
+ * byte order: one of the ROW_OUTPUT_* orders, stored as one little-endian
+ * word, e.g. RGBA is the word ABGR
+ * int  order: ARGB, i.e. BGRA bytes
+ */
+    static inline void storeWord(unsigned char *dst, unsigned int word) {
+        memcpy(dst, &word, sizeof(word));
+    }
+
+    template<int kOutput>
+    struct ByteOutput {
+        typedef RowOutputOrder<kOutput> Order;
+        static const int kBytesPerPixel = 4;
+        static const int kRowOutput = kOutput;
+
+        static inline void store(unsigned char *dst, unsigned int r, unsigned int g,
+                                 unsigned int b) {
+            storeWord(dst, (0xffu << Order::kA * 8) | (r << Order::kR * 8) |
+                           (g << Order::kG * 8) | (b << Order::kB * 8));
+        }
+    };
+
+    typedef ByteOutput<ROW_OUTPUT_ARGB_INT> ARGBIntOutput;
+
+    //the rows of the ROW_PACK_* outputs, packed by the RowWriter
+    typedef ByteOutput<ROW_OUTPUT_RGBA> RGBAPackOutput;
+
+    //the 16-bit rows of the 10-bit input, r, g, b and alpha 1023, always packed
+    struct RGBA16Output {
+        static const int kBytesPerPixel = 8;
+        static const int kRowOutput = -1;
+
+        static inline void store(unsigned char *dst, unsigned int r, unsigned int g,
+                                 unsigned int b) {
+            const uint16_t pixel[4] = {static_cast<uint16_t>(r), static_cast<uint16_t>(g),
+                                       static_cast<uint16_t>(b), 1023};
+            memcpy(dst, pixel, sizeof(pixel));
+        }
+    };
+
+    static_assert(ROW_OUTPUT_RGBA == CHANNEL_ORDER_RGBA && ROW_OUTPUT_BGRA == CHANNEL_ORDER_BGRA &&
+                  ROW_OUTPUT_ARGB == CHANNEL_ORDER_ARGB && ROW_OUTPUT_ABGR == CHANNEL_ORDER_ABGR,
+                  "the byte outputs are picked with withRowOutput(channelOrder, ...)");
+
+/*
+ * Engine policies, how the chroma terms and the pixels are computed and which
+ * SIMD row kernel goes with them. An engine is passed by reference through the
+ * row functions, the compile-time engines are stateless.
+ */
+    template<class CoefficientSet>
+    struct ArithmeticEngine {
+        typedef CoefficientSet Coefficients;
+        typedef YUV420ToRGBARowFunc SimdRow;
+
+        template<class Output>
+        static inline SimdRow selectSimdRow(int chroma, int *step) {
+            if (chroma < 0) {
+                return nullptr;
+            }
+            return selectYUV420ToRGBARow(chroma, Output::kRowOutput, Coefficients::kMatrix,
+                                         Coefficients::kRange, step);
+        }
+
+        static inline ChromaTerms chroma(int nU, int nV) {
+            return YUV2RGBAChroma<Coefficients>(nU, nV);
+        }
+
+        template<class Output>
+        static inline void pixel(int nY, const ChromaTerms &c, unsigned char *dst) {
+            nY -= Coefficients::kYOffset;
+            if (nY < 0) nY = 0;
+            nY *= Coefficients::kY;
+            Output::store(dst, clampChannel(nY + c.r), clampChannel(nY + c.g),
+                          clampChannel(nY + c.b));
+        }
+    };
+
+/*
+ * The same products as YUV2RGBA, precomputed at compile time for every
+ * coefficient set. The clamp table is indexed by the sum >> 10, see
+ * native_color.h for its range.
+ */
+    const int CLAMP_TABLE_OFFSET = 320;
+    const int CLAMP_TABLE_SIZE = 896;
+
+    template<class Coefficients>
+    struct YUVTables {
+        int y[256];
+        int rv[256];
+        int gu[256];
+        int gv[256];
+        int bu[256];
+        unsigned char clamp[CLAMP_TABLE_SIZE];
+
+        constexpr YUVTables() : y(), rv(), gu(), gv(), bu(), clamp() {
+            for (int i = 0; i < 256; i++) {
+                const int nY = i - Coefficients::kYOffset;
+                y[i] = nY < 0 ? 0 : Coefficients::kY * nY;
+                rv[i] = Coefficients::kRV * (i - 128);
+                gu[i] = Coefficients::kGU * (i - 128);
+                gv[i] = Coefficients::kGV * (i - 128);
+                bu[i] = Coefficients::kBU * (i - 128);
+            }
+            for (int i = 0; i < CLAMP_TABLE_SIZE; i++) {
+                const int c = i - CLAMP_TABLE_OFFSET;
+                clamp[i] = static_cast<unsigned char>(c < 0 ? 0 : (c > 255 ? 255 : c));
+            }
+        }
+    };
+
+    template<class Coefficients>
+    static constexpr YUVTables<Coefficients> kYUVTables = YUVTables<Coefficients>();
+
+    template<class CoefficientSet>
+    struct TableEngine {
+        typedef CoefficientSet Coefficients;
+        typedef YUV420ToRGBARowFunc SimdRow;
+
+        template<class Output>
+        static inline SimdRow selectSimdRow(int, int *) {
+            return nullptr;
+        }
+
+        static inline ChromaTerms chroma(int nU, int nV) {
+            const YUVTables<Coefficients> &tables = kYUVTables<Coefficients>;
+            ChromaTerms c;
+            c.r = tables.rv[nV];
+            c.g = tables.gu[nU] + tables.gv[nV];
+            c.b = tables.bu[nU];
+            return c;
+        }
+
+        template<class Output>
+        static inline void pixel(int nY, const ChromaTerms &c, unsigned char *dst) {
+            const YUVTables<Coefficients> &tables = kYUVTables<Coefficients>;
+            const unsigned char *clamp = tables.clamp + CLAMP_TABLE_OFFSET;
+            const int y = tables.y[nY];
+            Output::store(dst, clamp[(y + c.r) >> 10], clamp[(y + c.g) >> 10],
+                          clamp[(y + c.b) >> 10]);
+        }
+    };
+
+/*
+ * CONVERT_PRECISION_FAST, the int16 math of FastColorCoefficients in
+ * native_color.h. The scalar pixels finish the rows of the fast kernels, so
+ * they must match them bit for bit.
+ */
+    template<class CoefficientSet>
+    struct FastEngine {
+        typedef FastColorCoefficients<CoefficientSet> Coefficients;
+        typedef YUV420ToRGBARowFunc SimdRow;
+
+        template<class Output>
+        static inline SimdRow selectSimdRow(int chroma, int *step) {
+            if (chroma < 0) {
+                return nullptr;
+            }
+            return selectYUV420ToRGBAFastRow(chroma, Output::kRowOutput, CoefficientSet::kMatrix,
+                                             CoefficientSet::kRange, step);
+        }
+
+        static inline ChromaTerms chroma(int nU, int nV) {
+            nU -= 128;
+            nV -= 128;
+            ChromaTerms c;
+            c.r = Coefficients::kRV * nV;
+            c.g = Coefficients::kGV * nV + Coefficients::kGU * nU;
+            c.b = Coefficients::kBU * nU;
+            return c;
+        }
+
+        static inline unsigned int clamp(int c) {
+            c >>= Coefficients::kFractionBits;
+            return static_cast<unsigned int>(c > 255 ? 255 : (c < 0 ? 0 : c));
+        }
+
+        template<class Output>
+        static inline void pixel(int nY, const ChromaTerms &c, unsigned char *dst) {
+            nY -= Coefficients::kYOffset;
+            if (nY < 0) nY = 0;
+            nY = (nY * Coefficients::kY) >> 1;
+            Output::store(dst, clamp(nY + c.r), clamp(nY + c.g), clamp(nY + c.b));
+        }
+    };
+
+/*
+ * A ColorTransform of native_color.h with the color adjustments folded in.
+ * One more multiply per channel and pixel than ArithmeticEngine.
+ */
+    class TransformEngine {
+    public:
+        class SimdRow {
+        public:
+            SimdRow(YUV420ToRGBATransformRowFunc row, const ColorTransform *transform)
+                    : mRow(row), mTransform(transform) {
+            }
+
+            explicit operator bool() const {
+                return mRow != nullptr;
+            }
+
+            void operator()(const unsigned char *srcY, const unsigned char *srcU,
+                            const unsigned char *srcV, unsigned char *dst, int width) const {
+                mRow(srcY, srcU, srcV, dst, width, mTransform);
+            }
+
+        private:
+            YUV420ToRGBATransformRowFunc mRow;
+            const ColorTransform *mTransform;
+        };
+
+        explicit TransformEngine(const ColorTransform &transform) : mTransform(transform) {
+        }
+
+        template<class Output>
+        inline SimdRow selectSimdRow(int chroma, int *step) const {
+            YUV420ToRGBATransformRowFunc row = nullptr;
+            if (chroma >= 0) {
+                row = selectYUV420ToRGBATransformRow(chroma, Output::kRowOutput, step);
+            }
+            return SimdRow(row, &mTransform);
+        }
+
+        inline ChromaTerms chroma(int nU, int nV) const {
+            nU -= 128;
+            nV -= 128;
+            ChromaTerms c;
+            c.r = mTransform.u[0] * nU + mTransform.v[0] * nV + mTransform.offset[0];
+            c.g = mTransform.u[1] * nU + mTransform.v[1] * nV + mTransform.offset[1];
+            c.b = mTransform.u[2] * nU + mTransform.v[2] * nV + mTransform.offset[2];
+            return c;
+        }
+
+        template<class Output>
+        inline void pixel(int nY, const ChromaTerms &c, unsigned char *dst) const {
+            nY -= mTransform.yOffset;
+            if (nY < 0) nY = 0;
+            Output::store(dst, clampChannel(mTransform.y[0] * nY + c.r),
+                          clampChannel(mTransform.y[1] * nY + c.g),
+                          clampChannel(mTransform.y[2] * nY + c.b));
+        }
+
+    private:
+        const ColorTransform mTransform;
+    };
+
+    static inline unsigned int clampChannel10(int c) {
+        c >>= 10;
+        return static_cast<unsigned int>(c > 1023 ? 1023 : (c < 0 ? 0 : c));
+    }
+
+/*
+ * 10-bit input with a ColorTransform, the terms scaled by 4 as described at
+ * YUV420ToRGBA16RowFunc in native_row.h. Only for RGBA16Output. kShift is 6
+ * for samples in the high bits.
+ */
+    template<int kShift>
+    class Transform10Engine {
+    public:
+        class SimdRow {
+        public:
+            SimdRow(YUV420ToRGBA16RowFunc row, const ColorTransform *transform)
+                    : mRow(row), mTransform(transform) {
+            }
+
+            explicit operator bool() const {
+                return mRow != nullptr;
+            }
+
+            void operator()(const uint16_t *srcY, const uint16_t *srcU, const uint16_t *srcV,
+                            unsigned char *dst, int width) const {
+                mRow(srcY, srcU, srcV, reinterpret_cast<uint16_t *>(dst), width, mTransform);
+            }
+
+        private:
+            YUV420ToRGBA16RowFunc mRow;
+            const ColorTransform *mTransform;
+        };
+
+        explicit Transform10Engine(const ColorTransform &transform) : mTransform(transform) {
+        }
+
+        template<class Output>
+        inline SimdRow selectSimdRow(int chroma, int *step) const {
+            YUV420ToRGBA16RowFunc row = nullptr;
+            if (chroma >= 0) {
+                row = selectYUV420ToRGBA16Row(chroma, kShift != 0, step);
+            }
+            return SimdRow(row, &mTransform);
+        }
+
+        inline ChromaTerms chroma(int nU, int nV) const {
+            nU = (nU >> kShift) - 512;
+            nV = (nV >> kShift) - 512;
+            ChromaTerms c;
+            c.r = mTransform.u[0] * nU + mTransform.v[0] * nV + mTransform.offset[0] * 4;
+            c.g = mTransform.u[1] * nU + mTransform.v[1] * nV + mTransform.offset[1] * 4;
+            c.b = mTransform.u[2] * nU + mTransform.v[2] * nV + mTransform.offset[2] * 4;
+            return c;
+        }
+
+        template<class Output>
+        inline void pixel(int nY, const ChromaTerms &c, unsigned char *dst) const {
+            nY = (nY >> kShift) - mTransform.yOffset * 4;
+            if (nY < 0) nY = 0;
+            Output::store(dst, clampChannel10(mTransform.y[0] * nY + c.r),
+                          clampChannel10(mTransform.y[1] * nY + c.g),
+                          clampChannel10(mTransform.y[2] * nY + c.b));
+        }
+
+    private:
+        const ColorTransform mTransform;
+    };
+
+/*
+ * Layout policies, where the chroma of a 2x2 block is.
+ * u and v point to the first chroma sample of the row, the sample of the
+ * block at column x is at (x >> 1) * pixel stride. kPixelStride 0 means the
+ * stride is only known at runtime. kRowChroma is the chroma layout of the
+ * SIMD row kernels, -1 when there is none. kChromaRowShift is 1 when a
+ * chroma row covers two rows, 4:2:0, and 0 for one chroma row per row.
+ * Sample is unsigned char, or uint16_t for 10-bit input, strides are in
+ * samples.
+ */
+    template<class Sample>
+    struct YUV420Frame {
+        const Sample *y;
+        const Sample *u;
+        const Sample *v;
+        int width;
+        int height;
+        int yRowStride;
+        int uvRowStride;
+        int uvPixelStride;
+    };
+
+    struct PlanarLayout {
+        static const int kPixelStride = 1;
+        static const int kRowChroma = ROW_CHROMA_PLANAR;
+        static const int kChromaRowShift = 1;
+    };
+
+    struct StridedPlanarLayout {
+        static const int kPixelStride = 0;
+        static const int kRowChroma = -1;
+        static const int kChromaRowShift = 1;
+    };
+
+    struct NV12Layout {
+        static const int kPixelStride = 2;
+        static const int kRowChroma = ROW_CHROMA_NV12;
+        static const int kChromaRowShift = 1;
+    };
+
+    struct NV21Layout {
+        static const int kPixelStride = 2;
+        static const int kRowChroma = ROW_CHROMA_NV21;
+        static const int kChromaRowShift = 1;
+    };
+
+    //the 4:2:2 form of a 4:2:0 layout, e.g. I422 and NV16
+    template<class Layout>
+    struct Layout422 : Layout {
+        static const int kChromaRowShift = 0;
+    };
+
+    //one chroma sample per pixel, I444
+    struct I444Layout {
+        static const int kPixelStride = 1;
+        static const int kRowChroma = ROW_CHROMA_444;
+        static const int kChromaRowShift = 0;
+    };
+
+    //the blended chroma rows of YUV420ToRGBARowsBilinear
+    struct BilinearLayout {
+        static const int kPixelStride = 1;
+        static const int kRowChroma = ROW_CHROMA_BILINEAR;
+        static const int kChromaRowShift = 0;
+    };
+
+#if !defined(HAS_NEON_ROW) && !defined(HAS_X86_ROW)
+    YUV420ToRGBARowFunc selectYUV420ToRGBARow(int, int, int, int, int *) {
+        return nullptr;
+    }
+
+    YUV420ToRGBARowFunc selectYUV420ToRGBAFastRow(int, int, int, int, int *) {
+        return nullptr;
+    }
+
+    YUV420ToRGBATransformRowFunc selectYUV420ToRGBATransformRow(int, int, int *) {
+        return nullptr;
+    }
+
+    BlendChromaRowFunc selectBlendChromaRow(int, int *) {
+        return nullptr;
+    }
+
+    StreamRowFunc selectStreamRow() {
+        return nullptr;
+    }
+
+    PackRowFunc selectPackRow(int, int *) {
+        return nullptr;
+    }
+
+    LumaRowFunc selectLumaRow(int, int *) {
+        return nullptr;
+    }
+
+    SplitPackedRowFunc selectSplitPackedRow(int, int *) {
+        return nullptr;
+    }
+
+    YUV420ToRGBA16RowFunc selectYUV420ToRGBA16Row(int, bool, int *) {
+        return nullptr;
+    }
+
+    RGBAToYRowFunc selectRGBAToYRow(int, int, int, int *) {
+        return nullptr;
+    }
+
+    RGBAToUVRowFunc selectRGBAToUVRow(int, int, int, int, int *) {
+        return nullptr;
+    }
+
+    PackRowFunc selectPack16Row(int, int *) {
+        return nullptr;
+    }
+
+    UnpackRawRowFunc selectUnpackRawRow(int, int *) {
+        return nullptr;
+    }
+
+    DemosaicRowFunc selectDemosaicRow(int, int, int *) {
+        return nullptr;
+    }
+
+    TransposeBlockFunc selectTransposeBlock(int, int *) {
+        return nullptr;
+    }
+#endif
+
+    //a value of cache index i of cpu0 from sysfs with its K or M suffix applied, -1 without it
+    static long long readCacheValue(int index, const char *name) {
+        char path[80];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, name);
+        FILE *file = fopen(path, "r");
+        if (!file) {
+            return -1;
+        }
+        long long value = 0;
+        char unit = 0;
+        if (fscanf(file, "%lld%c", &value, &unit) >= 1) {
+            value <<= unit == 'K' ? 10 : (unit == 'M' ? 20 : 0);
+        }
+        fclose(file);
+        return value;
+    }
+
+    //largest cache of cpu0 in bytes from sysfs, 0 if the kernel does not tell
+    static long long readLargestCacheSize() {
+        long long largest = 0;
+        for (int i = 0; i < MAX_CACHE_INDEX; i++) {
+            const long long size = readCacheValue(i, "size");
+            if (size < 0) {
+                break;
+            }
+            largest = size > largest ? size : largest;
+        }
+        return largest;
+    }
+
+    //smallest level 1 cache of cpu0 in bytes, the data cache or a unified one, 0 if unknown
+    static long long readL1CacheSize() {
+        long long smallest = 0;
+        for (int i = 0; i < MAX_CACHE_INDEX; i++) {
+            const long long size = readCacheValue(i, "size");
+            if (size < 0) {
+                break;
+            }
+            if (readCacheValue(i, "level") == 1 && size > 0) {
+                smallest = smallest == 0 || size < smallest ? size : smallest;
+            }
+        }
+        return smallest;
+    }
+
+    static inline StreamRowFunc selectStreamRow(int width, int height, int bytesPerPixel) {
+        static const long long cacheSize = readLargestCacheSize();
+        const long long bytes = static_cast<long long>(width) * height * bytesPerPixel;
+        if (bytes < STREAM_MIN_BYTES || bytes <= cacheSize) {
+            return nullptr;
+        }
+        return selectStreamRow();
+    }
+
+/*
+ * The ROW_PACK_* formats of native_row.h in C, from column x to the end of
+ * the row. Bit-exact with the pack kernels.
+ */
+    template<int kPack>
+    static void packRow(const unsigned char *src, unsigned char *dst, int x, int width, int y) {
+        const unsigned char *dither = ROW_DITHER_4X4[y & 3];
+        for (; x < width; x++) {
+            const unsigned char *p = src + x * 4;
+            if (kPack == ROW_PACK_RGB24) {
+                dst[x * 3] = p[0];
+                dst[x * 3 + 1] = p[1];
+                dst[x * 3 + 2] = p[2];
+            } else if (kPack == ROW_PACK_GRAY) {
+                const int gray = (77 * p[0] + 150 * p[1] + 29 * p[2] + 128) >> 8;
+                dst[x] = static_cast<unsigned char>(gray);
+            } else {
+                int r = p[0];
+                int g = p[1];
+                int b = p[2];
+                if (kPack == ROW_PACK_RGB565_DITHER) {
+                    const int d = dither[x & 3];
+                    r = r + (d >> 1) > 255 ? 255 : r + (d >> 1);
+                    g = g + (d >> 2) > 255 ? 255 : g + (d >> 2);
+                    b = b + (d >> 1) > 255 ? 255 : b + (d >> 1);
+                }
+                const uint16_t rgb565 = static_cast<uint16_t>(((r >> 3) << 11) | ((g >> 2) << 5) |
+                                                              (b >> 3));
+                memcpy(dst + x * 2, &rgb565, sizeof(rgb565));
+            }
+        }
+    }
+
+/*
+ * The float outputs have no row kernels: every channel is one of 256 byte
+ * values, or 1024 of the 10-bit rows, so the EOTF and the conversion to float
+ * or half are one lookup. The LINEARIZE_* of the table is in the low bits of
+ * the pack.
+ * PACK_ROW16: the rows are RGBA16Output, packed with the ROW_PACK16_* of
+ * native_row.h or to float or half.
+ */
+    const int PACK_RGBA_FLOAT = 0x100;
+    const int PACK_RGBA_HALF = 0x200;
+    const int PACK_ROW16 = 0x400;
+    const int PACK_LINEARIZE_MASK = 0xff;
+
+    template<int kLevels>
+    struct LinearizeTables {
+        float f32[kLevels];
+        uint16_t f16[kLevels];
+    };
+
+    //IEEE 754 binary16 of f in [0, 1], rounded to nearest even like vcvtps2ph
+    static uint16_t floatToHalf(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        const int exponent = static_cast<int>(bits >> 23) - 127 + 15;
+        if (exponent <= 0) {
+            //subnormal, in units of 2^-24, 1024 rounds up to the smallest normal
+            return static_cast<uint16_t>(lrintf(f * 16777216.0f));
+        }
+        const uint32_t mantissa = bits & 0x7fffff;
+        const uint32_t rest = mantissa & 0x1fff;
+        uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+            half++;
+        }
+        return static_cast<uint16_t>(half);
+    }
+
+    template<int kLevels>
+    static LinearizeTables<kLevels> makeLinearizeTables(int linearize) {
+        LinearizeTables<kLevels> tables;
+        for (int i = 0; i < kLevels; i++) {
+            const double v = i / static_cast<double>(kLevels - 1);
+            double l = v;
+            if (linearize == LINEARIZE_SRGB) {
+                l = v <= 0.04045 ? v / 12.92 : pow((v + 0.055) / 1.055, 2.4);
+            } else if (linearize == LINEARIZE_BT1886) {
+                l = pow(v, 2.4);
+            }
+            tables.f32[i] = static_cast<float>(l);
+            tables.f16[i] = floatToHalf(tables.f32[i]);
+        }
+        return tables;
+    }
+
+    template<int kLevels>
+    static const LinearizeTables<kLevels> &linearizeTables(int linearize) {
+        static const LinearizeTables<kLevels> tables[] = {
+                makeLinearizeTables<kLevels>(LINEARIZE_NONE),
+                makeLinearizeTables<kLevels>(LINEARIZE_SRGB),
+                makeLinearizeTables<kLevels>(LINEARIZE_BT1886)
+        };
+        return tables[linearize];
+    }
+
+    //R, G, B through the table, alpha 1
+    template<class Source, class T>
+    static void packFloatRow(const Source *src, T *dst, int width, const T *table) {
+        for (int x = 0; x < width; x++) {
+            dst[x * 4] = table[src[x * 4]];
+            dst[x * 4 + 1] = table[src[x * 4 + 1]];
+            dst[x * 4 + 2] = table[src[x * 4 + 2]];
+            dst[x * 4 + 3] = table[src[x * 4 + 3]];
+        }
+    }
+
+/*
+ * The ROW_PACK16_* formats in C, from column x to the end of the row.
+ * Bit-exact with the pack kernels.
+ */
+    template<int kPack>
+    static void pack16Row(const uint16_t *src, unsigned char *dst, int x, int width) {
+        for (; x < width; x++) {
+            const uint16_t *p = src + x * 4;
+            if (kPack == ROW_PACK16_RGBA1010102) {
+                storeWord(dst + x * 4, p[0] | p[1] << 10 | p[2] << 20 | 0xc0000000u);
+            } else {
+                ByteOutput<kPack - ROW_PACK16_BYTES>::store(dst + x * 4, p[0] >> 2, p[1] >> 2,
+                                                            p[2] >> 2);
+            }
+        }
+    }
+
+    static inline int packedBytesPerPixel(int pack) {
+        if (pack & PACK_RGBA_FLOAT) {
+            return 4 * sizeof(float);
+        } else if (pack & PACK_RGBA_HALF) {
+            return 4 * sizeof(uint16_t);
+        } else if (pack & PACK_ROW16) {
+            return 4;
+        } else if (pack == ROW_PACK_RGB24) {
+            return 3;
+        }
+        return pack == ROW_PACK_GRAY ? 1 : 2;
+    }
+
+/*
+ * Where the converted rows go. Without a pack they are converted in place,
+ * or into a row buffer that is streamed out, see STREAM_MIN_BYTES. With one
+ * of the ROW_PACK_* formats the rows are converted into a row buffer of RGBA
+ * bytes that stays in cache, and only the packed pixels are written to dst.
+ * With PACK_ROW16 the row buffer is RGBA16Output.
+ */
+    class RowWriter {
+    public:
+        RowWriter(int pack, int width, int height, int bytesPerPixel)
+                : mPack(pack), mBytesPerPixel(bytesPerPixel), mStreamRow(nullptr),
+                  mPackRow(nullptr), mPackStep(0), mFloatTable(nullptr), mHalfTable(nullptr) {
+            const int linearize = pack & PACK_LINEARIZE_MASK;
+            if (pack == ROW_PACK_NONE) {
+                mStreamRow = selectStreamRow(width, height, bytesPerPixel);
+            } else if (!(pack & (PACK_RGBA_FLOAT | PACK_RGBA_HALF))) {
+                mPackRow = pack & PACK_ROW16 ? selectPack16Row(pack & ~PACK_ROW16, &mPackStep)
+                                             : selectPackRow(pack, &mPackStep);
+            } else if (pack & PACK_ROW16) {
+                mFloatTable = linearizeTables<1024>(linearize).f32;
+                mHalfTable = linearizeTables<1024>(linearize).f16;
+            } else {
+                mFloatTable = linearizeTables<256>(linearize).f32;
+                mHalfTable = linearizeTables<256>(linearize).f16;
+            }
+        }
+
+        inline bool buffered() const {
+            return mPack != ROW_PACK_NONE || mStreamRow;
+        }
+
+        inline int dstBytesPerPixel() const {
+            return mPack == ROW_PACK_NONE ? mBytesPerPixel : packedBytesPerPixel(mPack);
+        }
+
+        //rows consecutive rows of the row buffer, the first one is image row y
+        void write(const unsigned char *src, unsigned char *dst, int width, int y,
+                   int rows) const {
+            if (mPack == ROW_PACK_NONE) {
+                mStreamRow(src, dst, width * rows * mBytesPerPixel);
+                return;
+            }
+            for (int i = 0; i < rows; i++) {
+                const unsigned char *pSrc = src + i * width * mBytesPerPixel;
+                unsigned char *pDst = dst + i * width * dstBytesPerPixel();
+                if (mPack & PACK_RGBA_FLOAT) {
+                    packFloat(pSrc, reinterpret_cast<float *>(pDst), width, mFloatTable);
+                    continue;
+                } else if (mPack & PACK_RGBA_HALF) {
+                    packFloat(pSrc, reinterpret_cast<uint16_t *>(pDst), width, mHalfTable);
+                    continue;
+                }
+                int x = 0;
+                if (mPackRow) {
+                    x = width & ~(mPackStep - 1);
+                    mPackRow(pSrc, pDst, x, y + i);
+                }
+                if (mPack & PACK_ROW16) {
+                    pack16(reinterpret_cast<const uint16_t *>(pSrc), pDst, x, width);
+                } else if (mPack == ROW_PACK_RGB565) {
+                    packRow<ROW_PACK_RGB565>(pSrc, pDst, x, width, y + i);
+                } else if (mPack == ROW_PACK_RGB565_DITHER) {
+                    packRow<ROW_PACK_RGB565_DITHER>(pSrc, pDst, x, width, y + i);
+                } else if (mPack == ROW_PACK_RGB24) {
+                    packRow<ROW_PACK_RGB24>(pSrc, pDst, x, width, y + i);
+                } else {
+                    packRow<ROW_PACK_GRAY>(pSrc, pDst, x, width, y + i);
+                }
+            }
+        }
+
+    private:
+        template<class T>
+        inline void packFloat(const unsigned char *src, T *dst, int width, const T *table) const {
+            if (mPack & PACK_ROW16) {
+                packFloatRow(reinterpret_cast<const uint16_t *>(src), dst, width, table);
+            } else {
+                packFloatRow(src, dst, width, table);
+            }
+        }
+
+        inline void pack16(const uint16_t *src, unsigned char *dst, int x, int width) const {
+            const int pack = mPack & ~PACK_ROW16;
+            if (pack == ROW_PACK16_RGBA1010102) {
+                pack16Row<ROW_PACK16_RGBA1010102>(src, dst, x, width);
+            } else {
+                withRowOutput(pack - ROW_PACK16_BYTES, [&](auto order) {
+                    pack16Row<ROW_PACK16_BYTES + decltype(order)::value>(src, dst, x, width);
+                });
+            }
+        }
+
+        const int mPack;
+        const int mBytesPerPixel;
+        StreamRowFunc mStreamRow;
+        PackRowFunc mPackRow;
+        int mPackStep;
+        const float *mFloatTable;
+        const uint16_t *mHalfTable;
+    };
+
+    //the blend kernels are 8-bit only
+    template<class Layout, class Sample>
+    static inline BlendChromaRowFunc selectSimdBlendRow(int *step) {
+        if (Layout::kRowChroma < 0 || sizeof(Sample) != 1) {
+            return nullptr;
+        }
+        return selectBlendChromaRow(Layout::kRowChroma, step);
+    }
+
+/*
+ * Tagged with sizeof(Sample) == 1: the kernels take 8-bit samples, wider ones
+ * never get one from selectSimdBlendRow and only need the call to compile.
+ */
+    static inline void
+    simdBlendRow(std::true_type, BlendChromaRowFunc row, const unsigned char *nearU,
+                 const unsigned char *nearV, const unsigned char *farU,
+                 const unsigned char *farV, unsigned char *dstU, unsigned char *dstV,
+                 int width) {
+        row(nearU, nearV, farU, farV, dstU, dstV, width);
+    }
+
+    template<class Sample>
+    static inline void
+    simdBlendRow(std::false_type, BlendChromaRowFunc, const Sample *, const Sample *,
+                 const Sample *, const Sample *, Sample *, Sample *, int) {
+    }
+
+    template<class Output, class Engine, class Sample>
+    static inline void
+    YUV444ToRGBARow(const Engine &engine, const Sample *srcY, const Sample *srcU,
+                    const Sample *srcV, unsigned char *dst, int x, int width) {
+        for (; x < width; x++) {
+            engine.template pixel<Output>(srcY[x], engine.chroma(srcU[x], srcV[x]),
+                                          dst + x * Output::kBytesPerPixel);
+        }
+    }
+
+    //the odd pixels of ROW_CHROMA_BILINEAR average the samples on both sides
+    template<class Output, class Engine, class Sample>
+    static inline void
+    YUV420ToRGBABilinearRow(const Engine &engine, const Sample *srcY, const Sample *srcU,
+                            const Sample *srcV, unsigned char *dst, int x, int width) {
+        for (; x < width; x++) {
+            const int i = x >> 1;
+            int u = srcU[i];
+            int v = srcV[i];
+            if (x & 1) {
+                u = (u + srcU[i + 1] + 1) >> 1;
+                v = (v + srcV[i + 1] + 1) >> 1;
+            }
+            engine.template pixel<Output>(srcY[x], engine.chroma(u, v),
+                                          dst + x * Output::kBytesPerPixel);
+        }
+    }
+
+/*
+ * Convert one or two rows from column x to the end of the row, one 2x2 block
+ * per step. y1 and dst1 are nullptr for the last row of an odd height image,
+ * and for the layouts with a chroma row per row.
+ */
+    template<class Layout, class Output, class Engine, class Sample>
+    static inline void
+    YUV420ToRGBARowPair(const Engine &engine, const Sample *y0, const Sample *y1,
+                        const Sample *u, const Sample *v, int uvPixelStride,
+                        unsigned char *dst0, unsigned char *dst1, int x, int width) {
+        if (Layout::kRowChroma == ROW_CHROMA_444) {
+            YUV444ToRGBARow<Output>(engine, y0, u, v, dst0, x, width);
+            return;
+        } else if (Layout::kRowChroma == ROW_CHROMA_BILINEAR) {
+            YUV420ToRGBABilinearRow<Output>(engine, y0, u, v, dst0, x, width);
+            return;
+        }
+        const int pixelStride = Layout::kPixelStride ? Layout::kPixelStride : uvPixelStride;
+        const int bpp = Output::kBytesPerPixel;
+        for (; x + 1 < width; x += 2) {
+            const int uvOffset = (x >> 1) * pixelStride;
+            const ChromaTerms c = engine.chroma(u[uvOffset], v[uvOffset]);
+            engine.template pixel<Output>(y0[x], c, dst0 + x * bpp);
+            engine.template pixel<Output>(y0[x + 1], c, dst0 + (x + 1) * bpp);
+            if (y1) {
+                engine.template pixel<Output>(y1[x], c, dst1 + x * bpp);
+                engine.template pixel<Output>(y1[x + 1], c, dst1 + (x + 1) * bpp);
+            }
+        }
+        if (x < width) {
+            const int uvOffset = (x >> 1) * pixelStride;
+            const ChromaTerms c = engine.chroma(u[uvOffset], v[uvOffset]);
+            engine.template pixel<Output>(y0[x], c, dst0 + x * bpp);
+            if (y1) {
+                engine.template pixel<Output>(y1[x], c, dst1 + x * bpp);
+            }
+        }
+    }
+
+    template<class Layout, class Output, class Engine, class Sample>
+    static void
+    YUV420ToRGBARowsNearest(const YUV420Frame<Sample> &frame, const Engine &engine,
+                            unsigned char *dst,
+                            int yBegin, int yEnd, const RowWriter &writer) {
+        const int rowStride = frame.width * Output::kBytesPerPixel;
+        const int dstRowStride = frame.width * writer.dstBytesPerPixel();
+        std::vector<unsigned char> rows(writer.buffered() ? rowStride * 2 : 0);
+        int simdStep = 0;
+        const typename Engine::SimdRow simdRow =
+                engine.template selectSimdRow<Output>(Layout::kRowChroma, &simdStep);
+        const int rowStep = 1 << Layout::kChromaRowShift;
+        for (int y = yBegin; y < yEnd; y += rowStep) {
+            const Sample *pY0 = frame.y + y * frame.yRowStride;
+            const Sample *pY1 = rowStep == 2 && y + 1 < frame.height ? pY0 + frame.yRowStride
+                                                                     : nullptr;
+            const Sample *pU = frame.u + (y >> Layout::kChromaRowShift) * frame.uvRowStride;
+            const Sample *pV = frame.v + (y >> Layout::kChromaRowShift) * frame.uvRowStride;
+            unsigned char *pOut = dst + y * dstRowStride;
+            unsigned char *pDst0 = writer.buffered() ? rows.data() : pOut;
+            unsigned char *pDst1 = pY1 ? pDst0 + rowStride : nullptr;
+            int x = 0;
+            if (simdRow) {
+                x = frame.width & ~(simdStep - 1);
+                simdRow(pY0, pU, pV, pDst0, x);
+                if (pY1) {
+                    simdRow(pY1, pU, pV, pDst1, x);
+                }
+            }
+            YUV420ToRGBARowPair<Layout, Output>(engine, pY0, pY1, pU, pV, frame.uvPixelStride,
+                                                pDst0, pDst1, x, frame.width);
+            if (writer.buffered()) {
+                writer.write(pDst0, pOut, frame.width, y, pY1 ? 2 : 1);
+            }
+        }
+    }
+
+/*
+ * The vertical half of the bilinear chroma upsampling from column x to the end
+ * of the row, the same filter as BlendChromaRowFunc in native_row.h.
+ */
+    static inline int blendChroma(int near, int far) {
+        return (3 * near + far + 2) >> 2;
+    }
+
+    template<class Layout, class Sample>
+    static inline void
+    blendChromaRow(const Sample *nearU, const Sample *nearV, const Sample *farU,
+                   const Sample *farV, int uvPixelStride, Sample *dstU, Sample *dstV, int x,
+                   int width) {
+        const int pixelStride = Layout::kPixelStride ? Layout::kPixelStride : uvPixelStride;
+        for (int i = x >> 1; i < (width + 1) >> 1; i++) {
+            const int offset = i * pixelStride;
+            dstU[i] = static_cast<Sample>(blendChroma(nearU[offset], farU[offset]));
+            dstV[i] = static_cast<Sample>(blendChroma(nearV[offset], farV[offset]));
+        }
+    }
+
+/*
+ * Every output row is converted from its own blended chroma row. Chroma rows
+ * sit between two luma rows, so an even row blends with the chroma row above
+ * and an odd row with the one below. A 4:2:2 row blends with its own chroma
+ * row, which leaves it as is. The conversion interpolates the blended row
+ * horizontally, see ROW_CHROMA_BILINEAR in native_row.h.
+ */
+    template<class Layout, class Output, class Engine, class Sample>
+    static void
+    YUV420ToRGBARowsBilinear(const YUV420Frame<Sample> &frame, const Engine &engine,
+                             unsigned char *dst, int yBegin, int yEnd, const RowWriter &writer) {
+        const int dstRowStride = frame.width * writer.dstBytesPerPixel();
+        const int uvLastRow =
+                ((frame.height + Layout::kChromaRowShift) >> Layout::kChromaRowShift) - 1;
+        const int uvWidth = (frame.width + 1) >> 1;
+        //one more sample for the right neighbour of the last one
+        std::vector<Sample> chroma((uvWidth + 1) * 2);
+        const int rowStride = frame.width * Output::kBytesPerPixel;
+        std::vector<unsigned char> row(writer.buffered() ? rowStride : 0);
+        Sample *pBlendU = chroma.data();
+        Sample *pBlendV = pBlendU + uvWidth + 1;
+        const Sample *noRow = nullptr;
+
+        int blendStep = 0;
+        const BlendChromaRowFunc blendRow = selectSimdBlendRow<Layout, Sample>(&blendStep);
+        const int blendWidth = blendRow ? (uvWidth * 2) & ~(blendStep - 1) : 0;
+        int simdStep = 0;
+        const typename Engine::SimdRow simdRow =
+                engine.template selectSimdRow<Output>(ROW_CHROMA_BILINEAR, &simdStep);
+
+        for (int y = yBegin; y < yEnd; y++) {
+            const int uvRow = y >> Layout::kChromaRowShift;
+            int uvFarRow = !Layout::kChromaRowShift ? uvRow : (y & 1 ? uvRow + 1 : uvRow - 1);
+            uvFarRow = uvFarRow < 0 ? 0 : (uvFarRow > uvLastRow ? uvLastRow : uvFarRow);
+            const Sample *pNearU = frame.u + uvRow * frame.uvRowStride;
+            const Sample *pNearV = frame.v + uvRow * frame.uvRowStride;
+            const Sample *pFarU = frame.u + uvFarRow * frame.uvRowStride;
+            const Sample *pFarV = frame.v + uvFarRow * frame.uvRowStride;
+            const Sample *pY = frame.y + y * frame.yRowStride;
+            unsigned char *pOut = dst + y * dstRowStride;
+            unsigned char *pDst = writer.buffered() ? row.data() : pOut;
+
+            int x = 0;
+            if (blendRow) {
+                x = blendWidth;
+                simdBlendRow(std::integral_constant<bool, sizeof(Sample) == 1>(), blendRow,
+                             pNearU, pNearV, pFarU, pFarV, pBlendU, pBlendV, x);
+            }
+            blendChromaRow<Layout>(pNearU, pNearV, pFarU, pFarV, frame.uvPixelStride, pBlendU,
+                                   pBlendV, x, frame.width);
+            pBlendU[uvWidth] = pBlendU[uvWidth - 1];
+            pBlendV[uvWidth] = pBlendV[uvWidth - 1];
+            x = 0;
+            if (simdRow) {
+                x = frame.width & ~(simdStep - 1);
+                simdRow(pY, pBlendU, pBlendV, pDst, x);
+            }
+            YUV420ToRGBARowPair<BilinearLayout, Output>(engine, pY, noRow, pBlendU, pBlendV, 1,
+                                                        pDst, nullptr, x, frame.width);
+            if (writer.buffered()) {
+                writer.write(pDst, pOut, frame.width, y, 1);
+            }
+        }
+    }
+
+    template<class Layout, class Output, class Engine, class Sample>
+    static inline void
+    YUV420ToRGBARows(const YUV420Frame<Sample> &frame, const Engine &engine, unsigned char *dst,
+                     int yBegin, int yEnd, bool bilinear, const RowWriter &writer) {
+        if (bilinear && Layout::kRowChroma != ROW_CHROMA_444) {
+            YUV420ToRGBARowsBilinear<Layout, Output>(frame, engine, dst, yBegin, yEnd, writer);
+        } else {
+            YUV420ToRGBARowsNearest<Layout, Output>(frame, engine, dst, yBegin, yEnd, writer);
+        }
+    }
+
+/*
+ * Packed 4:2:2, two pixels in one 4 byte macropixel, see ROW_PACKED_* in
+ * native_row.h. Odd widths end with a macropixel of one pixel.
+ */
+    struct YUV422PackedFrame {
+        const unsigned char *src;
+        int width;
+        int height;
+        int rowStride;
+    };
+
+    template<int kFormat>
+    struct PackedLayout {
+        static const int kPacked = kFormat;
+    };
+
+    //the ROW_PACKED_* split in C, from column x to the end of the row
+    template<int kPacked>
+    static void splitPackedRow(const unsigned char *src, unsigned char *dstY, unsigned char *dstU,
+                               unsigned char *dstV, int x, int width) {
+        const int y = kPacked == ROW_PACKED_YUY2 ? 0 : 1;
+        const int u = kPacked == ROW_PACKED_YUY2 ? 1 : 0;
+        for (; x < width; x++) {
+            const unsigned char *p = src + (x >> 1) * 4;
+            dstY[x] = p[y + (x & 1) * 2];
+            if (!(x & 1)) {
+                dstU[x >> 1] = p[u];
+                dstV[x >> 1] = p[u + 2];
+            }
+        }
+    }
+
+/*
+ * The rows are split into I422 planes PACKED_STRIP_ROWS at a time, small
+ * enough to stay in cache, and the planes are converted as I422.
+ */
+    template<class Layout, class Output, class Engine>
+    static void
+    YUV420ToRGBARows(const YUV422PackedFrame &frame, const Engine &engine, unsigned char *dst,
+                     int yBegin, int yEnd, bool bilinear, const RowWriter &writer) {
+        const int uvWidth = (frame.width + 1) >> 1;
+        const int dstRowStride = frame.width * writer.dstBytesPerPixel();
+        std::vector<unsigned char> planes((frame.width + uvWidth * 2) * PACKED_STRIP_ROWS);
+        int splitStep = 0;
+        const SplitPackedRowFunc splitRow = selectSplitPackedRow(Layout::kPacked, &splitStep);
+        for (int y = yBegin; y < yEnd; y += PACKED_STRIP_ROWS) {
+            const int rows = yEnd - y < PACKED_STRIP_ROWS ? yEnd - y : PACKED_STRIP_ROWS;
+            YUV420Frame<unsigned char> strip;
+            strip.y = planes.data();
+            strip.u = strip.y + frame.width * rows;
+            strip.v = strip.u + uvWidth * rows;
+            strip.width = frame.width;
+            strip.height = rows;
+            strip.yRowStride = frame.width;
+            strip.uvRowStride = uvWidth;
+            strip.uvPixelStride = 1;
+            for (int i = 0; i < rows; i++) {
+                const unsigned char *pSrc = frame.src + (y + i) * frame.rowStride;
+                unsigned char *pY = planes.data() + i * frame.width;
+                unsigned char *pU = planes.data() + frame.width * rows + i * uvWidth;
+                unsigned char *pV = pU + uvWidth * rows;
+                int x = 0;
+                if (splitRow) {
+                    x = frame.width & ~(splitStep - 1);
+                    splitRow(pSrc, pY, pU, pV, x);
+                }
+                splitPackedRow<Layout::kPacked>(pSrc, pY, pU, pV, x, frame.width);
+            }
+            unsigned char *pDst = dst + y * dstRowStride;
+            YUV420ToRGBARows<Layout422<PlanarLayout>, Output>(strip, engine, pDst, 0, rows,
+                                                              bilinear, writer);
+        }
+    }
+
+    static inline int convertThreads(int width, int height) {
+        if (width * height < PARALLEL_MIN_PIXELS) {
+            return 1;
+        }
+        const int threads = sConvertThreads;
+        return threads == CONVERT_THREADS_AUTO ? getCpuCount() : threads;
+    }
+
+/*
+ * Split the frame in bands of an even number of rows, so every band starts on
+ * a chroma row and no 2x2 block is shared by two bands, and call
+ * function(yBegin, yEnd) for every band.
+ */
+    template<class Function>
+    static void forEachBand(int width, int height, const Function &function) {
+        const int threads = convertThreads(width, height);
+        if (threads <= 1) {
+            function(0, height);
+            return;
+        }
+        int bandRows = (height + threads * BANDS_PER_THREAD - 1) / (threads * BANDS_PER_THREAD);
+        bandRows = bandRows < MIN_BAND_ROWS ? MIN_BAND_ROWS : (bandRows + 1) & ~1;
+        const int bands = (height + bandRows - 1) / bandRows;
+        parallelFor(threads, bands, [height, bandRows, &function](int band) {
+            const int yBegin = band * bandRows;
+            function(yBegin, yBegin + bandRows < height ? yBegin + bandRows : height);
+        });
+    }
+
+    template<class Layout, class Output, class Engine, class Frame>
+    static void YUV420ToRGBA(const Frame &frame, const Engine &engine, unsigned char *dst,
+                             int pack) {
+        const bool bilinear = sChromaUpsampling == CHROMA_UPSAMPLING_BILINEAR;
+        const RowWriter writer(pack, frame.width, frame.height, Output::kBytesPerPixel);
+        forEachBand(frame.width, frame.height, [&](int yBegin, int yEnd) {
+            YUV420ToRGBARows<Layout, Output>(frame, engine, dst, yBegin, yEnd, bilinear,
+                                             writer);
+        });
+    }
+
+    static inline bool getColorAdjustment(ColorAdjustment *adjustment) {
+        std::lock_guard<std::mutex> lock(sColorAdjustmentMutex);
+        *adjustment = sColorAdjustment;
+        return sColorAdjusted;
+    }
+
+    static inline int16_t toTransformCoefficient(double c) {
+        c = c > INT16_MAX ? INT16_MAX : (c < INT16_MIN ? INT16_MIN : c);
+        return static_cast<int16_t>(lround(c));
+    }
+
+/*
+ * Fold the adjustments into the coefficients of a color space, with s the
+ * saturation and M the coefficients of native_color.h:
+ *   rgb = contrast * (matrix * gains * M * (Y, s * U, s * V) - 128) + 128 + brightness
+ * Coefficients beyond 16 bits saturate.
+ */
+    template<class Coefficients>
+    static ColorTransform foldColorAdjustment(const ColorAdjustment &adjustment) {
+        const double yuv2rgb[3][3] = {
+                {Coefficients::kY, 0, Coefficients::kRV},
+                {Coefficients::kY, Coefficients::kGU, Coefficients::kGV},
+                {Coefficients::kY, Coefficients::kBU, 0}};
+        const double offset = 1024.0 * (128.0 * (1.0 - adjustment.contrast) +
+                                        adjustment.brightness);
+        ColorTransform transform;
+        transform.yOffset = Coefficients::kYOffset;
+        for (int c = 0; c < 3; c++) {
+            double m[3] = {0.0, 0.0, 0.0};
+            for (int k = 0; k < 3; k++) {
+                const double w = static_cast<double>(adjustment.contrast) *
+                                 adjustment.matrix[c * 3 + k] * adjustment.gains[k];
+                for (int j = 0; j < 3; j++) {
+                    m[j] += w * yuv2rgb[k][j];
+                }
+            }
+            transform.y[c] = toTransformCoefficient(m[0]);
+            transform.u[c] = toTransformCoefficient(m[1] * adjustment.saturation);
+            transform.v[c] = toTransformCoefficient(m[2] * adjustment.saturation);
+            transform.offset[c] = static_cast<int>(lround(offset));
+        }
+        return transform;
+    }
+
+    template<class Layout, class Output, class Frame>
+    static inline void YUV420ToRGBA(const Frame &frame, unsigned char *dst, int pack) {
+        const bool fast = sConvertPrecision == CONVERT_PRECISION_FAST;
+        const bool table = sConvertEngine == CONVERT_ENGINE_TABLE;
+        ColorAdjustment adjustment;
+        const bool adjusted = getColorAdjustment(&adjustment);
+        withColorCoefficients(sColorMatrix, sColorRange, [&](auto coefficients) {
+            typedef decltype(coefficients) Coefficients;
+            if (adjusted) {
+                const TransformEngine engine(foldColorAdjustment<Coefficients>(adjustment));
+                YUV420ToRGBA<Layout, Output>(frame, engine, dst, pack);
+            } else if (fast) {
+                YUV420ToRGBA<Layout, Output>(frame, FastEngine<Coefficients>(), dst, pack);
+            } else if (table) {
+                YUV420ToRGBA<Layout, Output>(frame, TableEngine<Coefficients>(), dst, pack);
+            } else {
+                YUV420ToRGBA<Layout, Output>(frame, ArithmeticEngine<Coefficients>(), dst, pack);
+            }
+        });
+    }
+
+/*
+ * Pick the layout from the strides. Two chroma planes with pixel stride 2 one
+ * byte apart are an interleaved NV12 or NV21 plane, e.g. the u and v planes of
+ * an android.media.Image in YUV_420_888.
+ */
+    template<class Output>
+    static void
+    YUV420FrameToRGBA(const YUV420Frame<unsigned char> &frame, unsigned char *dst, int pack) {
+        if (frame.uvPixelStride == 1) {
+            YUV420ToRGBA<PlanarLayout, Output>(frame, dst, pack);
+        } else if (frame.uvPixelStride == 2 && frame.v == frame.u + 1) {
+            YUV420ToRGBA<NV12Layout, Output>(frame, dst, pack);
+        } else if (frame.uvPixelStride == 2 && frame.u == frame.v + 1) {
+            YUV420ToRGBA<NV21Layout, Output>(frame, dst, pack);
+        } else {
+            YUV420ToRGBA<StridedPlanarLayout, Output>(frame, dst, pack);
+        }
+    }
+
+/*
+ * The planes of a YUV420P buffer are stored one after another:
+ * height rows of yRowStride, then (height + 1) / 2 rows of uvRowStride for
+ * each chroma plane.
+ */
+    template<class Output>
+    static inline void
+    YUV420PToRGBA(const unsigned char *src, unsigned char *dst, int width, int height,
+                  int yRowStride, int uvRowStride, int uvPixelStride, int format, int pack) {
+        const unsigned char *pFirstUV = src + yRowStride * height;
+        const unsigned char *pSecondUV = pFirstUV + uvRowStride * ((height + 1) / 2);
+        YUV420Frame<unsigned char> frame;
+        frame.y = src;
+        frame.u = format == YUV420P_I420 ? pFirstUV : pSecondUV;
+        frame.v = format == YUV420P_I420 ? pSecondUV : pFirstUV;
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = uvPixelStride;
+        YUV420FrameToRGBA<Output>(frame, dst, pack);
+    }
+
+    template<class Output>
+    static inline void
+    YUV420SPToRGBA(const unsigned char *src, unsigned char *dst, int width, int height,
+                   int yRowStride, int uvRowStride, int format, int pack) {
+        const unsigned char *pUV = src + yRowStride * height;
+        YUV420Frame<unsigned char> frame;
+        frame.y = src;
+        frame.u = pUV + (format == YUV420SP_NV12 ? 0 : 1);
+        frame.v = pUV + (format == YUV420SP_NV12 ? 1 : 0);
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = 2;
+        if (format == YUV420SP_NV12) {
+            YUV420ToRGBA<NV12Layout, Output>(frame, dst, pack);
+        } else {
+            YUV420ToRGBA<NV21Layout, Output>(frame, dst, pack);
+        }
+    }
+
+/*
+ * 4:2:2 and 4:4:4 frames have a chroma row per luma row, so each chroma plane
+ * is height rows of uvRowStride.
+ */
+    template<class Layout, class Output>
+    static inline void
+    YUVChromaRowsToRGBA(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int pack) {
+        YUV420Frame<unsigned char> frame;
+        frame.y = src;
+        frame.u = src + yRowStride * height;
+        frame.v = Layout::kPixelStride == 2 ? frame.u + 1 : frame.u + uvRowStride * height;
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = Layout::kPixelStride;
+        YUV420ToRGBA<Layout, Output>(frame, dst, pack);
+    }
+
+    template<int kPacked, class Output>
+    static inline void
+    YUV422PackedToRGBA(const unsigned char *src, unsigned char *dst, int width, int height,
+                       int rowStride, int pack) {
+        YUV422PackedFrame frame;
+        frame.src = src;
+        frame.width = width;
+        frame.height = height;
+        frame.rowStride = rowStride;
+        YUV420ToRGBA<PackedLayout<kPacked>, Output>(frame, dst, pack);
+    }
+
+/*
+ * 10-bit frames are converted into RGBA16Output rows by a Transform10Engine,
+ * with the color adjustments if they are set. The bilinear chroma of 10-bit
+ * frames is blended in C, the blend kernels are 8-bit only.
+ */
+    template<class Layout, int kShift>
+    static void
+    YUV420P10ToRGBA(const YUV420Frame<uint16_t> &frame, unsigned char *dst, int pack) {
+        ColorAdjustment adjustment;
+        if (!getColorAdjustment(&adjustment)) {
+            adjustment = kIdentityColorAdjustment;
+        }
+        withColorCoefficients(sColorMatrix, sColorRange, [&](auto coefficients) {
+            typedef decltype(coefficients) Coefficients;
+            const Transform10Engine<kShift> engine(foldColorAdjustment<Coefficients>(adjustment));
+            YUV420ToRGBA<Layout, RGBA16Output>(frame, engine, dst, pack | PACK_ROW16);
+        });
+    }
+
+    static void I010ToRGBA(const uint16_t *src, unsigned char *dst, int width, int height,
+                           int yRowStride, int uvRowStride, int pack) {
+        YUV420Frame<uint16_t> frame;
+        frame.y = src;
+        frame.u = src + yRowStride * height;
+        frame.v = frame.u + uvRowStride * ((height + 1) / 2);
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = 1;
+        YUV420P10ToRGBA<PlanarLayout, 0>(frame, dst, pack);
+    }
+
+    static void P010ToRGBA(const uint16_t *src, unsigned char *dst, int width, int height,
+                           int yRowStride, int uvRowStride, int pack) {
+        YUV420Frame<uint16_t> frame;
+        frame.y = src;
+        frame.u = src + yRowStride * height;
+        frame.v = frame.u + 1;
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = 2;
+        YUV420P10ToRGBA<NV12Layout, 6>(frame, dst, pack);
+    }
+
+    template<class Output>
+    static inline void
+    YUV420PlanesToRGBA(const unsigned char *srcY, const unsigned char *srcU,
+                       const unsigned char *srcV, unsigned char *dst, int width, int height,
+                       int yRowStride, int uvRowStride, int uvPixelStride) {
+        YUV420Frame<unsigned char> frame;
+        frame.y = srcY;
+        frame.u = srcU;
+        frame.v = srcV;
+        frame.width = width;
+        frame.height = height;
+        frame.yRowStride = yRowStride;
+        frame.uvRowStride = uvRowStride;
+        frame.uvPixelStride = uvPixelStride;
+        YUV420FrameToRGBA<Output>(frame, dst, ROW_PACK_NONE);
+    }
+
+    void setConvertEngine(int engine) {
+        if (engine == CONVERT_ENGINE_ARITHMETIC || engine == CONVERT_ENGINE_TABLE) {
+            sConvertEngine = engine;
+        }
+    }
+
+    int getConvertEngine() {
+        return sConvertEngine;
+    }
+
+    void setConvertPrecision(int precision) {
+        if (precision == CONVERT_PRECISION_EXACT || precision == CONVERT_PRECISION_FAST) {
+            sConvertPrecision = precision;
+        }
+    }
+
+    int getConvertPrecision() {
+        return sConvertPrecision;
+    }
+
+    void setConvertThreads(int threads) {
+        //more threads than cpus only add context switches
+        const int cpuCount = getCpuCount();
+        threads = threads > cpuCount ? cpuCount : threads;
+        sConvertThreads = threads < 0 ? CONVERT_THREADS_AUTO : threads;
+    }
+
+    int getConvertThreads() {
+        return sConvertThreads;
+    }
+
+    void setChromaUpsampling(int upsampling) {
+        if (upsampling == CHROMA_UPSAMPLING_NEAREST || upsampling == CHROMA_UPSAMPLING_BILINEAR) {
+            sChromaUpsampling = upsampling;
+        }
+    }
+
+    int getChromaUpsampling() {
+        return sChromaUpsampling;
+    }
+
+    void setColorSpace(int matrix, int range) {
+        if ((matrix == COLOR_MATRIX_BT601 || matrix == COLOR_MATRIX_BT709 ||
+             matrix == COLOR_MATRIX_BT2020) &&
+            (range == COLOR_RANGE_LIMITED || range == COLOR_RANGE_FULL)) {
+            sColorMatrix = matrix;
+            sColorRange = range;
+        }
+    }
+
+    int getColorMatrix() {
+        return sColorMatrix;
+    }
+
+    int getColorRange() {
+        return sColorRange;
+    }
+
+    static inline bool isChannelOrder(int order) {
+        return order == CHANNEL_ORDER_RGBA || order == CHANNEL_ORDER_BGRA ||
+               order == CHANNEL_ORDER_ARGB || order == CHANNEL_ORDER_ABGR;
+    }
+
+    void setChannelOrder(int order) {
+        if (isChannelOrder(order)) {
+            sChannelOrder = order;
+        }
+    }
 
-        nR = nR > K_MAX_CHANNEL_VALUE ? K_MAX_CHANNEL_VALUE : (nR < 0 ? 0 : nR);
-        nG = nG > K_MAX_CHANNEL_VALUE ? K_MAX_CHANNEL_VALUE : (nG < 0 ? 0 : nG);
-        nB = nB > K_MAX_CHANNEL_VALUE ? K_MAX_CHANNEL_VALUE : (nB < 0 ? 0 : nB);
+    int getChannelOrder() {
+        return sChannelOrder;
+    }
 
-        nR = (nR >> 10) & 0xff;
-        nG = (nG >> 10) & 0xff;
-        nB = (nB >> 10) & 0xff;
-        return 0xff000000 | (nR << 16) | (nG << 8) | nB;
+    void setColorAdjustment(const float *whiteBalanceGains, const float *colorCorrectionMatrix,
+                            float brightness, float contrast, float saturation) {
+        ColorAdjustment adjustment;
+        bool valid = isfinite(brightness) && isfinite(contrast) && isfinite(saturation);
+        for (int i = 0; i < 3; i++) {
+            adjustment.gains[i] = whiteBalanceGains ? whiteBalanceGains[i] : 1.0f;
+            valid = valid && isfinite(adjustment.gains[i]);
+        }
+        for (int i = 0; i < 9; i++) {
+            const float identity = i % 4 == 0 ? 1.0f : 0.0f;
+            adjustment.matrix[i] = colorCorrectionMatrix ? colorCorrectionMatrix[i] : identity;
+            valid = valid && isfinite(adjustment.matrix[i]);
+        }
+        //bounded so the folded offset fits an int
+        brightness = brightness > 255.0f ? 255.0f : (brightness < -255.0f ? -255.0f : brightness);
+        contrast = contrast > 16.0f ? 16.0f : (contrast < -16.0f ? -16.0f : contrast);
+        adjustment.brightness = brightness;
+        adjustment.contrast = contrast;
+        adjustment.saturation = saturation;
+        if (valid) {
+            std::lock_guard<std::mutex> lock(sColorAdjustmentMutex);
+            sColorAdjustment = adjustment;
+            sColorAdjusted = true;
+        }
     }
 
-/*
- * int  order: ARGB
- * byte order: RGBA
- */
-    static inline void rgbaIntToBytes(int rgba, unsigned char *b) {
-        b[0] = (unsigned char) ((rgba >> 16) & 0xff);  //R
-        b[1] = (unsigned char) ((rgba >> 8) & 0xff);   //G
-        b[2] = (unsigned char) (rgba & 0xff);          //B
-        b[3] = (unsigned char) ((rgba >> 24) & 0xff);  //A
+    void clearColorAdjustment() {
+        std::lock_guard<std::mutex> lock(sColorAdjustmentMutex);
+        sColorAdjusted = false;
     }
 
     void YUV420PToRGBAByte(unsigned char *src, unsigned char *dst, int width, int height,
-                           int yRowStride, int uvRowStride, int uvPixelStride, int format) {
+                           int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                           int channelOrder) {
         if (format == YUV420P_I420 || format == YUV420P_YV12) {
-            unsigned char *pRGBA = dst;
-            unsigned char *pY = src;
-            unsigned char *pU;
-            unsigned char *pV;
-            if (format == YUV420P_I420) {
-                pU = src + width * height;
-                pV = src + width * height / 4 * 5;
-            } else {
-                pU = src + width * height / 4 * 5;
-                pV = src + width * height;
-            }
-            for (int y = 0; y < height; y++) {
-                //const int yRowStart = yRowStride * y;
-                const int uvRowStart = uvRowStride * (y >> 1);
-                for (int x = 0; x < width; x++) {
-                    const int uvRowOffset = (x >> 1) * uvPixelStride;
-                    rgbaIntToBytes(YUV2RGBA(*pY++,//pY[yRowStart + x],
-                                            pU[uvRowStart + uvRowOffset],
-                                            pV[uvRowStart + uvRowOffset]),
-                                   pRGBA);
-                    pRGBA += 4;
-                }
-            }
+            withRowOutput(channelOrder, [&](auto order) {
+                YUV420PToRGBA<ByteOutput<decltype(order)::value>>(
+                        src, dst, width, height, yRowStride, uvRowStride, uvPixelStride, format,
+                        ROW_PACK_NONE);
+            });
         }
     }
 
     void YUV420PToRGBAInt(unsigned char *src, int *dst, int width, int height,
                           int yRowStride, int uvRowStride, int uvPixelStride, int format) {
         if (format == YUV420P_I420 || format == YUV420P_YV12) {
-            unsigned char *pY = src;
-            unsigned char *pU;
-            unsigned char *pV;
-            int rgbaIndex = 0;
-            if (format == YUV420P_I420) {
-                pU = src + width * height;
-                pV = src + width * height / 4 * 5;
-            } else {
-                pU = src + width * height / 4 * 5;
-                pV = src + width * height;
-            }
-            for (int y = 0; y < height; y++) {
-                //const int yRowStart = yRowStride * y;
-                const int uvRowStart = uvRowStride * (y >> 1);
-                for (int x = 0; x < width; x++) {
-                    const int uvRowOffset = (x >> 1) * uvPixelStride;
-                    dst[rgbaIndex++] = YUV2RGBA(*pY++,//pY[yRowStart + x],
-                                                 pU[uvRowStart + uvRowOffset],
-                                                pV[uvRowStart + uvRowOffset]);
-                }
-            }
+            YUV420PToRGBA<ARGBIntOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                         height, yRowStride, uvRowStride, uvPixelStride, format,
+                                         ROW_PACK_NONE);
         }
     }
 
     void YUV420SPToRGBAByte(unsigned char *src, unsigned char *dst, int width, int height,
-                            int format) {
+                            int yRowStride, int uvRowStride, int format, int channelOrder) {
         if (format == YUV420SP_NV12 || format == YUV420SP_NV21) {
-            unsigned char *pRGBA = dst;
-            unsigned char *pY = src;
-            unsigned char *pUV = src + width * height;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int uvOffset = (y >> 1) * width + 2 * (x >> 1);
-                    int uOffset;
-                    int vOffset;
-                    if (format == YUV420SP_NV12) {
-                        uOffset = uvOffset;
-                        vOffset = uvOffset + 1;
-                    } else {
-                        uOffset = uvOffset + 1;
-                        vOffset = uvOffset;
-                    }
-                    rgbaIntToBytes(YUV2RGBA(*pY++, pUV[uOffset], pUV[vOffset]), pRGBA);
-                    pRGBA += 4;
-                }
-            }
+            withRowOutput(channelOrder, [&](auto order) {
+                YUV420SPToRGBA<ByteOutput<decltype(order)::value>>(
+                        src, dst, width, height, yRowStride, uvRowStride, format, ROW_PACK_NONE);
+            });
         }
     }
 
     void YUV420SPToRGBAInt(unsigned char *src, int *dst, int width, int height,
-                           int format) {
+                           int yRowStride, int uvRowStride, int format) {
         if (format == YUV420SP_NV12 || format == YUV420SP_NV21) {
-            unsigned char *pY = src;
-            unsigned char *pUV = src + width * height;
-            int rgbaIndex = 0;
-            for (int y = 0; y < height; y++) {
-                for (int x = 0; x < width; x++) {
-                    int uvOffset = (y >> 1) * width + 2 * (x >> 1);
-                    int uOffset;
-                    int vOffset;
-                    if (format == YUV420SP_NV12) {
-                        uOffset = uvOffset;
-                        vOffset = uvOffset + 1;
-                    } else {
-                        uOffset = uvOffset + 1;
-                        vOffset = uvOffset;
-                    }
-                    dst[rgbaIndex++] = YUV2RGBA(*pY++, pUV[uOffset], pUV[vOffset]);
-                }
-            }
+            YUV420SPToRGBA<ARGBIntOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                          height, yRowStride, uvRowStride, format,
+                                          ROW_PACK_NONE);
         }
     }
 
-    static inline void
-    rotateYUV420P90(unsigned char *srcY, unsigned char *srcU, unsigned char *srcV,
-                    unsigned char *dstY, unsigned char *dstU, unsigned char *dstV,
-                    int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = x * height + height - y - 1;
-                dstY[dstIndex] = srcY[srcIndex++];
-            }
+    void YUV420PToRGB565(unsigned char *src, unsigned char *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                         bool dither) {
+        if (format == YUV420P_I420 || format == YUV420P_YV12) {
+            YUV420PToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                          uvPixelStride, format,
+                                          dither ? ROW_PACK_RGB565_DITHER : ROW_PACK_RGB565);
+        }
+    }
+
+    void YUV420SPToRGB565(unsigned char *src, unsigned char *dst, int width, int height,
+                          int yRowStride, int uvRowStride, int format, bool dither) {
+        if (format == YUV420SP_NV12 || format == YUV420SP_NV21) {
+            YUV420SPToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                           format,
+                                           dither ? ROW_PACK_RGB565_DITHER : ROW_PACK_RGB565);
+        }
+    }
+
+    void YUV420PToRGB24(unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int uvPixelStride, int format) {
+        if (format == YUV420P_I420 || format == YUV420P_YV12) {
+            YUV420PToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                          uvPixelStride, format, ROW_PACK_RGB24);
+        }
+    }
+
+    void YUV420SPToRGB24(unsigned char *src, unsigned char *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int format) {
+        if (format == YUV420SP_NV12 || format == YUV420SP_NV21) {
+            YUV420SPToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                           format, ROW_PACK_RGB24);
+        }
+    }
+
+    void YUV420PToGray(unsigned char *src, unsigned char *dst, int width, int height,
+                       int yRowStride, int uvRowStride, int uvPixelStride, int format) {
+        if (format == YUV420P_I420 || format == YUV420P_YV12) {
+            YUV420PToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                          uvPixelStride, format, ROW_PACK_GRAY);
+        }
+    }
+
+    void YUV420SPToGray(unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int format) {
+        if (format == YUV420SP_NV12 || format == YUV420SP_NV21) {
+            YUV420SPToRGBA<RGBAPackOutput>(src, dst, width, height, yRowStride, uvRowStride,
+                                           format, ROW_PACK_GRAY);
+        }
+    }
+
+    static inline bool isLinearize(int linearize) {
+        return linearize == LINEARIZE_NONE || linearize == LINEARIZE_SRGB ||
+               linearize == LINEARIZE_BT1886;
+    }
+
+    void YUV420PToRGBAFloat(unsigned char *src, float *dst, int width, int height,
+                            int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                            int linearize) {
+        if ((format == YUV420P_I420 || format == YUV420P_YV12) && isLinearize(linearize)) {
+            YUV420PToRGBA<RGBAPackOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                          height, yRowStride, uvRowStride, uvPixelStride, format,
+                                          PACK_RGBA_FLOAT | linearize);
+        }
+    }
+
+    void YUV420SPToRGBAFloat(unsigned char *src, float *dst, int width, int height,
+                             int yRowStride, int uvRowStride, int format, int linearize) {
+        if ((format == YUV420SP_NV12 || format == YUV420SP_NV21) && isLinearize(linearize)) {
+            YUV420SPToRGBA<RGBAPackOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                           height, yRowStride, uvRowStride, format,
+                                           PACK_RGBA_FLOAT | linearize);
+        }
+    }
+
+    void YUV420PToRGBAHalf(unsigned char *src, uint16_t *dst, int width, int height,
+                           int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                           int linearize) {
+        if ((format == YUV420P_I420 || format == YUV420P_YV12) && isLinearize(linearize)) {
+            YUV420PToRGBA<RGBAPackOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                          height, yRowStride, uvRowStride, uvPixelStride, format,
+                                          PACK_RGBA_HALF | linearize);
+        }
+    }
+
+    void YUV420SPToRGBAHalf(unsigned char *src, uint16_t *dst, int width, int height,
+                            int yRowStride, int uvRowStride, int format, int linearize) {
+        if ((format == YUV420SP_NV12 || format == YUV420SP_NV21) && isLinearize(linearize)) {
+            YUV420SPToRGBA<RGBAPackOutput>(src, reinterpret_cast<unsigned char *>(dst), width,
+                                           height, yRowStride, uvRowStride, format,
+                                           PACK_RGBA_HALF | linearize);
+        }
+    }
+
+    void I010ToRGBAByte(const uint16_t *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder) {
+        I010ToRGBA(src, dst, width, height, yRowStride, uvRowStride,
+                   ROW_PACK16_BYTES +
+                   (isChannelOrder(channelOrder) ? channelOrder : CHANNEL_ORDER_RGBA));
+    }
+
+    void I010ToRGBA1010102(const uint16_t *src, int *dst, int width, int height,
+                           int yRowStride, int uvRowStride) {
+        I010ToRGBA(src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                   uvRowStride, ROW_PACK16_RGBA1010102);
+    }
+
+    void I010ToRGBAHalf(const uint16_t *src, uint16_t *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int linearize) {
+        if (isLinearize(linearize)) {
+            I010ToRGBA(src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                       uvRowStride, PACK_RGBA_HALF | linearize);
+        }
+    }
+
+    void P010ToRGBAByte(const uint16_t *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder) {
+        P010ToRGBA(src, dst, width, height, yRowStride, uvRowStride,
+                   ROW_PACK16_BYTES +
+                   (isChannelOrder(channelOrder) ? channelOrder : CHANNEL_ORDER_RGBA));
+    }
+
+    void P010ToRGBA1010102(const uint16_t *src, int *dst, int width, int height,
+                           int yRowStride, int uvRowStride) {
+        P010ToRGBA(src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                   uvRowStride, ROW_PACK16_RGBA1010102);
+    }
+
+    void P010ToRGBAHalf(const uint16_t *src, uint16_t *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int linearize) {
+        if (isLinearize(linearize)) {
+            P010ToRGBA(src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                       uvRowStride, PACK_RGBA_HALF | linearize);
         }
+    }
+
+    void I422ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUVChromaRowsToRGBA<Layout422<PlanarLayout>, ByteOutput<decltype(order)::value>>(
+                    src, dst, width, height, yRowStride, uvRowStride, ROW_PACK_NONE);
+        });
+    }
+
+    void I422ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride) {
+        YUVChromaRowsToRGBA<Layout422<PlanarLayout>, ARGBIntOutput>(
+                src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                uvRowStride, ROW_PACK_NONE);
+    }
+
+    void NV16ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUVChromaRowsToRGBA<Layout422<NV12Layout>, ByteOutput<decltype(order)::value>>(
+                    src, dst, width, height, yRowStride, uvRowStride, ROW_PACK_NONE);
+        });
+    }
+
+    void NV16ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride) {
+        YUVChromaRowsToRGBA<Layout422<NV12Layout>, ARGBIntOutput>(
+                src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                uvRowStride, ROW_PACK_NONE);
+    }
+
+    void I444ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUVChromaRowsToRGBA<I444Layout, ByteOutput<decltype(order)::value>>(
+                    src, dst, width, height, yRowStride, uvRowStride, ROW_PACK_NONE);
+        });
+    }
+
+    void I444ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride) {
+        YUVChromaRowsToRGBA<I444Layout, ARGBIntOutput>(
+                src, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                uvRowStride, ROW_PACK_NONE);
+    }
+
+    void YUY2ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int rowStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUV422PackedToRGBA<ROW_PACKED_YUY2, ByteOutput<decltype(order)::value>>(
+                    src, dst, width, height, rowStride, ROW_PACK_NONE);
+        });
+    }
+
+    void YUY2ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int rowStride) {
+        YUV422PackedToRGBA<ROW_PACKED_YUY2, ARGBIntOutput>(
+                src, reinterpret_cast<unsigned char *>(dst), width, height, rowStride,
+                ROW_PACK_NONE);
+    }
+
+    void UYVYToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int rowStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUV422PackedToRGBA<ROW_PACKED_UYVY, ByteOutput<decltype(order)::value>>(
+                    src, dst, width, height, rowStride, ROW_PACK_NONE);
+        });
+    }
+
+    void UYVYToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int rowStride) {
+        YUV422PackedToRGBA<ROW_PACKED_UYVY, ARGBIntOutput>(
+                src, reinterpret_cast<unsigned char *>(dst), width, height, rowStride,
+                ROW_PACK_NONE);
+    }
+
+    void YUV420ToRGBAByte(const unsigned char *srcY, const unsigned char *srcU,
+                          const unsigned char *srcV, unsigned char *dst, int width, int height,
+                          int yRowStride, int uvRowStride, int uvPixelStride, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            YUV420PlanesToRGBA<ByteOutput<decltype(order)::value>>(
+                    srcY, srcU, srcV, dst, width, height, yRowStride, uvRowStride, uvPixelStride);
+        });
+    }
+
+    void YUV420ToRGBAInt(const unsigned char *srcY, const unsigned char *srcU,
+                         const unsigned char *srcV, int *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int uvPixelStride) {
+        YUV420PlanesToRGBA<ARGBIntOutput>(srcY, srcU, srcV,
+                                          reinterpret_cast<unsigned char *>(dst), width, height,
+                                          yRowStride, uvRowStride, uvPixelStride);
+    }
 
-        //rotate uv
-        int uvHeight = height / 2;
-        int uvWidth = width / 2;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = x * uvHeight + uvHeight - y - 1;
-                dstU[dstUVIndex] = srcU[srcUVIndex];
-                dstV[dstUVIndex] = srcV[srcUVIndex];
-                srcUVIndex++;
+/*
+ * The ROW_LUMA_* outputs of native_row.h from column x to the end of the row,
+ * bit-exact with the luma kernels.
+ */
+    static void lumaRow(const unsigned char *srcY, unsigned char *dst, int x, int width,
+                        int luma) {
+        for (; x < width; x++) {
+            int y = srcY[x];
+            if (luma & ROW_LUMA_EXPAND) {
+                y = y > 16 ? (298 * (y - 16)) >> 8 : 0;
+                y = y > 255 ? 255 : y;
+            }
+            if (luma & ROW_LUMA_ALPHA_FIRST) {
+                storeWord(dst + x * 4, 0xffu | static_cast<unsigned int>(y) * 0x01010100u);
+            } else if (luma & ROW_LUMA_RGBA) {
+                storeWord(dst + x * 4, 0xff000000u | static_cast<unsigned int>(y) * 0x010101u);
+            } else {
+                dst[x] = static_cast<unsigned char>(y);
             }
         }
     }
 
-    static inline void
-    rotateYUV420P180(unsigned char *srcY, unsigned char *srcU, unsigned char *srcV,
-                     unsigned char *dstY, unsigned char *dstU, unsigned char *dstV,
-                     int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
+/*
+ * Only the Y plane is read, so the cost is one pass over it and dst, the
+ * chroma planes are never touched.
+ */
+    static void lumaToOutput(const unsigned char *srcY, unsigned char *dst, int width,
+                             int height, int yRowStride, int luma) {
+        if (luma == ROW_LUMA_GRAY && yRowStride == width) {
+            memcpy(dst, srcY, static_cast<size_t>(width) * height);
+            return;
+        }
+        int step = 0;
+        const LumaRowFunc simdRow = luma == ROW_LUMA_GRAY ? nullptr : selectLumaRow(luma, &step);
+        const int simdWidth = simdRow ? width & ~(step - 1) : 0;
+        const int dstRowStride = luma & ROW_LUMA_RGBA ? width * 4 : width;
         for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = (height - y - 1) * width + width - x - 1;
-                dstY[dstIndex] = srcY[srcIndex++];
+            const unsigned char *pY = srcY + y * yRowStride;
+            unsigned char *pDst = dst + y * dstRowStride;
+            if (luma == ROW_LUMA_GRAY) {
+                memcpy(pDst, pY, width);
+                continue;
+            }
+            if (simdRow) {
+                simdRow(pY, pDst, simdWidth);
             }
+            lumaRow(pY, pDst, simdWidth, width, luma);
         }
+    }
 
-        //rotate uv
-        int uvHeight = height / 2;
-        int uvWidth = width / 2;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = (uvHeight - y - 1) * uvWidth + uvWidth - x - 1;
-                dstU[dstUVIndex] = srcU[srcUVIndex];
-                dstV[dstUVIndex] = srcV[srcUVIndex];
-                srcUVIndex++;
-            }
+    void lumaToGray(const unsigned char *srcY, unsigned char *dst, int width, int height,
+                    int yRowStride, bool expandRange) {
+        lumaToOutput(srcY, dst, width, height, yRowStride,
+                     expandRange ? ROW_LUMA_EXPAND : ROW_LUMA_GRAY);
+    }
+
+    void lumaToRGBAByte(const unsigned char *srcY, unsigned char *dst, int width, int height,
+                        int yRowStride, bool expandRange, int channelOrder) {
+        const bool alphaFirst = channelOrder == CHANNEL_ORDER_ARGB ||
+                                channelOrder == CHANNEL_ORDER_ABGR;
+        lumaToOutput(srcY, dst, width, height, yRowStride,
+                     ROW_LUMA_RGBA | (alphaFirst ? ROW_LUMA_ALPHA_FIRST : 0) |
+                     (expandRange ? ROW_LUMA_EXPAND : 0));
+    }
+
+    void lumaToRGBAInt(const unsigned char *srcY, int *dst, int width, int height,
+                       int yRowStride, bool expandRange) {
+        lumaToOutput(srcY, reinterpret_cast<unsigned char *>(dst), width, height, yRowStride,
+                     ROW_LUMA_RGBA | (expandRange ? ROW_LUMA_EXPAND : 0));
+    }
+
+/*
+ * RGBA to YUV from column x to the end of the row, bit-exact with the
+ * RGBAToYRowFunc and RGBAToUVRowFunc kernels of native_row.h. The last 2x2
+ * block of an odd width is one column wide and averages it with itself.
+ */
+    template<int kInput, class Coefficients>
+    static void rgbaToYRow(const unsigned char *src, unsigned char *dstY, int x, int width) {
+        typedef RowOutputOrder<kInput> Order;
+        typedef Coefficients C;
+        for (; x < width; x++) {
+            const unsigned char *p = src + x * 4;
+            dstY[x] = static_cast<unsigned char>(
+                    (C::kYR * p[Order::kR] + C::kYG * p[Order::kG] + C::kYB * p[Order::kB] +
+                     (C::kYOffset << 8) + 128) >> 8);
         }
     }
 
-    static inline void
-    rotateYUV420P270(unsigned char *srcY, unsigned char *srcU, unsigned char *srcV,
-                     unsigned char *dstY, unsigned char *dstU, unsigned char *dstV,
-                     int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = (width - x - 1) * height + y;
-                dstY[dstIndex] = srcY[srcIndex++];
+    template<int kInput, class Coefficients>
+    static void rgbaToUVRow(const unsigned char *src0, const unsigned char *src1,
+                            unsigned char *dstU, unsigned char *dstV, int uvPixelStride, int x,
+                            int width) {
+        typedef RowOutputOrder<kInput> Order;
+        typedef Coefficients C;
+        for (; x < width; x += 2) {
+            const unsigned char *p0 = src0 + x * 4;
+            const unsigned char *p1 = src1 + x * 4;
+            const int next = x + 1 < width ? 4 : 0;
+            const int r = (p0[Order::kR] + p0[Order::kR + next] + p1[Order::kR] +
+                           p1[Order::kR + next] + 2) >> 2;
+            const int g = (p0[Order::kG] + p0[Order::kG + next] + p1[Order::kG] +
+                           p1[Order::kG + next] + 2) >> 2;
+            const int b = (p0[Order::kB] + p0[Order::kB + next] + p1[Order::kB] +
+                           p1[Order::kB + next] + 2) >> 2;
+            const int offset = (x >> 1) * uvPixelStride;
+            dstU[offset] = static_cast<unsigned char>(
+                    (C::kUR * r + C::kUG * g + C::kUB * b + RGB_TO_UV_OFFSET) >> 8);
+            dstV[offset] = static_cast<unsigned char>(
+                    (C::kVR * r + C::kVG * g + C::kVB * b + RGB_TO_UV_OFFSET) >> 8);
+        }
+    }
+
+/*
+ * Writes rows of pixels into a packed YUV420 frame, two rows per chroma row,
+ * the last row of an odd height is its own pair.
+ */
+    template<int kInput, class Coefficients>
+    class RGBAToYUV420Writer {
+    public:
+        RGBAToYUV420Writer(unsigned char *dst, int width, int height, int format)
+                : mDst(dst), mWidth(width), mHeight(height), mYRow(nullptr), mUVRow(nullptr),
+                  mYSimdWidth(0), mUVSimdWidth(0) {
+            const int uvWidth = (width + 1) / 2;
+            const bool planar = format == YUV420P_I420 || format == YUV420P_YV12;
+            unsigned char *pFirstUV = dst + width * height;
+            unsigned char *pSecondUV = pFirstUV + uvWidth * ((height + 1) / 2);
+            mU = pFirstUV;
+            mV = pSecondUV;
+            int chroma = ROW_CHROMA_PLANAR;
+            if (format == YUV420P_YV12) {
+                mU = pSecondUV;
+                mV = pFirstUV;
+            } else if (format == YUV420SP_NV12) {
+                mV = pFirstUV + 1;
+                chroma = ROW_CHROMA_NV12;
+            } else if (format == YUV420SP_NV21) {
+                mU = pFirstUV + 1;
+                mV = pFirstUV;
+                chroma = ROW_CHROMA_NV21;
+            }
+            mUVPixelStride = planar ? 1 : 2;
+            mUVRowStride = uvWidth * mUVPixelStride;
+
+            int yStep = 0;
+            int uvStep = 0;
+            mYRow = selectRGBAToYRow(kInput, Coefficients::kMatrix, Coefficients::kRange, &yStep);
+            mUVRow = selectRGBAToUVRow(chroma, kInput, Coefficients::kMatrix,
+                                       Coefficients::kRange, &uvStep);
+            mYSimdWidth = mYRow ? width & ~(yStep - 1) : 0;
+            mUVSimdWidth = mUVRow ? width & ~(uvStep - 1) : 0;
+        }
+
+        //rows y and y + 1 from src0 and src1, src1 is src0 for the last row of an odd height
+        void write(const unsigned char *src0, const unsigned char *src1, int y) const {
+            for (int row = y; row < y + 2 && row < mHeight; row++) {
+                const unsigned char *pSrc = row == y ? src0 : src1;
+                unsigned char *pY = mDst + row * mWidth;
+                if (mYRow) {
+                    mYRow(pSrc, pY, mYSimdWidth);
+                }
+                rgbaToYRow<kInput, Coefficients>(pSrc, pY, mYSimdWidth, mWidth);
+            }
+            unsigned char *pRowU = mU + (y >> 1) * mUVRowStride;
+            unsigned char *pRowV = mV + (y >> 1) * mUVRowStride;
+            if (mUVRow) {
+                mUVRow(src0, src1, pRowU, pRowV, mUVSimdWidth);
             }
+            rgbaToUVRow<kInput, Coefficients>(src0, src1, pRowU, pRowV, mUVPixelStride,
+                                              mUVSimdWidth, mWidth);
         }
 
-        //rotate uv
-        int uvHeight = height / 2;
-        int uvWidth = width / 2;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = (uvWidth - x - 1) * uvHeight + y;
-                dstU[dstUVIndex] = srcU[srcUVIndex];
-                dstV[dstUVIndex] = srcV[srcUVIndex];
-                srcUVIndex++;
+    private:
+        unsigned char *const mDst;
+        const int mWidth;
+        const int mHeight;
+        unsigned char *mU;
+        unsigned char *mV;
+        int mUVPixelStride;
+        int mUVRowStride;
+        RGBAToYRowFunc mYRow;
+        RGBAToUVRowFunc mUVRow;
+        int mYSimdWidth;
+        int mUVSimdWidth;
+    };
+
+/*
+ * The bands of forEachBand start on even rows, so each band writes its own
+ * chroma rows.
+ */
+    template<int kInput, class Coefficients>
+    static void RGBAToYUV420(const unsigned char *src, unsigned char *dst, int width, int height,
+                             int format) {
+        const RGBAToYUV420Writer<kInput, Coefficients> writer(dst, width, height, format);
+        const int srcRowStride = width * 4;
+        forEachBand(width, height, [&](int yBegin, int yEnd) {
+            for (int y = yBegin; y < yEnd; y += 2) {
+                const unsigned char *pSrc0 = src + y * srcRowStride;
+                const unsigned char *pSrc1 = y + 1 < height ? pSrc0 + srcRowStride : pSrc0;
+                writer.write(pSrc0, pSrc1, y);
             }
+        });
+    }
+
+    template<int kInput>
+    static inline void RGBAToYUV420(const unsigned char *src, unsigned char *dst, int width,
+                                    int height, int format) {
+        if (format < YUV420P_I420 || format > YUV420SP_NV21) {
+            return;
         }
+        withColorCoefficients(sColorMatrix, sColorRange, [&](auto coefficients) {
+            typedef decltype(coefficients) C;
+            RGBAToYUV420<kInput, RGBToYUVCoefficients<C::kMatrix, C::kRange>>(src, dst, width,
+                                                                              height, format);
+        });
     }
 
-    void
-    rotateYUV420P(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
-        unsigned char *pSrcY = src;
-        unsigned char *pSrcU = src + width * height;
-        unsigned char *pSrcV = src + width * height / 4 * 5;
+    void RGBAByteToYUV420(const unsigned char *src, unsigned char *dst, int width, int height,
+                          int format, int channelOrder) {
+        withRowOutput(channelOrder, [&](auto order) {
+            RGBAToYUV420<decltype(order)::value>(src, dst, width, height, format);
+        });
+    }
 
-        unsigned char *pDstY = dst;
-        unsigned char *pDstU = dst + width * height;
-        unsigned char *pDstV = dst + width * height / 4 * 5;
+    void RGBAIntToYUV420(const int *src, unsigned char *dst, int width, int height, int format) {
+        RGBAToYUV420<ROW_OUTPUT_ARGB_INT>(reinterpret_cast<const unsigned char *>(src), dst,
+                                          width, height, format);
+    }
 
-        if (degree == 90.0f) {
-            rotateYUV420P90(pSrcY, pSrcU, pSrcV, pDstY, pDstU, pDstV, width, height);
-        } else if (degree == 180.0f) {
-            rotateYUV420P180(pSrcY, pSrcU, pSrcV, pDstY, pDstU, pDstV, width, height);
-        } else if (degree == 270.0f) {
-            rotateYUV420P270(pSrcY, pSrcU, pSrcV, pDstY, pDstU, pDstV, width, height);
+/*
+ * Bayer RAW. A band unpacks each row once into a ring of three sample rows
+ * that stays in the cache while the demosaic reads it, rows and columns past
+ * the edges are mirrored so they keep the color of the pattern.
+ */
+    struct RawFrame {
+        const unsigned char *src;
+        int width;
+        int height;
+        int rowStride;
+        int format;
+        int cfa;
+        int black;
+        int scale;
+    };
+
+    //ROW_BAYER_* of the even and odd rows of each CFA_*
+    const int BAYER_ROWS[4][2] = {
+            {ROW_BAYER_RG, ROW_BAYER_GB},
+            {ROW_BAYER_GR, ROW_BAYER_BG},
+            {ROW_BAYER_GB, ROW_BAYER_RG},
+            {ROW_BAYER_BG, ROW_BAYER_GR}
+    };
+
+    static bool makeRawFrame(const unsigned char *src, int width, int height, int rowStride,
+                             int format, int cfa, int blackLevel, int whiteLevel,
+                             RawFrame *frame) {
+        if (width < 2 || height < 2 || format < RAW_FORMAT_RAW10 || format > RAW_FORMAT_RAW16 ||
+            cfa < CFA_RGGB || cfa > CFA_BGGR || blackLevel < 0 || whiteLevel > 65535 ||
+            whiteLevel - blackLevel < 256) {
+            return false;
+        }
+        const int range = whiteLevel - blackLevel;
+        frame->src = src;
+        frame->width = width;
+        frame->height = height;
+        frame->rowStride = rowStride;
+        frame->format = format;
+        frame->cfa = cfa;
+        frame->black = blackLevel;
+        //rounded up so whiteLevel reaches 255, below 65536 for a range of 256 or more
+        frame->scale = ((255 << 16) + range - 1) / range;
+        return true;
+    }
+
+    //RAW10 and RAW12 from column x to the end of the row, RAW16 is copied as is
+    static void unpackRawRow(const unsigned char *src, uint16_t *dst, int x, int width,
+                             int format) {
+        if (format == RAW_FORMAT_RAW10) {
+            for (; x < width; x++) {
+                const unsigned char *p = src + (x >> 2) * 5;
+                const int shift = (x & 3) * 2;
+                dst[x] = static_cast<uint16_t>(p[x & 3] << 2 | ((p[4] >> shift) & 3));
+            }
+        } else if (format == RAW_FORMAT_RAW12) {
+            for (; x < width; x++) {
+                const unsigned char *p = src + (x >> 1) * 3;
+                const int shift = (x & 1) * 4;
+                dst[x] = static_cast<uint16_t>(p[x & 1] << 4 | ((p[2] >> shift) & 15));
+            }
         } else {
-            return;
+            memcpy(dst + x, src + x * 2, (width - x) * sizeof(uint16_t));
         }
     }
 
-    static inline void
-    rotateYUV420SP90(unsigned char *srcY, unsigned char *srcUV, unsigned char *dstY,
-                     unsigned char *dstUV, int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = x * height + height - y - 1;
-                dstY[dstIndex] = srcY[srcIndex++];
+    class RawUnpacker {
+    public:
+        RawUnpacker(int format, int width)
+                : mFormat(format), mWidth(width), mUnpackRow(nullptr), mSimdWidth(0) {
+            int step = 0;
+            if (format == RAW_FORMAT_RAW10) {
+                mUnpackRow = selectUnpackRawRow(ROW_RAW10, &step);
+            } else if (format == RAW_FORMAT_RAW12) {
+                mUnpackRow = selectUnpackRawRow(ROW_RAW12, &step);
             }
+            //the kernels read past their last group, the last step pixels are left to C
+            mSimdWidth = mUnpackRow && width > step ? (width - step) & ~(step - 1) : 0;
         }
 
-        //rotate uv
-        int uvHeight = height >> 1;
-        int uvWidth = width >> 1;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = (x * uvHeight + uvHeight - y - 1) << 1;
-                dstUV[dstUVIndex] = srcUV[srcUVIndex++];
-                dstUV[dstUVIndex + 1] = srcUV[srcUVIndex++];
+        void unpack(const unsigned char *src, uint16_t *dst) const {
+            if (mUnpackRow) {
+                mUnpackRow(src, dst, mSimdWidth);
             }
+            unpackRawRow(src, dst, mSimdWidth, mWidth, mFormat);
         }
+
+    private:
+        const int mFormat;
+        const int mWidth;
+        UnpackRawRowFunc mUnpackRow;
+        int mSimdWidth;
+    };
+
+    static inline unsigned char applyRawLevels(int c, int black, int scale) {
+        const unsigned int level = c > black
+                                   ? (static_cast<unsigned int>(c - black) * scale) >> 16 : 0;
+        return static_cast<unsigned char>(level > 255 ? 255 : level);
     }
 
-    static inline void
-    rotateYUV420SP180(unsigned char *srcY, unsigned char *srcUV, unsigned char *dstY,
-                      unsigned char *dstUV, int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = (height - y - 1) * width + width - x - 1;
-                dstY[dstIndex] = srcY[srcIndex++];
+    //the DemosaicRowFunc of native_row.h from column x to the end of the row
+    template<int kOutput>
+    static void demosaicRow(const uint16_t *above, const uint16_t *row, const uint16_t *below,
+                            unsigned char *dst, int x, int width, int bayer, int black,
+                            int scale) {
+        typedef RowOutputOrder<kOutput> Order;
+        const int greenColumn = bayer == ROW_BAYER_GR || bayer == ROW_BAYER_GB ? 0 : 1;
+        const bool redRow = bayer == ROW_BAYER_RG || bayer == ROW_BAYER_GR;
+        for (; x < width; x++) {
+            const int h = (row[x - 1] + row[x + 1] + 1) >> 1;
+            const int v = (above[x] + below[x] + 1) >> 1;
+            int own = h;
+            int green = row[x];
+            int other = v;
+            if ((x & 1) != greenColumn) {
+                own = row[x];
+                green = (h + v + 1) >> 1;
+                other = (((above[x - 1] + above[x + 1] + 1) >> 1) +
+                         ((below[x - 1] + below[x + 1] + 1) >> 1) + 1) >> 1;
             }
+            unsigned char *p = dst + x * 4;
+            p[Order::kR] = applyRawLevels(redRow ? own : other, black, scale);
+            p[Order::kG] = applyRawLevels(green, black, scale);
+            p[Order::kB] = applyRawLevels(redRow ? other : own, black, scale);
+            p[Order::kA] = 255;
         }
+    }
 
-        //rotate uv
-        int uvHeight = height >> 1;
-        int uvWidth = width >> 1;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = ((uvHeight - y - 1) * uvWidth + uvWidth - x - 1) << 1;
-                dstUV[dstUVIndex] = srcUV[srcUVIndex++];
-                dstUV[dstUVIndex + 1] = srcUV[srcUVIndex++];
+    //one per band, the ring of unpacked rows is not shared
+    template<int kOutput>
+    class RawDemosaic {
+    public:
+        explicit RawDemosaic(const RawFrame &frame)
+                : mFrame(frame), mUnpacker(frame.format, frame.width),
+                  mSampleStride(frame.width + 2), mSamples(mSampleStride * 3) {
+            for (int i = 0; i < 3; i++) {
+                mSampleRows[i] = -1;
+            }
+            for (int i = 0; i < 2; i++) {
+                int step = 0;
+                mBayer[i] = BAYER_ROWS[frame.cfa][i];
+                mDemosaicRow[i] = selectDemosaicRow(mBayer[i], kOutput, &step);
+                mSimdWidth[i] = mDemosaicRow[i] ? frame.width & ~(step - 1) : 0;
             }
         }
-    }
 
-    static inline void
-    rotateYUV420SP270(unsigned char *srcY, unsigned char *srcUV, unsigned char *dstY,
-                      unsigned char *dstUV, int width, int height) {
-        //rotate y
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                dstIndex = (width - x - 1) * height + y;
-                dstY[dstIndex] = srcY[srcIndex++];
+        //pixels of row y of the frame
+        void write(int y, unsigned char *dst) {
+            const uint16_t *pAbove = samples(y - 1);
+            const uint16_t *pRow = samples(y);
+            const uint16_t *pBelow = samples(y + 1);
+            const int i = y & 1;
+            if (mDemosaicRow[i]) {
+                mDemosaicRow[i](pAbove, pRow, pBelow, dst, mSimdWidth[i], mFrame.black,
+                                mFrame.scale);
             }
+            demosaicRow<kOutput>(pAbove, pRow, pBelow, dst, mSimdWidth[i], mFrame.width,
+                                 mBayer[i], mFrame.black, mFrame.scale);
         }
 
-        //rotate uv
-        int uvHeight = height >> 1;
-        int uvWidth = width >> 1;
-        int dstUVIndex = 0;
-        int srcUVIndex = 0;
-        for (int y = 0; y < uvHeight; y++) {
-            for (int x = 0; x < uvWidth; x++) {
-                dstUVIndex = ((uvWidth - x - 1) * uvHeight + y) << 1;
-                dstUV[dstUVIndex] = srcUV[srcUVIndex++];
-                dstUV[dstUVIndex + 1] = srcUV[srcUVIndex++];
+    private:
+        //y, y - 1 and y + 1 never share a slot, a mirrored row is its own
+        const uint16_t *samples(int y) {
+            y = y < 0 ? 1 : (y >= mFrame.height ? mFrame.height - 2 : y);
+            const int slot = y % 3;
+            uint16_t *pRow = mSamples.data() + slot * mSampleStride + 1;
+            if (mSampleRows[slot] != y) {
+                mSampleRows[slot] = y;
+                mUnpacker.unpack(mFrame.src + y * mFrame.rowStride, pRow);
+                pRow[-1] = pRow[1];
+                pRow[mFrame.width] = pRow[mFrame.width - 2];
             }
+            return pRow;
         }
-    }
 
-    void
-    rotateYUV420SP(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
-        unsigned char *pSrcY = src;
-        unsigned char *pSrcUV = src + width * height;
+        const RawFrame &mFrame;
+        const RawUnpacker mUnpacker;
+        const int mSampleStride;
+        std::vector<uint16_t> mSamples;
+        int mSampleRows[3];
+        int mBayer[2];
+        DemosaicRowFunc mDemosaicRow[2];
+        int mSimdWidth[2];
+    };
 
-        unsigned char *pDstY = dst;
-        unsigned char *pDstUV = dst + width * height;
+    template<int kOutput>
+    static void RAWToRGBA(const RawFrame &frame, unsigned char *dst) {
+        forEachBand(frame.width, frame.height, [&](int yBegin, int yEnd) {
+            RawDemosaic<kOutput> demosaic(frame);
+            for (int y = yBegin; y < yEnd; y++) {
+                demosaic.write(y, dst + y * frame.width * 4);
+            }
+        });
+    }
 
-        if (degree == 90.0f) {
-            rotateYUV420SP90(pSrcY, pSrcUV, pDstY, pDstUV, width, height);
-        } else if (degree == 180.0f) {
-            rotateYUV420SP180(pSrcY, pSrcUV, pDstY, pDstUV, width, height);
-        } else if (degree == 270.0f) {
-            rotateYUV420SP270(pSrcY, pSrcUV, pDstY, pDstUV, width, height);
-        } else {
+    //two rows of pixels in a row buffer per chroma row
+    template<class Coefficients>
+    static void RAWToYUV420(const RawFrame &frame, unsigned char *dst, int format) {
+        const RGBAToYUV420Writer<ROW_OUTPUT_RGBA, Coefficients> writer(dst, frame.width,
+                                                                       frame.height, format);
+        forEachBand(frame.width, frame.height, [&](int yBegin, int yEnd) {
+            RawDemosaic<ROW_OUTPUT_RGBA> demosaic(frame);
+            std::vector<unsigned char> rows(frame.width * 4 * 2);
+            unsigned char *pRow0 = rows.data();
+            unsigned char *pRow1 = pRow0 + frame.width * 4;
+            for (int y = yBegin; y < yEnd; y += 2) {
+                demosaic.write(y, pRow0);
+                if (y + 1 < frame.height) {
+                    demosaic.write(y + 1, pRow1);
+                }
+                writer.write(pRow0, y + 1 < frame.height ? pRow1 : pRow0, y);
+            }
+        });
+    }
+
+    void unpackRAW(const unsigned char *src, uint16_t *dst, int width, int height, int rowStride,
+                   int format) {
+        if (width <= 0 || format < RAW_FORMAT_RAW10 || format > RAW_FORMAT_RAW16) {
             return;
         }
+        forEachBand(width, height, [&](int yBegin, int yEnd) {
+            const RawUnpacker unpacker(format, width);
+            for (int y = yBegin; y < yEnd; y++) {
+                unpacker.unpack(src + y * rowStride, dst + y * width);
+            }
+        });
     }
 
-    static inline void
-    rotateRGB90(unsigned char *src, unsigned char *dst, int width, int height, int bpp) {
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                //(y, x) -> (x, height - y - 1)
-                //y * width + x, -> x* height + height - y - 1
-                dstIndex = (x * height + height - y - 1) * bpp;
-                for (int i = 0; i < bpp; i++) {
-                    dst[dstIndex + i] = src[srcIndex++];
-                }
-            }
+    void RAWToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                       int rowStride, int format, int cfa, int blackLevel, int whiteLevel,
+                       int channelOrder) {
+        RawFrame frame;
+        if (!makeRawFrame(src, width, height, rowStride, format, cfa, blackLevel, whiteLevel,
+                          &frame)) {
+            return;
         }
+        withRowOutput(channelOrder, [&](auto order) {
+            RAWToRGBA<decltype(order)::value>(frame, dst);
+        });
     }
 
-    static inline void rotateRGB90(int *src, int *dst, int width, int height) {
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                //(y, x) -> (x, height - y - 1)
-                //y * width + x, -> x* height + height - y - 1
-                dstIndex = x * height + height - y - 1;
-                dst[dstIndex] = src[srcIndex++];
-            }
+    void RAWToRGBAInt(const unsigned char *src, int *dst, int width, int height, int rowStride,
+                      int format, int cfa, int blackLevel, int whiteLevel) {
+        RawFrame frame;
+        if (!makeRawFrame(src, width, height, rowStride, format, cfa, blackLevel, whiteLevel,
+                          &frame)) {
+            return;
         }
+        RAWToRGBA<ROW_OUTPUT_ARGB_INT>(frame, reinterpret_cast<unsigned char *>(dst));
     }
 
-    static inline void
-    rotateRGB180(unsigned char *src, unsigned char *dst, int width, int height, int bpp) {
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                //(y, x) -> (height - y - 1, width - x - 1)
-                //y * width + x, -> (height - y - 1) * width + width - x - 1
-                dstIndex = ((height - y - 1) * width + width - x - 1) * bpp;
-                for (int i = 0; i < bpp; i++) {
-                    dst[dstIndex + i] = src[srcIndex++];
-                }
-            }
+    void RAWToYUV420(const unsigned char *src, unsigned char *dst, int width, int height,
+                     int rowStride, int format, int cfa, int blackLevel, int whiteLevel,
+                     int yuvFormat) {
+        RawFrame frame;
+        if (yuvFormat < YUV420P_I420 || yuvFormat > YUV420SP_NV21 ||
+            !makeRawFrame(src, width, height, rowStride, format, cfa, blackLevel, whiteLevel,
+                          &frame)) {
+            return;
         }
+        withColorCoefficients(sColorMatrix, sColorRange, [&](auto coefficients) {
+            typedef decltype(coefficients) C;
+            RAWToYUV420<RGBToYUVCoefficients<C::kMatrix, C::kRange>>(frame, dst, yuvFormat);
+        });
     }
 
-    static inline void rotateRGB180(int *src, int *dst, int width, int height) {
-        int dstIndex = 0;
-        int srcIndex = 0;
+/*
+ * Rotate a plane of width x height elements of kBytesPerElement bytes into a
+ * plane with dstRowStride. srcPixelStride is the distance in bytes between two
+ * source elements, kSrcPixelStride 0 means it is only known at runtime.
+ *   90: (y, x) -> (x, height - y - 1)
+ *  180: (y, x) -> (height - y - 1, width - x - 1)
+ *  270: (y, x) -> (width - x - 1, y)
+ */
+    template<int kBytesPerElement, int kSrcPixelStride>
+    static void rotatePlane180(const unsigned char *src, int srcRowStride, int srcPixelStride,
+                               unsigned char *dst, int dstRowStride, int width, int height) {
+        const int pixelStride = kSrcPixelStride ? kSrcPixelStride : srcPixelStride;
+        //a row is reversed into a buffer and streamed out, see STREAM_MIN_BYTES
+        const StreamRowFunc streamRow = selectStreamRow(width, height, kBytesPerElement);
+        std::vector<unsigned char> row(streamRow ? width * kBytesPerElement : 0);
         for (int y = 0; y < height; y++) {
+            const unsigned char *pSrc = src + y * srcRowStride;
+            unsigned char *pOut = dst + (height - y - 1) * dstRowStride;
+            unsigned char *pDst = (streamRow ? row.data() : pOut) + (width - 1) * kBytesPerElement;
             for (int x = 0; x < width; x++) {
-                //(y, x) -> (height - y - 1, width - x - 1)
-                //y * width + x, -> (height - y - 1) * width + width - x - 1
-                dstIndex = (height - y - 1) * width + width - x - 1;
-                dst[dstIndex] = src[srcIndex++];
+                memcpy(pDst, pSrc, kBytesPerElement);
+                pSrc += pixelStride;
+                pDst -= kBytesPerElement;
+            }
+            if (streamRow) {
+                streamRow(row.data(), pOut, width * kBytesPerElement);
             }
         }
     }
 
-    static inline void
-    rotateRGB270(unsigned char *src, unsigned char *dst, int width, int height, int bpp) {
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                //(y, x) -> (width - x - 1, y)
-                //y * width + x, -> (width - x - 1) * height + y
-                dstIndex = ((width - x - 1) * height + y) * bpp;
-                for (int i = 0; i < bpp; i++) {
-                    dst[dstIndex + i] = src[srcIndex++];
-                }
-            }
+    //largest power of two tile, in elements, whose source and destination fill half the L1
+    static int rotateTileSize(int srcPixelStride, int bytesPerElement) {
+        static const long long l1Size = readL1CacheSize();
+        const long long budget = (l1Size > 0 ? l1Size : ROTATE_DEFAULT_L1_BYTES) / 2;
+        const int tileBytes = srcPixelStride + bytesPerElement;
+        int tile = ROTATE_MIN_TILE;
+        while (tile < ROTATE_MAX_TILE &&
+               static_cast<long long>(tile) * 2 * tile * 2 * tileBytes <= budget) {
+            tile *= 2;
         }
+        return tile;
     }
 
-    static inline void rotateRGB270(int *src, int *dst, int width, int height) {
-        int dstIndex = 0;
-        int srcIndex = 0;
-        for (int y = 0; y < height; y++) {
-            for (int x = 0; x < width; x++) {
-                //(y, x) -> (width - x - 1, y)
-                //y * width + x, -> (width - x - 1) * height + y
-                dstIndex = (width - x - 1) * height + y;
-                dst[dstIndex] = src[srcIndex++];
+/*
+ * Contiguous elements go through the TransposeBlockFunc of native_row.h in
+ * the full blocks of a tile, the edges of the plane are copied one by one.
+ */
+    template<int kDegree, int kBytesPerElement, int kSrcPixelStride>
+    static void rotatePlaneTiled(const unsigned char *src, int srcRowStride, int srcPixelStride,
+                                 unsigned char *dst, int dstRowStride, int width, int height) {
+        const int pixelStride = kSrcPixelStride ? kSrcPixelStride : srcPixelStride;
+        const int tile = rotateTileSize(pixelStride, kBytesPerElement);
+        const int dstStep = kDegree == 90 ? dstRowStride : -dstRowStride;
+        int block = 0;
+        const TransposeBlockFunc transpose = pixelStride == kBytesPerElement
+                                             ? selectTransposeBlock(kBytesPerElement, &block)
+                                             : nullptr;
+        const auto rotateElements = [&](int yBegin, int yEnd, int xBegin, int xEnd) {
+            for (int y = yBegin; y < yEnd; y++) {
+                const unsigned char *pSrc = src + y * srcRowStride + xBegin * pixelStride;
+                unsigned char *pDst =
+                        kDegree == 90 ? dst + xBegin * dstRowStride +
+                                        (height - y - 1) * kBytesPerElement
+                                      : dst + (width - xBegin - 1) * dstRowStride +
+                                        y * kBytesPerElement;
+                for (int x = xBegin; x < xEnd; x++) {
+                    memcpy(pDst, pSrc, kBytesPerElement);
+                    pSrc += pixelStride;
+                    pDst += dstStep;
+                }
+            }
+        };
+        for (int yTile = 0; yTile < height; yTile += tile) {
+            const int yEnd = yTile + tile < height ? yTile + tile : height;
+            for (int xTile = 0; xTile < width; xTile += tile) {
+                const int xEnd = xTile + tile < width ? xTile + tile : width;
+                if (!transpose) {
+                    rotateElements(yTile, yEnd, xTile, xEnd);
+                    continue;
+                }
+                const int yBlockEnd = yTile + ((yEnd - yTile) & ~(block - 1));
+                const int xBlockEnd = xTile + ((xEnd - xTile) & ~(block - 1));
+                for (int y = yTile; y < yBlockEnd; y += block) {
+                    for (int x = xTile; x < xBlockEnd; x += block) {
+                        const unsigned char *pSrc = src + y * srcRowStride + x * kBytesPerElement;
+                        if (kDegree == 90) {
+                            transpose(pSrc + (block - 1) * srcRowStride, -srcRowStride,
+                                      dst + x * dstRowStride +
+                                      (height - y - block) * kBytesPerElement, dstRowStride);
+                        } else {
+                            transpose(pSrc, srcRowStride,
+                                      dst + (width - x - 1) * dstRowStride + y * kBytesPerElement,
+                                      -dstRowStride);
+                        }
+                    }
+                }
+                rotateElements(yTile, yBlockEnd, xBlockEnd, xEnd);
+                rotateElements(yBlockEnd, yEnd, xTile, xEnd);
             }
         }
     }
 
-    void rotateRGB(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+/*
+ * Rotate into a packed plane, does nothing for other degrees.
+ */
+    template<int kBytesPerElement, int kSrcPixelStride>
+    static void rotatePlane(const unsigned char *src, int srcRowStride, int srcPixelStride,
+                            unsigned char *dst, int width, int height, float degree) {
         if (degree == 90.0f) {
-            rotateRGB90(src, dst, width, height, 3);
+            rotatePlaneTiled<90, kBytesPerElement, kSrcPixelStride>(
+                    src, srcRowStride, srcPixelStride, dst, height * kBytesPerElement, width,
+                    height);
         } else if (degree == 180.0f) {
-            rotateRGB180(src, dst, width, height, 3);
+            rotatePlane180<kBytesPerElement, kSrcPixelStride>(
+                    src, srcRowStride, srcPixelStride, dst, width * kBytesPerElement, width,
+                    height);
         } else if (degree == 270.0f) {
-            rotateRGB270(src, dst, width, height, 3);
-        } else {
-            return;
+            rotatePlaneTiled<270, kBytesPerElement, kSrcPixelStride>(
+                    src, srcRowStride, srcPixelStride, dst, height * kBytesPerElement, width,
+                    height);
         }
     }
 
-    void rotateRGBA(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
-        if (degree == 90.0f) {
-            rotateRGB90(src, dst, width, height, 4);
-        } else if (degree == 180.0f) {
-            rotateRGB180(src, dst, width, height, 4);
-        } else if (degree == 270.0f) {
-            rotateRGB270(src, dst, width, height, 4);
+    static inline void
+    rotateChromaPlane(const unsigned char *src, int uvRowStride, int uvPixelStride,
+                      unsigned char *dst, int uvWidth, int uvHeight, float degree) {
+        if (uvPixelStride == 1) {
+            rotatePlane<1, 1>(src, uvRowStride, 1, dst, uvWidth, uvHeight, degree);
+        } else if (uvPixelStride == 2) {
+            rotatePlane<1, 2>(src, uvRowStride, 2, dst, uvWidth, uvHeight, degree);
         } else {
-            return;
+            rotatePlane<1, 0>(src, uvRowStride, uvPixelStride, dst, uvWidth, uvHeight, degree);
         }
     }
 
+    void rotateYUV420(const unsigned char *srcY, const unsigned char *srcU,
+                      const unsigned char *srcV, unsigned char *dst, int width, int height,
+                      int yRowStride, int uvRowStride, int uvPixelStride, float degree) {
+        const int uvWidth = width / 2;
+        const int uvHeight = height / 2;
+        unsigned char *pDstU = dst + width * height;
+        unsigned char *pDstV = pDstU + uvWidth * uvHeight;
+
+        rotatePlane<1, 1>(srcY, yRowStride, 1, dst, width, height, degree);
+        rotateChromaPlane(srcU, uvRowStride, uvPixelStride, pDstU, uvWidth, uvHeight, degree);
+        rotateChromaPlane(srcV, uvRowStride, uvPixelStride, pDstV, uvWidth, uvHeight, degree);
+    }
+
+    void
+    rotateYUV420P(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+        const int uvWidth = width / 2;
+        const unsigned char *pSrcU = src + width * height;
+        const unsigned char *pSrcV = pSrcU + uvWidth * (height / 2);
+        rotateYUV420(src, pSrcU, pSrcV, dst, width, height, width, uvWidth, 1, degree);
+    }
+
+    void
+    rotateYUV420SP(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+        //the interleaved uv plane is rotated as one plane of 2 byte elements
+        const int uvWidth = width >> 1;
+        const int uvHeight = height >> 1;
+        rotatePlane<1, 1>(src, width, 1, dst, width, height, degree);
+        rotatePlane<2, 2>(src + width * height, uvWidth * 2, 2, dst + width * height, uvWidth,
+                          uvHeight, degree);
+    }
+
+    void rotateI010(const uint16_t *src, uint16_t *dst, int width, int height, float degree) {
+        const int uvWidth = width / 2;
+        const int uvHeight = height / 2;
+        const unsigned char *pSrc = reinterpret_cast<const unsigned char *>(src);
+        unsigned char *pDst = reinterpret_cast<unsigned char *>(dst);
+        const int uvOffset = width * height * 2;
+        const int uvBytes = uvWidth * uvHeight * 2;
+        rotatePlane<2, 2>(pSrc, width * 2, 2, pDst, width, height, degree);
+        rotatePlane<2, 2>(pSrc + uvOffset, uvWidth * 2, 2, pDst + uvOffset, uvWidth, uvHeight,
+                          degree);
+        rotatePlane<2, 2>(pSrc + uvOffset + uvBytes, uvWidth * 2, 2, pDst + uvOffset + uvBytes,
+                          uvWidth, uvHeight, degree);
+    }
+
+    void rotateP010(const uint16_t *src, uint16_t *dst, int width, int height, float degree) {
+        //the interleaved uv plane is rotated as one plane of 4 byte elements
+        const int uvWidth = width >> 1;
+        const int uvHeight = height >> 1;
+        const unsigned char *pSrc = reinterpret_cast<const unsigned char *>(src);
+        unsigned char *pDst = reinterpret_cast<unsigned char *>(dst);
+        const int uvOffset = width * height * 2;
+        rotatePlane<2, 2>(pSrc, width * 2, 2, pDst, width, height, degree);
+        rotatePlane<4, 4>(pSrc + uvOffset, uvWidth * 4, 4, pDst + uvOffset, uvWidth, uvHeight,
+                          degree);
+    }
+
+    void rotateRGB(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+        rotatePlane<3, 3>(src, width * 3, 3, dst, width, height, degree);
+    }
+
+    void rotateRGBA(unsigned char *src, unsigned char *dst, int width, int height, float degree) {
+        rotatePlane<4, 4>(src, width * 4, 4, dst, width, height, degree);
+    }
+
     void rotateRGBAInt(int *src, int *dst, int width, int height, float degree) {
-        if (degree == 90.0f) {
-            rotateRGB90(src, dst, width, height);
-        } else if (degree == 180.0f) {
-            rotateRGB180(src, dst, width, height);
-        } else if (degree == 270.0f) {
-            rotateRGB270(src, dst, width, height);
-        } else {
-            return;
-        }
+        rotatePlane<4, 4>(reinterpret_cast<unsigned char *>(src), width * 4, 4,
+                          reinterpret_cast<unsigned char *>(dst), width, height, degree);
     }
 }
@@ -32,16 +32,320 @@ namespace native_utils {
     const int YUV420SP_NV12 = 3;
     const int YUV420SP_NV21 = 4;
 
+    /*
+     * CONVERT_ENGINE_ARITHMETIC: multiply-add per pixel, with the SIMD row kernels.
+     * CONVERT_ENGINE_TABLE: scalar lookup tables, no multiplies and no clamp branches.
+     */
+    const int CONVERT_ENGINE_ARITHMETIC = 0;
+    const int CONVERT_ENGINE_TABLE = 1;
+
+    void setConvertEngine(int engine);
+
+    int getConvertEngine();
+
+    /*
+     * CONVERT_PRECISION_EXACT: 32-bit sums, bit-exact on every engine and cpu.
+     * CONVERT_PRECISION_FAST: 16-bit sums, twice the SIMD lanes, channels
+     * within 2 of the exact result. Used by the conversions without color
+     * adjustments, in place of the engine.
+     */
+    const int CONVERT_PRECISION_EXACT = 0;
+    const int CONVERT_PRECISION_FAST = 1;
+
+    void setConvertPrecision(int precision);
+
+    int getConvertPrecision();
+
+    /*
+     * Threads used by the conversions, CONVERT_THREADS_AUTO is one per cpu.
+     * More threads than cpus are clamped to the cpu count. Frames smaller than
+     * 640x480 are always converted on the calling thread.
+     */
+    const int CONVERT_THREADS_AUTO = 0;
+
+    void setConvertThreads(int threads);
+
+    int getConvertThreads();
+
+    /*
+     * CHROMA_UPSAMPLING_NEAREST: every chroma sample covers its 2x2 block.
+     * CHROMA_UPSAMPLING_BILINEAR: chroma co-sited with the even columns and
+     * between two rows (MPEG-2), interpolated for every pixel.
+     */
+    const int CHROMA_UPSAMPLING_NEAREST = 0;
+    const int CHROMA_UPSAMPLING_BILINEAR = 1;
+
+    void setChromaUpsampling(int upsampling);
+
+    int getChromaUpsampling();
+
+    /*
+     * Color matrix and range of the YUV input, BT.601 limited range by default.
+     * COLOR_RANGE_LIMITED: Y in [16, 235] and UV in [16, 240], video.
+     * COLOR_RANGE_FULL: Y and UV in [0, 255], JPEG.
+     */
+    const int COLOR_MATRIX_BT601 = 0;
+    const int COLOR_MATRIX_BT709 = 1;
+    const int COLOR_MATRIX_BT2020 = 2;
+    const int COLOR_RANGE_LIMITED = 0;
+    const int COLOR_RANGE_FULL = 1;
+
+    void setColorSpace(int matrix, int range);
+
+    int getColorMatrix();
+
+    int getColorRange();
+
+    /*
+     * Byte order of the RGBA byte outputs and of the input of RGBAByteToYUV420,
+     * the channelOrder argument of each of them, unknown orders are RGBA. Each
+     * order is its own compiled store, so none needs a swizzle pass afterwards.
+     * setChannelOrder only keeps a default for callers without an order of
+     * their own, RGBA at first.
+     * The int outputs are always ARGB ints, i.e. CHANNEL_ORDER_BGRA bytes.
+     */
+    const int CHANNEL_ORDER_RGBA = 0;
+    const int CHANNEL_ORDER_BGRA = 1;
+    const int CHANNEL_ORDER_ARGB = 2;
+    const int CHANNEL_ORDER_ABGR = 3;
+
+    void setChannelOrder(int order);
+
+    int getChannelOrder();
+
+    /*
+     * Color adjustments folded into the coefficients of the conversions, so
+     * they cost no extra pass over the image. Applied to the RGB result of the
+     * selected color space, in this order:
+     *   saturation: chroma gain, 1 none, 0 gray.
+     *   whiteBalanceGains: r, g, b gains, nullptr for none.
+     *   colorCorrectionMatrix: 3x3 row-major matrix, nullptr for none.
+     *   contrast: gain around 128, 1 none, clamped to [-16, 16].
+     *   brightness: added to every channel, in 8-bit units, clamped to [-255, 255].
+     * The adjusted conversions always use CONVERT_ENGINE_ARITHMETIC.
+     */
+    void setColorAdjustment(const float *whiteBalanceGains, const float *colorCorrectionMatrix,
+                            float brightness, float contrast, float saturation);
+
+    void clearColorAdjustment();
+
     void YUV420PToRGBAByte(unsigned char *src, unsigned char *dst, int width, int height,
-                           int yRowStride, int uvRowStride, int uvPixelStride, int format);
+                           int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                           int channelOrder);
 
     void YUV420PToRGBAInt(unsigned char *src, int *dst, int width, int height,
                           int yRowStride, int uvRowStride, int uvPixelStride, int format);
 
-    void YUV420SPToRGBAByte(unsigned char *src, unsigned char *dst,
-                            int width, int height, int format);
+    void YUV420SPToRGBAByte(unsigned char *src, unsigned char *dst, int width, int height,
+                            int yRowStride, int uvRowStride, int format, int channelOrder);
+
+    void YUV420SPToRGBAInt(unsigned char *src, int *dst, int width, int height,
+                           int yRowStride, int uvRowStride, int format);
+
+    /*
+     * Smaller outputs of the same conversions, packed from the converted RGB:
+     * RGB565: 2 bytes per pixel, little-endian like Bitmap.Config.RGB_565.
+     * dither adds a 4x4 ordered dither before the truncation, against banding.
+     * RGB24: R, G, B bytes, 3 per pixel.
+     * Gray: 1 byte per pixel, the BT.601 luma of the converted RGB, so the
+     * color adjustments apply.
+     */
+    void YUV420PToRGB565(unsigned char *src, unsigned char *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                         bool dither);
+
+    void YUV420SPToRGB565(unsigned char *src, unsigned char *dst, int width, int height,
+                          int yRowStride, int uvRowStride, int format, bool dither);
+
+    void YUV420PToRGB24(unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int uvPixelStride, int format);
+
+    void YUV420SPToRGB24(unsigned char *src, unsigned char *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int format);
+
+    void YUV420PToGray(unsigned char *src, unsigned char *dst, int width, int height,
+                       int yRowStride, int uvRowStride, int uvPixelStride, int format);
+
+    void YUV420SPToGray(unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int format);
+
+    /*
+     * R, G, B, A float outputs in [0, 1] for linear-light compositing, alpha 1.
+     * LINEARIZE_NONE: the encoded values, v / 255.
+     * LINEARIZE_SRGB: the sRGB EOTF.
+     * LINEARIZE_BT1886: the BT.1886 EOTF for a black level of 0, v ^ 2.4.
+     * Applied to the converted 8-bit channels. Half is IEEE 754 binary16,
+     * rounded to nearest even. The channel order is always RGBA.
+     */
+    const int LINEARIZE_NONE = 0;
+    const int LINEARIZE_SRGB = 1;
+    const int LINEARIZE_BT1886 = 2;
+
+    void YUV420PToRGBAFloat(unsigned char *src, float *dst, int width, int height,
+                            int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                            int linearize);
+
+    void YUV420SPToRGBAFloat(unsigned char *src, float *dst, int width, int height,
+                             int yRowStride, int uvRowStride, int format, int linearize);
+
+    void YUV420PToRGBAHalf(unsigned char *src, uint16_t *dst, int width, int height,
+                           int yRowStride, int uvRowStride, int uvPixelStride, int format,
+                           int linearize);
 
-    void YUV420SPToRGBAInt(unsigned char *src, int *dst, int width, int height, int format);
+    void YUV420SPToRGBAHalf(unsigned char *src, uint16_t *dst, int width, int height,
+                            int yRowStride, int uvRowStride, int format, int linearize);
+
+    /*
+     * 10-bit input in 16-bit samples, the strides are in samples. Converted at
+     * 10 bits with the color space and adjustments of the 8-bit conversions.
+     * I010: planar like I420, the samples in the low 10 bits.
+     * P010: an interleaved uv plane like NV12, the samples in the high 10 bits.
+     * The byte output is the 10-bit channels >> 2 in the order of
+     * channelOrder, RGBA1010102 is the word r | g << 10 | b << 20 | 3 << 30
+     * like Bitmap.Config.RGBA_1010102 and half is linearized like
+     * YUV420PToRGBAHalf from the 10-bit channels.
+     */
+    void I010ToRGBAByte(const uint16_t *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder);
+
+    void I010ToRGBA1010102(const uint16_t *src, int *dst, int width, int height,
+                           int yRowStride, int uvRowStride);
+
+    void I010ToRGBAHalf(const uint16_t *src, uint16_t *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int linearize);
+
+    void P010ToRGBAByte(const uint16_t *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder);
+
+    void P010ToRGBA1010102(const uint16_t *src, int *dst, int width, int height,
+                           int yRowStride, int uvRowStride);
+
+    void P010ToRGBAHalf(const uint16_t *src, uint16_t *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int linearize);
+
+    /*
+     * 4:2:2 and 4:4:4 input, converted with the color space, adjustments,
+     * channel order and chroma upsampling of the 4:2:0 conversions. Bilinear
+     * 4:2:2 chroma is only upsampled horizontally.
+     * I422: planar, height rows of (width + 1) / 2 u, then of v.
+     * NV16: an interleaved uv plane of height rows, like NV12.
+     * I444: planar, u and v planes of width x height.
+     * YUY2 and UYVY: packed Y0 U Y1 V and U Y0 V Y1, rowStride bytes per row.
+     */
+    void I422ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder);
+
+    void I422ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride);
+
+    void NV16ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder);
+
+    void NV16ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride);
+
+    void I444ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int yRowStride, int uvRowStride, int channelOrder);
+
+    void I444ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int yRowStride, int uvRowStride);
+
+    void YUY2ToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int rowStride, int channelOrder);
+
+    void YUY2ToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int rowStride);
+
+    void UYVYToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                        int rowStride, int channelOrder);
+
+    void UYVYToRGBAInt(const unsigned char *src, int *dst, int width, int height,
+                       int rowStride);
+
+    /*
+     * Separate plane pointers, e.g. the planes of an android.media.Image in
+     * YUV_420_888. uvPixelStride 2 with srcV == srcU + 1 is NV12 and
+     * srcU == srcV + 1 is NV21.
+     */
+    void YUV420ToRGBAByte(const unsigned char *srcY, const unsigned char *srcU,
+                          const unsigned char *srcV, unsigned char *dst, int width, int height,
+                          int yRowStride, int uvRowStride, int uvPixelStride, int channelOrder);
+
+    void YUV420ToRGBAInt(const unsigned char *srcY, const unsigned char *srcU,
+                         const unsigned char *srcV, int *dst, int width, int height,
+                         int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /*
+     * Luma-only outputs for consumers without use for color, e.g. barcode
+     * scanning. Only srcY is read, the Y plane of any of the formats above.
+     * expandRange stretches limited range luma to [0, 255] like the limited
+     * range conversions do. The RGBA outputs are gray in r, g and b with the
+     * alpha of channelOrder, the int output is ARGB ints.
+     */
+    void lumaToGray(const unsigned char *srcY, unsigned char *dst, int width, int height,
+                    int yRowStride, bool expandRange);
+
+    void lumaToRGBAByte(const unsigned char *srcY, unsigned char *dst, int width, int height,
+                        int yRowStride, bool expandRange, int channelOrder);
+
+    void lumaToRGBAInt(const unsigned char *srcY, int *dst, int width, int height,
+                       int yRowStride, bool expandRange);
+
+    /*
+     * RGBA to YUV420 with the color space of setColorSpace, e.g. for an
+     * encoder. The color adjustments do not apply. The byte input is in the
+     * order of channelOrder, the int input is ARGB ints. format is any
+     * YUV420P_* or YUV420SP_*, dst is packed: height rows of width luma, then
+     * (height + 1) / 2 rows of (width + 1) / 2 samples of each chroma plane,
+     * or of uv pairs. Each chroma sample is from the average of its 2x2 block.
+     */
+    void RGBAByteToYUV420(const unsigned char *src, unsigned char *dst, int width, int height,
+                          int format, int channelOrder);
+
+    void RGBAIntToYUV420(const int *src, unsigned char *dst, int width, int height, int format);
+
+    /*
+     * Bayer RAW input, rowStride bytes per row of the sensor:
+     * RAW_FORMAT_RAW10: MIPI RAW10 like ImageFormat.RAW10, 4 pixels in 5 bytes.
+     * RAW_FORMAT_RAW12: MIPI RAW12 like ImageFormat.RAW12, 2 pixels in 3 bytes.
+     * RAW_FORMAT_RAW16: little-endian 16-bit samples like ImageFormat.RAW_SENSOR.
+     * CFA_* is the color filter arrangement, the colors of the top left 2x2
+     * block, the values of SENSOR_INFO_COLOR_FILTER_ARRANGEMENT.
+     * unpackRAW writes width 16-bit samples per row. The others demosaic
+     * bilinearly, each missing color from the average of its 2 or 4 nearest
+     * samples, and map [blackLevel, whiteLevel] to [0, 255]; white balance and
+     * color correction are left to the caller. whiteLevel - blackLevel must be
+     * at least 256 and width and height at least 2. RAWToYUV420 converts the
+     * pixels like RGBAByteToYUV420 into any YUV420P_* or YUV420SP_* yuvFormat.
+     */
+    const int RAW_FORMAT_RAW10 = 0;
+    const int RAW_FORMAT_RAW12 = 1;
+    const int RAW_FORMAT_RAW16 = 2;
+    const int CFA_RGGB = 0;
+    const int CFA_GRBG = 1;
+    const int CFA_GBRG = 2;
+    const int CFA_BGGR = 3;
+
+    void unpackRAW(const unsigned char *src, uint16_t *dst, int width, int height, int rowStride,
+                   int format);
+
+    void RAWToRGBAByte(const unsigned char *src, unsigned char *dst, int width, int height,
+                       int rowStride, int format, int cfa, int blackLevel, int whiteLevel,
+                       int channelOrder);
+
+    void RAWToRGBAInt(const unsigned char *src, int *dst, int width, int height, int rowStride,
+                      int format, int cfa, int blackLevel, int whiteLevel);
+
+    void RAWToYUV420(const unsigned char *src, unsigned char *dst, int width, int height,
+                     int rowStride, int format, int cfa, int blackLevel, int whiteLevel,
+                     int yuvFormat);
+
+    /*
+     * Rotate separate planes into a packed I420 dst.
+     */
+    void rotateYUV420(const unsigned char *srcY, const unsigned char *srcU,
+                      const unsigned char *srcV, unsigned char *dst, int width, int height,
+                      int yRowStride, int uvRowStride, int uvPixelStride, float degree);
 
     void rotateYUV420P(unsigned char *src, unsigned char *dst,
                        int width, int height, float degree);
@@ -49,6 +353,13 @@ namespace native_utils {
     void rotateYUV420SP(unsigned char *src, unsigned char *dst,
                         int width, int height, float degree);
 
+    /*
+     * Rotate packed 10-bit I010 and P010 frames, the samples are moved as is.
+     */
+    void rotateI010(const uint16_t *src, uint16_t *dst, int width, int height, float degree);
+
+    void rotateP010(const uint16_t *src, uint16_t *dst, int width, int height, float degree);
+
     void rotateRGB(unsigned char *src, unsigned char *dst, int width, int height, float degree);
 
     void rotateRGBA(unsigned char *src, unsigned char *dst, int width, int height, float degree);
@@ -26,6 +26,69 @@ public class LibyuvUtils {
         System.loadLibrary("LibyuvUtils");
     }
 
+    /**
+     * Color matrices and ranges, same as NativeUtils. libyuv only converts BT.601
+     * limited range (I420), BT.601 full range (J420) and BT.709 limited range (H420),
+     * it has no BT.709 full range and no BT.2020 conversion.
+     */
+    public static final int COLOR_MATRIX_BT601 = NativeUtils.COLOR_MATRIX_BT601;
+    public static final int COLOR_MATRIX_BT709 = NativeUtils.COLOR_MATRIX_BT709;
+    public static final int COLOR_MATRIX_BT2020 = NativeUtils.COLOR_MATRIX_BT2020;
+    public static final int COLOR_RANGE_LIMITED = NativeUtils.COLOR_RANGE_LIMITED;
+    public static final int COLOR_RANGE_FULL = NativeUtils.COLOR_RANGE_FULL;
+
+    /**
+     * select the color matrix and range of the YUV input of the YUV420 to ARGB_8888
+     * conversions, BT.601 limited range by default. Only BT.601 limited range, BT.601
+     * full range and BT.709 limited range are supported, other pairs are ignored and
+     * the current setting is kept.
+     *
+     * @param matrix COLOR_MATRIX_BT601 or COLOR_MATRIX_BT709
+     * @param range  COLOR_RANGE_LIMITED or COLOR_RANGE_FULL, only limited for BT.709
+     */
+    public static native void setColorSpace(int matrix, int range);
+
+    /**
+     * get the color matrix of the YUV420 to ARGB_8888 conversions
+     *
+     * @return COLOR_MATRIX_BT601 or COLOR_MATRIX_BT709
+     */
+    public static native int getColorMatrix();
+
+    /**
+     * get the color range of the YUV420 to ARGB_8888 conversions
+     *
+     * @return COLOR_RANGE_LIMITED or COLOR_RANGE_FULL
+     */
+    public static native int getColorRange();
+
+    /**
+     * Byte orders of the YUV420 to ARGB_8888 conversions, same as NativeUtils. libyuv
+     * converts to ARGB and ABGR bytes with BT.601 limited range only, the other color
+     * spaces are shuffled in place after the conversion.
+     */
+    public static final int CHANNEL_ORDER_RGBA = NativeUtils.CHANNEL_ORDER_RGBA;
+    public static final int CHANNEL_ORDER_BGRA = NativeUtils.CHANNEL_ORDER_BGRA;
+    public static final int CHANNEL_ORDER_ARGB = NativeUtils.CHANNEL_ORDER_ARGB;
+    public static final int CHANNEL_ORDER_ABGR = NativeUtils.CHANNEL_ORDER_ABGR;
+
+    /**
+     * select the byte order of the YUV420 to ARGB_8888 conversions, CHANNEL_ORDER_RGBA
+     * by default
+     *
+     * @param order CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *              CHANNEL_ORDER_ABGR
+     */
+    public static native void setChannelOrder(int order);
+
+    /**
+     * get the byte order of the YUV420 to ARGB_8888 conversions
+     *
+     * @return CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     * CHANNEL_ORDER_ABGR
+     */
+    public static native int getChannelOrder();
+
     /**
      * convert I420 to ARGB_8888
      *
@@ -67,7 +130,7 @@ public class LibyuvUtils {
     public static native void NV21ToRGBA(byte[] src, byte[] dst, int width, int height);
 
     /**
-     * rotate RGB image
+     * rotate RGB image, 3 bytes per pixel in any channel order
      *
      * @param src    The input array.
      * @param dst    The output array.
@@ -27,6 +27,8 @@ import android.widget.Toast;
 import androidx.annotation.NonNull;
 import androidx.appcompat.app.AppCompatActivity;
 
+import java.util.Locale;
+
 import static android.Manifest.permission.READ_EXTERNAL_STORAGE;
 import static android.Manifest.permission.WRITE_EXTERNAL_STORAGE;
 
@@ -131,6 +133,14 @@ public class NativeTestActivity extends AppCompatActivity {
                         NativeUtils.I420ToRGBAByte(yuv420, rgba, width, height, width, width / 2, 1);
                         long end = System.currentTimeMillis();
                         Log.d(TAG, "[I420ToRGBAByte] cost time:" + (end - start));
+                        final byte[] fastRgba = new byte[width * height * 4];
+                        NativeUtils.setConvertPrecision(NativeUtils.CONVERT_PRECISION_FAST);
+                        long fastStart = System.currentTimeMillis();
+                        NativeUtils.I420ToRGBAByte(yuv420, fastRgba, width, height, width, width / 2, 1);
+                        long fastEnd = System.currentTimeMillis();
+                        NativeUtils.setConvertPrecision(NativeUtils.CONVERT_PRECISION_EXACT);
+                        Log.d(TAG, "[I420ToRGBAByte fast] cost time:" + (fastEnd - fastStart)
+                                + ", " + precisionError(rgba, fastRgba));
                         break;
                     case R.id.yv12_to_rgba_byte:
                         fileName = "yv12_3264x2448_convertByte";
@@ -149,6 +159,14 @@ public class NativeTestActivity extends AppCompatActivity {
                         NativeUtils.NV21ToRGBAByte(yuv420, rgba, width, height);
                         long end2 = System.currentTimeMillis();
                         Log.d(TAG, "[NV21ToRGBAByte] cost time:" + (end2 - start2));
+                        final byte[] fastRgba2 = new byte[width * height * 4];
+                        NativeUtils.setConvertPrecision(NativeUtils.CONVERT_PRECISION_FAST);
+                        long fastStart2 = System.currentTimeMillis();
+                        NativeUtils.NV21ToRGBAByte(yuv420, fastRgba2, width, height);
+                        long fastEnd2 = System.currentTimeMillis();
+                        NativeUtils.setConvertPrecision(NativeUtils.CONVERT_PRECISION_EXACT);
+                        Log.d(TAG, "[NV21ToRGBAByte fast] cost time:" + (fastEnd2 - fastStart2)
+                                + ", " + precisionError(rgba, fastRgba2));
                         break;
                     default:
                         throw new IllegalArgumentException("Unknown format");
@@ -164,6 +182,31 @@ public class NativeTestActivity extends AppCompatActivity {
         });
     }
 
+    /**
+     * max and mean absolute error and PSNR of the r, g, b channels of fast
+     * against exact, alpha is skipped
+     */
+    private static String precisionError(byte[] exact, byte[] fast) {
+        int maxError = 0;
+        long sumError = 0;
+        long sumSquaredError = 0;
+        long count = 0;
+        for (int i = 0; i < exact.length; i++) {
+            if ((i & 3) == 3) {
+                continue;
+            }
+            int error = Math.abs((exact[i] & 0xff) - (fast[i] & 0xff));
+            maxError = Math.max(maxError, error);
+            sumError += error;
+            sumSquaredError += error * error;
+            count++;
+        }
+        double mse = (double) sumSquaredError / count;
+        double psnr = mse == 0 ? Double.POSITIVE_INFINITY : 10 * Math.log10(255.0 * 255.0 / mse);
+        return String.format(Locale.US, "max error:%d, mean error:%.4f, PSNR:%.2fdB",
+                maxError, (double) sumError / count, psnr);
+    }
+
     private void convertInt(final int id) {
         TaskExecutor.run(new Runnable() {
             @Override
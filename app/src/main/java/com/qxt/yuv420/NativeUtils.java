@@ -16,6 +16,7 @@
  */
 package com.qxt.yuv420;
 
+import java.nio.ByteBuffer;
 
 /**
  * @author Tyler Qiu
@@ -27,57 +28,948 @@ public class NativeUtils {
      * YYYYYYYY VV UU    =>YV12  =>YUV420P
      * YYYYYYYY UV UV    =>NV12  =>YUV420SP
      * YYYYYYYY VU VU    =>NV21  =>YUV420SP
+     *
+     * The planes of a YUV420P array are stored one after another, height rows of
+     * yRowStride bytes followed by (height + 1) / 2 rows of uvRowStride bytes for
+     * each chroma plane.
      */
     static {
         System.loadLibrary("NativeUtils");
     }
 
     /**
-     * convert I420 to ARGB_8888
+     * Multiply-add per pixel, with NEON/SSE4.1/AVX2 row kernels where available.
+     */
+    public static final int CONVERT_ENGINE_ARITHMETIC = 0;
+
+    /**
+     * Scalar lookup tables, the fastest choice on cores without SIMD.
+     */
+    public static final int CONVERT_ENGINE_TABLE = 1;
+
+    /**
+     * select the engine used by the YUV420 to ARGB_8888 conversions
+     *
+     * @param engine CONVERT_ENGINE_ARITHMETIC or CONVERT_ENGINE_TABLE
+     */
+    public static native void setConvertEngine(int engine);
+
+    /**
+     * get the engine used by the YUV420 to ARGB_8888 conversions
+     *
+     * @return CONVERT_ENGINE_ARITHMETIC or CONVERT_ENGINE_TABLE
+     */
+    public static native int getConvertEngine();
+
+    /**
+     * 32-bit fixed point, bit-exact on every engine and cpu.
+     */
+    public static final int CONVERT_PRECISION_EXACT = 0;
+
+    /**
+     * 16-bit fixed point with twice the SIMD lanes, every channel within 2 of
+     * CONVERT_PRECISION_EXACT. Good enough for previews and ML input.
+     */
+    public static final int CONVERT_PRECISION_FAST = 1;
+
+    /**
+     * select the precision of the YUV420 to ARGB_8888 conversions. Fast precision
+     * replaces the engine, it is not used by conversions with color adjustments.
+     *
+     * @param precision CONVERT_PRECISION_EXACT or CONVERT_PRECISION_FAST
+     */
+    public static native void setConvertPrecision(int precision);
+
+    /**
+     * get the precision of the YUV420 to ARGB_8888 conversions
+     *
+     * @return CONVERT_PRECISION_EXACT or CONVERT_PRECISION_FAST
+     */
+    public static native int getConvertPrecision();
+
+    /**
+     * One conversion thread per cpu.
+     */
+    public static final int CONVERT_THREADS_AUTO = 0;
+
+    /**
+     * set the number of threads used by the YUV420 to ARGB_8888 conversions, the
+     * calling thread included. Frames smaller than 640x480 always use one thread.
+     *
+     * @param threads CONVERT_THREADS_AUTO, or 1 to the cpu count, 1 stays on the calling thread
+     */
+    public static native void setConvertThreads(int threads);
+
+    /**
+     * get the number of threads used by the YUV420 to ARGB_8888 conversions
+     *
+     * @return CONVERT_THREADS_AUTO or the number of threads
+     */
+    public static native int getConvertThreads();
+
+    /**
+     * Every chroma sample covers its 2x2 block.
+     */
+    public static final int CHROMA_UPSAMPLING_NEAREST = 0;
+
+    /**
+     * Chroma interpolated for every pixel, co-sited with the even columns and
+     * between two rows like MPEG-2. Smoother edges for a small extra cost.
+     */
+    public static final int CHROMA_UPSAMPLING_BILINEAR = 1;
+
+    /**
+     * select the chroma upsampling of the YUV420 to ARGB_8888 conversions
+     *
+     * @param upsampling CHROMA_UPSAMPLING_NEAREST or CHROMA_UPSAMPLING_BILINEAR
+     */
+    public static native void setChromaUpsampling(int upsampling);
+
+    /**
+     * get the chroma upsampling of the YUV420 to ARGB_8888 conversions
+     *
+     * @return CHROMA_UPSAMPLING_NEAREST or CHROMA_UPSAMPLING_BILINEAR
+     */
+    public static native int getChromaUpsampling();
+
+    /**
+     * ITU-R BT.601 color matrix, SD video and JPEG.
+     */
+    public static final int COLOR_MATRIX_BT601 = 0;
+
+    /**
+     * ITU-R BT.709 color matrix, HD video.
+     */
+    public static final int COLOR_MATRIX_BT709 = 1;
+
+    /**
+     * ITU-R BT.2020 non-constant luminance color matrix, UHD video.
+     */
+    public static final int COLOR_MATRIX_BT2020 = 2;
+
+    /**
+     * Y in [16, 235] and UV in [16, 240], most video sources.
+     */
+    public static final int COLOR_RANGE_LIMITED = 0;
+
+    /**
+     * Y and UV in [0, 255], JPEG YCbCr.
+     */
+    public static final int COLOR_RANGE_FULL = 1;
+
+    /**
+     * select the color matrix and range of the YUV input of the YUV420 to ARGB_8888
+     * conversions, BT.601 limited range by default
+     *
+     * @param matrix COLOR_MATRIX_BT601, COLOR_MATRIX_BT709 or COLOR_MATRIX_BT2020
+     * @param range  COLOR_RANGE_LIMITED or COLOR_RANGE_FULL
+     */
+    public static native void setColorSpace(int matrix, int range);
+
+    /**
+     * get the color matrix of the YUV420 to ARGB_8888 conversions
+     *
+     * @return COLOR_MATRIX_BT601, COLOR_MATRIX_BT709 or COLOR_MATRIX_BT2020
+     */
+    public static native int getColorMatrix();
+
+    /**
+     * get the color range of the YUV420 to ARGB_8888 conversions
+     *
+     * @return COLOR_RANGE_LIMITED or COLOR_RANGE_FULL
+     */
+    public static native int getColorRange();
+
+    /**
+     * R, G, B, A bytes, what Bitmap.copyPixelsFromBuffer expects for ARGB_8888.
+     */
+    public static final int CHANNEL_ORDER_RGBA = 0;
+
+    /**
+     * B, G, R, A bytes, e.g. OpenCV BGRA and the little-endian memory of ARGB ints.
+     */
+    public static final int CHANNEL_ORDER_BGRA = 1;
+
+    /**
+     * A, R, G, B bytes.
+     */
+    public static final int CHANNEL_ORDER_ARGB = 2;
+
+    /**
+     * A, B, G, R bytes.
+     */
+    public static final int CHANNEL_ORDER_ABGR = 3;
+
+    /**
+     * select the default byte order of the YUV420 to ARGB_8888 byte array conversions,
+     * used by the overloads without a channelOrder, CHANNEL_ORDER_RGBA at first. It is
+     * shared by the whole process, pass channelOrder instead where threads differ. Every
+     * order is written directly, at the cost of RGBA. The int array conversions always
+     * output ARGB ints.
+     *
+     * @param order CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *              CHANNEL_ORDER_ABGR
+     */
+    public static native void setChannelOrder(int order);
+
+    /**
+     * get the default byte order of the YUV420 to ARGB_8888 byte array conversions
+     *
+     * @return CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     * CHANNEL_ORDER_ABGR
+     */
+    public static native int getChannelOrder();
+
+    /**
+     * fold color adjustments into the YUV420 to ARGB_8888 conversions, they cost no
+     * extra pass over the image. They are applied to the RGB result of the selected
+     * color space in this order: saturation, white balance gains, color correction
+     * matrix, contrast, brightness. The adjusted conversions always use
+     * CONVERT_ENGINE_ARITHMETIC.
+     *
+     * @param whiteBalanceGains     r, g, b gains, null for none
+     * @param colorCorrectionMatrix 3x3 row-major color correction matrix, null for none
+     * @param brightness            added to every channel, in 8-bit units, 0 for none,
+     *                              clamped to [-255, 255]
+     * @param contrast              gain around 128, 1 for none, clamped to [-16, 16]
+     * @param saturation            chroma gain, 1 for none, 0 for gray
+     */
+    public static native void setColorAdjustment(float[] whiteBalanceGains,
+                                                 float[] colorCorrectionMatrix,
+                                                 float brightness, float contrast,
+                                                 float saturation);
+
+    /**
+     * remove the color adjustments of setColorAdjustment
+     */
+    public static native void clearColorAdjustment();
+
+    /**
+     * I420ToRGBAByte in the order of setChannelOrder
+     */
+    public static void I420ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                      int yRowStride, int uvRowStride, int uvPixelStride) {
+        I420ToRGBAByte(src, dst, width, height, yRowStride, uvRowStride, uvPixelStride,
+                       getChannelOrder());
+    }
+
+    /**
+     * convert I420 to ARGB_8888
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param channelOrder  CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                      CHANNEL_ORDER_ABGR
+     */
+    public static native void I420ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int uvPixelStride,
+                                             int channelOrder);
+
+    /**
+     * convert I420 to ARGB_8888
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void I420ToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                            int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * YV12ToRGBAByte in the order of setChannelOrder
+     */
+    public static void YV12ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                      int yRowStride, int uvRowStride, int uvPixelStride) {
+        YV12ToRGBAByte(src, dst, width, height, yRowStride, uvRowStride, uvPixelStride,
+                       getChannelOrder());
+    }
+
+    /**
+     * convert YV12 to ARGB_8888
+     *
+     * @param src           src YV12 byte array
+     * @param dst           dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param channelOrder  CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                      CHANNEL_ORDER_ABGR
+     */
+    public static native void YV12ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int uvPixelStride,
+                                             int channelOrder);
+
+    /**
+     * convert YV12 to ARGB_8888
+     *
+     * @param src           src YV12 byte array
+     * @param dst           dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void YV12ToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                            int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * NV12ToRGBAByte in the order of setChannelOrder
+     */
+    public static void NV12ToRGBAByte(byte[] src, byte[] dst, int width, int height) {
+        NV12ToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert NV12 to ARGB_8888
+     *
+     * @param src          src NV12 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void NV12ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert NV12 to ARGB_8888
+     *
+     * @param src      src NV12 byte array
+     * @param dst      dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV12ToRGBAInt(byte[] src, int[] dst, int width, int height);
+
+    /**
+     * NV21ToRGBAByte in the order of setChannelOrder
+     */
+    public static void NV21ToRGBAByte(byte[] src, byte[] dst, int width, int height) {
+        NV21ToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert NV21 to ARGB_8888
+     *
+     * @param src          src NV21 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void NV21ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert NV21 to ARGB_8888
+     *
+     * @param src      src NV21 byte array
+     * @param dst      dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV21ToRGBAInt(byte[] src, int[] dst, int width, int height);
+
+    /**
+     * convert I420 to RGB_565
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst RGB565 byte array, the length of the dst array must be >= width*height*2
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param dither        add a 4x4 ordered dither against banding
+     */
+    public static native void I420ToRGB565(byte[] src, byte[] dst, int width, int height,
+                                           int yRowStride, int uvRowStride, int uvPixelStride,
+                                           boolean dither);
+
+    /**
+     * convert YV12 to RGB_565
+     *
+     * @param src           src YV12 byte array
+     * @param dst           dst RGB565 byte array, the length of the dst array must be >= width*height*2
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param dither        add a 4x4 ordered dither against banding
+     */
+    public static native void YV12ToRGB565(byte[] src, byte[] dst, int width, int height,
+                                           int yRowStride, int uvRowStride, int uvPixelStride,
+                                           boolean dither);
+
+    /**
+     * convert NV12 to RGB_565
+     *
+     * @param src      src NV12 byte array
+     * @param dst      dst RGB565 byte array, the length of the dst array must be >= width*height*2
+     * @param width    image width
+     * @param height   image height
+     * @param dither   add a 4x4 ordered dither against banding
+     */
+    public static native void NV12ToRGB565(byte[] src, byte[] dst, int width, int height,
+                                           boolean dither);
+
+    /**
+     * convert NV21 to RGB_565
+     *
+     * @param src      src NV21 byte array
+     * @param dst      dst RGB565 byte array, the length of the dst array must be >= width*height*2
+     * @param width    image width
+     * @param height   image height
+     * @param dither   add a 4x4 ordered dither against banding
+     */
+    public static native void NV21ToRGB565(byte[] src, byte[] dst, int width, int height,
+                                           boolean dither);
+
+    /**
+     * convert I420 to RGB24, R, G, B bytes
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst RGB24 byte array, the length of the dst array must be >= width*height*3
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void I420ToRGB24(byte[] src, byte[] dst, int width, int height,
+                                          int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * convert YV12 to RGB24, R, G, B bytes
+     *
+     * @param src           src YV12 byte array
+     * @param dst           dst RGB24 byte array, the length of the dst array must be >= width*height*3
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void YV12ToRGB24(byte[] src, byte[] dst, int width, int height,
+                                          int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * convert NV12 to RGB24, R, G, B bytes
+     *
+     * @param src      src NV12 byte array
+     * @param dst      dst RGB24 byte array, the length of the dst array must be >= width*height*3
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV12ToRGB24(byte[] src, byte[] dst, int width, int height);
+
+    /**
+     * convert NV21 to RGB24, R, G, B bytes
+     *
+     * @param src      src NV21 byte array
+     * @param dst      dst RGB24 byte array, the length of the dst array must be >= width*height*3
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV21ToRGB24(byte[] src, byte[] dst, int width, int height);
+
+    /**
+     * convert I420 to 8-bit gray
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst Gray byte array, the length of the dst array must be >= width*height
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void I420ToGray(byte[] src, byte[] dst, int width, int height,
+                                         int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * convert YV12 to 8-bit gray
+     *
+     * @param src           src YV12 byte array
+     * @param dst           dst Gray byte array, the length of the dst array must be >= width*height
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     */
+    public static native void YV12ToGray(byte[] src, byte[] dst, int width, int height,
+                                         int yRowStride, int uvRowStride, int uvPixelStride);
+
+    /**
+     * convert NV12 to 8-bit gray
+     *
+     * @param src      src NV12 byte array
+     * @param dst      dst Gray byte array, the length of the dst array must be >= width*height
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV12ToGray(byte[] src, byte[] dst, int width, int height);
+
+    /**
+     * convert NV21 to 8-bit gray
+     *
+     * @param src      src NV21 byte array
+     * @param dst      dst Gray byte array, the length of the dst array must be >= width*height
+     * @param width    image width
+     * @param height   image height
+     */
+    public static native void NV21ToGray(byte[] src, byte[] dst, int width, int height);
+
+    /**
+     * The float outputs hold the encoded values, v / 255.
+     */
+    public static final int LINEARIZE_NONE = 0;
+
+    /**
+     * The float outputs are linear light, decoded with the sRGB EOTF.
+     */
+    public static final int LINEARIZE_SRGB = 1;
+
+    /**
+     * The float outputs are linear light, decoded with the BT.1886 EOTF, v ^ 2.4.
+     */
+    public static final int LINEARIZE_BT1886 = 2;
+
+    /**
+     * convert I420 to float R, G, B, A in [0, 1]
+     *
+     * @param src           src I420 byte array
+     * @param dst           dst float[] array, the length of the dst array must be >= width*height*4
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param linearize     LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void I420ToRGBAFloat(byte[] src, float[] dst, int width, int height,
+                                              int yRowStride, int uvRowStride, int uvPixelStride,
+                                              int linearize);
+
+    /**
+     * convert YV12 to float R, G, B, A in [0, 1]
      *
-     * @param src           src I420 byte array
-     * @param dst           dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param src           src YV12 byte array
+     * @param dst           dst float[] array, the length of the dst array must be >= width*height*4
      * @param width         image width
      * @param height        image height
      * @param yRowStride    The row stride of plane y.
      * @param uvRowStride   The row stride of plane u or v.
      * @param uvPixelStride The pixel stride of plane u or v.
+     * @param linearize     LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
      */
-    public static native void I420ToRGBAByte(byte[] src, byte[] dst, int width, int height,
-                                             int yRowStride, int uvRowStride, int uvPixelStride);
+    public static native void YV12ToRGBAFloat(byte[] src, float[] dst, int width, int height,
+                                              int yRowStride, int uvRowStride, int uvPixelStride,
+                                              int linearize);
 
     /**
-     * convert I420 to ARGB_8888
+     * convert NV12 to float R, G, B, A in [0, 1]
+     *
+     * @param src       src NV12 byte array
+     * @param dst       dst float[] array, the length of the dst array must be >= width*height*4
+     * @param width     image width
+     * @param height    image height
+     * @param linearize LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void NV12ToRGBAFloat(byte[] src, float[] dst, int width, int height,
+                                              int linearize);
+
+    /**
+     * convert NV21 to float R, G, B, A in [0, 1]
+     *
+     * @param src       src NV21 byte array
+     * @param dst       dst float[] array, the length of the dst array must be >= width*height*4
+     * @param width     image width
+     * @param height    image height
+     * @param linearize LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void NV21ToRGBAFloat(byte[] src, float[] dst, int width, int height,
+                                              int linearize);
+
+    /**
+     * convert I420 to half float R, G, B, A in [0, 1]
      *
      * @param src           src I420 byte array
-     * @param dst           dst RGBA int array, the length of the dst array must be >= width*height
+     * @param dst           dst short[] array, the length of the dst array must be >= width*height*4
      * @param width         image width
      * @param height        image height
      * @param yRowStride    The row stride of plane y.
      * @param uvRowStride   The row stride of plane u or v.
      * @param uvPixelStride The pixel stride of plane u or v.
+     * @param linearize     LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
      */
-    public static native void I420ToRGBAInt(byte[] src, int[] dst, int width, int height,
-                                            int yRowStride, int uvRowStride, int uvPixelStride);
+    public static native void I420ToRGBAHalf(byte[] src, short[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int uvPixelStride,
+                                             int linearize);
 
     /**
-     * convert YV12 to ARGB_8888
+     * convert YV12 to half float R, G, B, A in [0, 1]
      *
      * @param src           src YV12 byte array
+     * @param dst           dst short[] array, the length of the dst array must be >= width*height*4
+     * @param width         image width
+     * @param height        image height
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param linearize     LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void YV12ToRGBAHalf(byte[] src, short[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int uvPixelStride,
+                                             int linearize);
+
+    /**
+     * convert NV12 to half float R, G, B, A in [0, 1]
+     *
+     * @param src       src NV12 byte array
+     * @param dst       dst short[] array, the length of the dst array must be >= width*height*4
+     * @param width     image width
+     * @param height    image height
+     * @param linearize LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void NV12ToRGBAHalf(byte[] src, short[] dst, int width, int height,
+                                             int linearize);
+
+    /**
+     * convert NV21 to half float R, G, B, A in [0, 1]
+     *
+     * @param src       src NV21 byte array
+     * @param dst       dst short[] array, the length of the dst array must be >= width*height*4
+     * @param width     image width
+     * @param height    image height
+     * @param linearize LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void NV21ToRGBAHalf(byte[] src, short[] dst, int width, int height,
+                                             int linearize);
+
+    /**
+     * I010ToRGBAByte in the order of setChannelOrder
+     */
+    public static void I010ToRGBAByte(short[] src, byte[] dst, int width, int height,
+                                      int yRowStride, int uvRowStride) {
+        I010ToRGBAByte(src, dst, width, height, yRowStride, uvRowStride, getChannelOrder());
+    }
+
+    /**
+     * convert I010 to RGBA bytes
+     * The 10-bit channels are converted with the color space and adjustments of
+     * the 8-bit conversions, reduced to 8 bits and stored in the order of channelOrder.
+     *
+     * @param src          src I010 short array, 10-bit samples in the low bits
+     * @param dst          dst byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param yRowStride   The row stride of plane y, in samples.
+     * @param uvRowStride  The row stride of plane u or v, in samples.
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void I010ToRGBAByte(short[] src, byte[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int channelOrder);
+
+    /**
+     * convert I010 to r | g << 10 | b << 20 | 3 << 30 ints, like Bitmap.Config.RGBA_1010102
+     *
+     * @param src         src I010 short array, 10-bit samples in the low bits
+     * @param dst         dst int array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y, in samples.
+     * @param uvRowStride The row stride of plane u or v, in samples.
+     */
+    public static native void I010ToRGBA1010102(short[] src, int[] dst, int width, int height,
+                                                int yRowStride, int uvRowStride);
+
+    /**
+     * convert I010 to half float R, G, B, A in [0, 1]
+     *
+     * @param src         src I010 short array, 10-bit samples in the low bits
+     * @param dst         dst short[] array, the length of the dst array must be >= width*height*4
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y, in samples.
+     * @param uvRowStride The row stride of plane u or v, in samples.
+     * @param linearize   LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void I010ToRGBAHalf(short[] src, short[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int linearize);
+
+    /**
+     * P010ToRGBAByte in the order of setChannelOrder
+     */
+    public static void P010ToRGBAByte(short[] src, byte[] dst, int width, int height) {
+        P010ToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert P010 to RGBA bytes
+     * The 10-bit channels are converted with the color space and adjustments of
+     * the 8-bit conversions, reduced to 8 bits and stored in the order of channelOrder.
+     *
+     * @param src          src P010 short array, 10-bit samples in the high bits
+     * @param dst          dst byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void P010ToRGBAByte(short[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert P010 to r | g << 10 | b << 20 | 3 << 30 ints, like Bitmap.Config.RGBA_1010102
+     *
+     * @param src    src P010 short array, 10-bit samples in the high bits
+     * @param dst    dst int array, the length of the dst array must be >= width*height
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void P010ToRGBA1010102(short[] src, int[] dst, int width, int height);
+
+    /**
+     * convert P010 to half float R, G, B, A in [0, 1]
+     *
+     * @param src       src P010 short array, 10-bit samples in the high bits
+     * @param dst       dst short[] array, the length of the dst array must be >= width*height*4
+     * @param width     image width
+     * @param height    image height
+     * @param linearize LINEARIZE_NONE, LINEARIZE_SRGB or LINEARIZE_BT1886
+     */
+    public static native void P010ToRGBAHalf(short[] src, short[] dst, int width, int height,
+                                             int linearize);
+
+    /**
+     * I422ToRGBAByte in the order of setChannelOrder
+     */
+    public static void I422ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                      int yRowStride, int uvRowStride) {
+        I422ToRGBAByte(src, dst, width, height, yRowStride, uvRowStride, getChannelOrder());
+    }
+
+    /**
+     * convert I422 to ARGB_8888
+     * 4:2:2 planar, the u and v planes have a row per row of y.
+     *
+     * @param src          src I422 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param yRowStride   The row stride of plane y.
+     * @param uvRowStride  The row stride of plane u or v.
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void I422ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int channelOrder);
+
+    /**
+     * convert I422 to ARGB_8888
+     * 4:2:2 planar, the u and v planes have a row per row of y.
+     *
+     * @param src         src I422 byte array
+     * @param dst         dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y.
+     * @param uvRowStride The row stride of plane u or v.
+     */
+    public static native void I422ToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                            int yRowStride, int uvRowStride);
+
+    /**
+     * NV16ToRGBAByte in the order of setChannelOrder
+     */
+    public static void NV16ToRGBAByte(byte[] src, byte[] dst, int width, int height) {
+        NV16ToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert NV16 to ARGB_8888
+     * 4:2:2 semi-planar, the interleaved uv plane has a row per row of y.
+     *
+     * @param src          src NV16 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void NV16ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert NV16 to ARGB_8888
+     * 4:2:2 semi-planar, the interleaved uv plane has a row per row of y.
+     *
+     * @param src    src NV16 byte array
+     * @param dst    dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void NV16ToRGBAInt(byte[] src, int[] dst, int width, int height);
+
+    /**
+     * I444ToRGBAByte in the order of setChannelOrder
+     */
+    public static void I444ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                      int yRowStride, int uvRowStride) {
+        I444ToRGBAByte(src, dst, width, height, yRowStride, uvRowStride, getChannelOrder());
+    }
+
+    /**
+     * convert I444 to ARGB_8888
+     * 4:4:4 planar, the u and v planes are the size of plane y.
+     *
+     * @param src          src I444 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param yRowStride   The row stride of plane y.
+     * @param uvRowStride  The row stride of plane u or v.
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void I444ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int yRowStride, int uvRowStride, int channelOrder);
+
+    /**
+     * convert I444 to ARGB_8888
+     * 4:4:4 planar, the u and v planes are the size of plane y.
+     *
+     * @param src         src I444 byte array
+     * @param dst         dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y.
+     * @param uvRowStride The row stride of plane u or v.
+     */
+    public static native void I444ToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                            int yRowStride, int uvRowStride);
+
+    /**
+     * YUY2ToRGBAByte in the order of setChannelOrder
+     */
+    public static void YUY2ToRGBAByte(byte[] src, byte[] dst, int width, int height) {
+        YUY2ToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert YUY2 to ARGB_8888
+     * 4:2:2 packed, Y0 U Y1 V for every two pixels.
+     *
+     * @param src          src YUY2 byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void YUY2ToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert YUY2 to ARGB_8888
+     * 4:2:2 packed, Y0 U Y1 V for every two pixels.
+     *
+     * @param src    src YUY2 byte array
+     * @param dst    dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void YUY2ToRGBAInt(byte[] src, int[] dst, int width, int height);
+
+    /**
+     * UYVYToRGBAByte in the order of setChannelOrder
+     */
+    public static void UYVYToRGBAByte(byte[] src, byte[] dst, int width, int height) {
+        UYVYToRGBAByte(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert UYVY to ARGB_8888
+     * 4:2:2 packed, U Y0 V Y1 for every two pixels.
+     *
+     * @param src          src UYVY byte array
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void UYVYToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert UYVY to ARGB_8888
+     * 4:2:2 packed, U Y0 V Y1 for every two pixels.
+     *
+     * @param src    src UYVY byte array
+     * @param dst    dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void UYVYToRGBAInt(byte[] src, int[] dst, int width, int height);
+
+    /**
+     * YUV420888ToRGBAByte in the order of setChannelOrder
+     */
+    public static void YUV420888ToRGBAByte(ByteBuffer y, ByteBuffer u, ByteBuffer v,
+                                           byte[] dst, int width, int height,
+                                           int yRowStride, int uvRowStride,
+                                           int uvPixelStride) {
+        YUV420888ToRGBAByte(y, u, v, dst, width, height, yRowStride, uvRowStride, uvPixelStride,
+                            getChannelOrder());
+    }
+
+    /**
+     * convert YUV_420_888 planes to ARGB_8888, e.g. the planes of an
+     * android.media.Image, without repacking them
+     *
+     * @param y             plane y, a direct ByteBuffer
+     * @param u             plane u, a direct ByteBuffer
+     * @param v             plane v, a direct ByteBuffer
      * @param dst           dst RGBA byte array, the length of the dst array must be >= width*height*4
      * @param width         image width
      * @param height        image height
      * @param yRowStride    The row stride of plane y.
      * @param uvRowStride   The row stride of plane u or v.
      * @param uvPixelStride The pixel stride of plane u or v.
+     * @param channelOrder  CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                      CHANNEL_ORDER_ABGR
      */
-    public static native void YV12ToRGBAByte(byte[] src, byte[] dst, int width, int height,
-                                             int yRowStride, int uvRowStride, int uvPixelStride);
+    public static native void YUV420888ToRGBAByte(ByteBuffer y, ByteBuffer u, ByteBuffer v,
+                                                  byte[] dst, int width, int height,
+                                                  int yRowStride, int uvRowStride,
+                                                  int uvPixelStride, int channelOrder);
 
     /**
-     * convert YV12 to ARGB_8888
+     * convert YUV_420_888 planes to ARGB_8888, e.g. the planes of an
+     * android.media.Image, without repacking them
      *
-     * @param src           src YV12 byte array
+     * @param y             plane y, a direct ByteBuffer
+     * @param u             plane u, a direct ByteBuffer
+     * @param v             plane v, a direct ByteBuffer
      * @param dst           dst RGBA int array, the length of the dst array must be >= width*height
      * @param width         image width
      * @param height        image height
@@ -85,51 +977,279 @@ public class NativeUtils {
      * @param uvRowStride   The row stride of plane u or v.
      * @param uvPixelStride The pixel stride of plane u or v.
      */
-    public static native void YV12ToRGBAInt(byte[] src, int[] dst, int width, int height,
-                                            int yRowStride, int uvRowStride, int uvPixelStride);
+    public static native void YUV420888ToRGBAInt(ByteBuffer y, ByteBuffer u, ByteBuffer v,
+                                                 int[] dst, int width, int height,
+                                                 int yRowStride, int uvRowStride,
+                                                 int uvPixelStride);
 
     /**
-     * convert NV12 to ARGB_8888
+     * copy the luma of a YUV420 image to 8-bit gray, only plane y is read
      *
-     * @param src      src NV12 byte array
-     * @param dst      dst RGBA byte array, the length of the dst array must be >= width*height*4
-     * @param width    image width
-     * @param height   image height
+     * @param src         src YUV420 byte array, any of I420, YV12, NV12 and NV21
+     * @param dst         dst gray byte array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y.
+     * @param expandRange stretch limited range luma to [0, 255]
      */
-    public static native void NV12ToRGBAByte(byte[] src, byte[] dst, int width, int height);
+    public static native void lumaToGray(byte[] src, byte[] dst, int width, int height,
+                                         int yRowStride, boolean expandRange);
 
     /**
-     * convert NV12 to ARGB_8888
+     * lumaToRGBAByte in the order of setChannelOrder
+     */
+    public static void lumaToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                      int yRowStride, boolean expandRange) {
+        lumaToRGBAByte(src, dst, width, height, yRowStride, expandRange, getChannelOrder());
+    }
+
+    /**
+     * convert the luma of a YUV420 image to gray ARGB_8888, only plane y is read
      *
-     * @param src      src NV12 byte array
-     * @param dst      dst RGBA int array, the length of the dst array must be >= width*height
-     * @param width    image width
-     * @param height   image height
+     * @param src          src YUV420 byte array, any of I420, YV12, NV12 and NV21
+     * @param dst          dst RGBA byte array, the length of the dst array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param yRowStride   The row stride of plane y.
+     * @param expandRange  stretch limited range luma to [0, 255]
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
      */
-    public static native void NV12ToRGBAInt(byte[] src, int[] dst, int width, int height);
+    public static native void lumaToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                             int yRowStride, boolean expandRange, int channelOrder);
 
     /**
-     * convert NV21 to ARGB_8888
+     * convert the luma of a YUV420 image to gray ARGB_8888, only plane y is read
      *
-     * @param src      src NV21 byte array
-     * @param dst      dst RGBA byte array, the length of the dst array must be >= width*height*4
-     * @param width    image width
-     * @param height   image height
+     * @param src         src YUV420 byte array, any of I420, YV12, NV12 and NV21
+     * @param dst         dst RGBA int array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y.
+     * @param expandRange stretch limited range luma to [0, 255]
      */
-    public static native void NV21ToRGBAByte(byte[] src, byte[] dst, int width, int height);
+    public static native void lumaToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                            int yRowStride, boolean expandRange);
 
     /**
-     * convert NV21 to ARGB_8888
+     * copy plane y of YUV_420_888 planes to 8-bit gray, e.g. the first plane
+     * of an android.media.Image
      *
-     * @param src      src NV21 byte array
-     * @param dst      dst RGBA int array, the length of the dst array must be >= width*height
-     * @param width    image width
-     * @param height   image height
+     * @param y           plane y, a direct ByteBuffer
+     * @param dst         dst gray byte array, the length of the dst array must be >= width*height
+     * @param width       image width
+     * @param height      image height
+     * @param yRowStride  The row stride of plane y.
+     * @param expandRange stretch limited range luma to [0, 255]
      */
-    public static native void NV21ToRGBAInt(byte[] src, int[] dst, int width, int height);
+    public static native void YUV420888LumaToGray(ByteBuffer y, byte[] dst, int width, int height,
+                                                  int yRowStride, boolean expandRange);
+
+    /**
+     * RGBAByteToI420 in the order of setChannelOrder
+     */
+    public static void RGBAByteToI420(byte[] src, byte[] dst, int width, int height) {
+        RGBAByteToI420(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert RGBA to I420 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src          src RGBA byte array in the order of channelOrder
+     * @param dst          dst I420 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void RGBAByteToI420(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * RGBAByteToNV12 in the order of setChannelOrder
+     */
+    public static void RGBAByteToNV12(byte[] src, byte[] dst, int width, int height) {
+        RGBAByteToNV12(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert RGBA to NV12 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src          src RGBA byte array in the order of channelOrder
+     * @param dst          dst NV12 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void RGBAByteToNV12(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * RGBAByteToNV21 in the order of setChannelOrder
+     */
+    public static void RGBAByteToNV21(byte[] src, byte[] dst, int width, int height) {
+        RGBAByteToNV21(src, dst, width, height, getChannelOrder());
+    }
+
+    /**
+     * convert RGBA to NV21 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src          src RGBA byte array in the order of channelOrder
+     * @param dst          dst NV21 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width        image width
+     * @param height       image height
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void RGBAByteToNV21(byte[] src, byte[] dst, int width, int height,
+                                             int channelOrder);
+
+    /**
+     * convert RGBA to I420 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src    src ARGB int array
+     * @param dst    dst I420 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void RGBAIntToI420(int[] src, byte[] dst, int width, int height);
+
+    /**
+     * convert RGBA to NV12 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src    src ARGB int array
+     * @param dst    dst NV12 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void RGBAIntToNV12(int[] src, byte[] dst, int width, int height);
 
     /**
-     * rotate RGB image
+     * convert RGBA to NV21 with the color space of setColorSpace, each chroma
+     * sample from the average of its 2x2 block
+     *
+     * @param src    src ARGB int array
+     * @param dst    dst NV21 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width  image width
+     * @param height image height
+     */
+    public static native void RGBAIntToNV21(int[] src, byte[] dst, int width, int height);
+
+    /**
+     * MIPI RAW10 like ImageFormat.RAW10, 4 pixels in 5 bytes.
+     */
+    public static final int RAW_FORMAT_RAW10 = 0;
+
+    /**
+     * MIPI RAW12 like ImageFormat.RAW12, 2 pixels in 3 bytes.
+     */
+    public static final int RAW_FORMAT_RAW12 = 1;
+
+    /**
+     * Little-endian 16-bit samples like ImageFormat.RAW_SENSOR.
+     */
+    public static final int RAW_FORMAT_RAW16 = 2;
+
+    /**
+     * The color filter arrangements, the same values as
+     * CameraCharacteristics.SENSOR_INFO_COLOR_FILTER_ARRANGEMENT.
+     */
+    public static final int CFA_RGGB = 0;
+
+    public static final int CFA_GRBG = 1;
+
+    public static final int CFA_GBRG = 2;
+
+    public static final int CFA_BGGR = 3;
+
+    /**
+     * unpack Bayer RAW into 16-bit samples
+     *
+     * @param src       src RAW byte array
+     * @param dst       dst short array, the length of the dst array must be >= width*height
+     * @param width     image width
+     * @param height    image height
+     * @param rowStride The row stride of src, in bytes.
+     * @param format    RAW_FORMAT_RAW10, RAW_FORMAT_RAW12 or RAW_FORMAT_RAW16
+     */
+    public static native void unpackRAW(byte[] src, short[] dst, int width, int height,
+                                        int rowStride, int format);
+
+    /**
+     * RAWToRGBAByte in the order of setChannelOrder
+     */
+    public static void RAWToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                     int rowStride, int format, int cfa, int blackLevel,
+                                     int whiteLevel) {
+        RAWToRGBAByte(src, dst, width, height, rowStride, format, cfa, blackLevel, whiteLevel,
+                      getChannelOrder());
+    }
+
+    /**
+     * convert Bayer RAW to RGBA bytes with a bilinear demosaic, [blackLevel, whiteLevel] is
+     * mapped to [0, 255] and no white balance is applied. whiteLevel - blackLevel must be >= 256.
+     *
+     * @param src          src RAW byte array
+     * @param dst          dst byte array in the order of channelOrder, the length of the dst
+     *                     array must be >= width*height*4
+     * @param width        image width
+     * @param height       image height
+     * @param rowStride    The row stride of src, in bytes.
+     * @param format       RAW_FORMAT_RAW10, RAW_FORMAT_RAW12 or RAW_FORMAT_RAW16
+     * @param cfa          CFA_RGGB, CFA_GRBG, CFA_GBRG or CFA_BGGR
+     * @param blackLevel   The sample value of black.
+     * @param whiteLevel   The sample value of white.
+     * @param channelOrder CHANNEL_ORDER_RGBA, CHANNEL_ORDER_BGRA, CHANNEL_ORDER_ARGB or
+     *                     CHANNEL_ORDER_ABGR
+     */
+    public static native void RAWToRGBAByte(byte[] src, byte[] dst, int width, int height,
+                                            int rowStride, int format, int cfa, int blackLevel,
+                                            int whiteLevel, int channelOrder);
+
+    /**
+     * convert Bayer RAW to ARGB ints with a bilinear demosaic, [blackLevel, whiteLevel] is
+     * mapped to [0, 255] and no white balance is applied. whiteLevel - blackLevel must be >= 256.
+     *
+     * @param src        src RAW byte array
+     * @param dst        dst int array, the length of the dst array must be >= width*height
+     * @param width      image width
+     * @param height     image height
+     * @param rowStride  The row stride of src, in bytes.
+     * @param format     RAW_FORMAT_RAW10, RAW_FORMAT_RAW12 or RAW_FORMAT_RAW16
+     * @param cfa        CFA_RGGB, CFA_GRBG, CFA_GBRG or CFA_BGGR
+     * @param blackLevel The sample value of black.
+     * @param whiteLevel The sample value of white.
+     */
+    public static native void RAWToRGBAInt(byte[] src, int[] dst, int width, int height,
+                                           int rowStride, int format, int cfa, int blackLevel,
+                                           int whiteLevel);
+
+    /**
+     * convert Bayer RAW to NV12 like RAWToRGBAByte followed by RGBAByteToNV12, without the
+     * RGBA frame in between
+     *
+     * @param src        src RAW byte array
+     * @param dst        dst NV12 byte array, the length of the dst array must be >= width*height*3/2
+     * @param width      image width
+     * @param height     image height
+     * @param rowStride  The row stride of src, in bytes.
+     * @param format     RAW_FORMAT_RAW10, RAW_FORMAT_RAW12 or RAW_FORMAT_RAW16
+     * @param cfa        CFA_RGGB, CFA_GRBG, CFA_GBRG or CFA_BGGR
+     * @param blackLevel The sample value of black.
+     * @param whiteLevel The sample value of white.
+     */
+    public static native void RAWToNV12(byte[] src, byte[] dst, int width, int height,
+                                        int rowStride, int format, int cfa, int blackLevel,
+                                        int whiteLevel);
+
+    /**
+     * rotate RGB image, 3 bytes per pixel in any channel order
      *
      * @param src    The input array.
      * @param dst    The output array.
@@ -182,4 +1302,45 @@ public class NativeUtils {
      * @param degree The rotate degree, must be 90.0f or 180.0f or 270.0f.
      */
     public static native void rotateYUV420SP(byte[] src, byte[] dst, int width, int height, float degree);
+
+    /**
+     * rotate I010 image
+     *
+     * @param src    The input array.
+     * @param dst    The output array.
+     * @param width  The width of image.
+     * @param height The height of image.
+     * @param degree The rotate degree, must be 90.0f or 180.0f or 270.0f.
+     */
+    public static native void rotateI010(short[] src, short[] dst, int width, int height, float degree);
+
+    /**
+     * rotate P010 image
+     *
+     * @param src    The input array.
+     * @param dst    The output array.
+     * @param width  The width of image.
+     * @param height The height of image.
+     * @param degree The rotate degree, must be 90.0f or 180.0f or 270.0f.
+     */
+    public static native void rotateP010(short[] src, short[] dst, int width, int height, float degree);
+
+    /**
+     * rotate YUV_420_888 planes into an I420 array
+     *
+     * @param y             plane y, a direct ByteBuffer
+     * @param u             plane u, a direct ByteBuffer
+     * @param v             plane v, a direct ByteBuffer
+     * @param dst           The output I420 array.
+     * @param width         The width of image.
+     * @param height        The height of image.
+     * @param yRowStride    The row stride of plane y.
+     * @param uvRowStride   The row stride of plane u or v.
+     * @param uvPixelStride The pixel stride of plane u or v.
+     * @param degree        The rotate degree, must be 90.0f or 180.0f or 270.0f.
+     */
+    public static native void rotateYUV420888(ByteBuffer y, ByteBuffer u, ByteBuffer v,
+                                              byte[] dst, int width, int height,
+                                              int yRowStride, int uvRowStride,
+                                              int uvPixelStride, float degree);
 }
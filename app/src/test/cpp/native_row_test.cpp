@@ -0,0 +1,545 @@
+/*
+ * Copyright 2020 Tyler Qiu.
+ * YUV420 to RGBA open source project.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compares every row kernel of native_row.h this cpu has with the scalar rows
+ * of native_utils.cpp, which are included for their static functions. Each
+ * kernel converts the part of a random row it would get in a conversion, and
+ * that part must be bit-exact with the scalar row over the whole row.
+ */
+
+#include <random>
+
+#include "native_utils.cpp"
+
+namespace native_utils {
+
+    //odd widths around the steps of the kernels, and a few random ones
+    const int TEST_WIDTHS[] = {1, 3, 7, 9, 15, 17, 31, 33, 63, 65, 127, 129, 255, 257, 1001};
+    const int TEST_RANDOM_WIDTHS = 16;
+    //past the end of every row, the kernels may read ahead
+    const int TEST_PADDING = 64;
+
+    static std::mt19937 sRandom(20200101);
+    static int sFailures = 0;
+
+    template<class T>
+    static std::vector<T> randomRow(int count, int mask) {
+        std::vector<T> row(count + TEST_PADDING);
+        for (T &sample : row) {
+            sample = static_cast<T>(sRandom() & mask);
+        }
+        return row;
+    }
+
+    static std::vector<int> testWidths() {
+        std::vector<int> widths(std::begin(TEST_WIDTHS), std::end(TEST_WIDTHS));
+        for (int i = 0; i < TEST_RANDOM_WIDTHS; i++) {
+            widths.push_back(static_cast<int>(sRandom() % 2048) | 1);
+        }
+        return widths;
+    }
+
+    //count samples of actual against expected, every one of them is reported
+    template<class T>
+    static void expectRow(const char *kernel, int width, const T *actual, const T *expected,
+                          int count) {
+        for (int i = 0; i < count; i++) {
+            if (actual[i] != expected[i]) {
+                printf("%s, width %d: sample %d is %d, expected %d\n", kernel, width, i,
+                       static_cast<int>(actual[i]), static_cast<int>(expected[i]));
+                sFailures++;
+                return;
+            }
+        }
+    }
+
+/*
+ * u and v of a chroma row in the layout of the kernels: two planes, or one
+ * interleaved plane, NV21 with v first.
+ */
+    template<class Sample>
+    static void chromaPlanes(int chroma, Sample *samples, int count, const Sample **u,
+                             const Sample **v) {
+        if (chroma == ROW_CHROMA_NV12) {
+            *u = samples;
+            *v = samples + 1;
+        } else if (chroma == ROW_CHROMA_NV21) {
+            *u = samples + 1;
+            *v = samples;
+        } else {
+            *u = samples;
+            *v = samples + count + TEST_PADDING;
+        }
+    }
+
+    template<class Layout, class Output, class Engine, class Sample>
+    static void testConvertRow(const char *kernel, const Engine &engine, int width, int mask) {
+        int step = 0;
+        const typename Engine::SimdRow simdRow =
+                engine.template selectSimdRow<Output>(Layout::kRowChroma, &step);
+        if (!simdRow) {
+            return;
+        }
+        int uvCount = Layout::kRowChroma == ROW_CHROMA_444 ? width : (width + 1) >> 1;
+        if (Layout::kRowChroma == ROW_CHROMA_BILINEAR) {
+            uvCount++;
+        }
+        const std::vector<Sample> srcY = randomRow<Sample>(width, mask);
+        std::vector<Sample> chroma = randomRow<Sample>((uvCount + TEST_PADDING) * 2, mask);
+        const Sample *srcU;
+        const Sample *srcV;
+        chromaPlanes(Layout::kRowChroma, chroma.data(), uvCount, &srcU, &srcV);
+
+        const int bytes = (width + TEST_PADDING) * Output::kBytesPerPixel;
+        std::vector<unsigned char> actual(bytes);
+        std::vector<unsigned char> expected(bytes);
+        const int simdWidth = width & ~(step - 1);
+        simdRow(srcY.data(), srcU, srcV, actual.data(), simdWidth);
+        const Sample *noRow = nullptr;
+        YUV420ToRGBARowPair<Layout, Output>(engine, srcY.data(), noRow, srcU, srcV,
+                                            Layout::kPixelStride, expected.data(), nullptr, 0,
+                                            width);
+        expectRow(kernel, width, actual.data(), expected.data(),
+                  simdWidth * Output::kBytesPerPixel);
+    }
+
+    template<class Layout, class Engine>
+    static void testConvertRows(const char *kernel, const Engine &engine, int width) {
+        for (int output = ROW_OUTPUT_RGBA; output <= ROW_OUTPUT_ABGR; output++) {
+            withRowOutput(output, [&](auto order) {
+                typedef ByteOutput<decltype(order)::value> Output;
+                testConvertRow<Layout, Output, Engine, unsigned char>(kernel, engine, width, 255);
+            });
+        }
+    }
+
+    template<class Engine>
+    static void testConvertLayouts(const char *kernel, const Engine &engine, int width) {
+        testConvertRows<PlanarLayout>(kernel, engine, width);
+        testConvertRows<NV12Layout>(kernel, engine, width);
+        testConvertRows<NV21Layout>(kernel, engine, width);
+        testConvertRows<I444Layout>(kernel, engine, width);
+        testConvertRows<BilinearLayout>(kernel, engine, width);
+    }
+
+    //adjustments with every term of the transform in use
+    static ColorAdjustment testColorAdjustment() {
+        ColorAdjustment adjustment = kIdentityColorAdjustment;
+        adjustment.gains[0] = 1.1f;
+        adjustment.gains[2] = 0.9f;
+        adjustment.matrix[1] = 0.05f;
+        adjustment.matrix[5] = -0.1f;
+        adjustment.brightness = 12.0f;
+        adjustment.contrast = 1.2f;
+        adjustment.saturation = 1.3f;
+        return adjustment;
+    }
+
+    static void testConvert(int width) {
+        for (int matrix = COLOR_MATRIX_BT601; matrix <= COLOR_MATRIX_BT2020; matrix++) {
+            for (int range = COLOR_RANGE_LIMITED; range <= COLOR_RANGE_FULL; range++) {
+                withColorCoefficients(matrix, range, [&](auto coefficients) {
+                    typedef decltype(coefficients) Coefficients;
+                    const ColorTransform transform =
+                            foldColorAdjustment<Coefficients>(testColorAdjustment());
+                    testConvertLayouts("convert", ArithmeticEngine<Coefficients>(), width);
+                    testConvertLayouts("fast", FastEngine<Coefficients>(), width);
+                    testConvertLayouts("transform", TransformEngine(transform), width);
+
+                    const Transform10Engine<0> engine10(transform);
+                    const Transform10Engine<6> engine16(transform);
+                    testConvertRow<PlanarLayout, RGBA16Output, Transform10Engine<0>, uint16_t>(
+                            "10-bit", engine10, width, 1023);
+                    testConvertRow<NV12Layout, RGBA16Output, Transform10Engine<6>, uint16_t>(
+                            "10-bit msb", engine16, width, 0xffff);
+                    testConvertRow<I444Layout, RGBA16Output, Transform10Engine<0>, uint16_t>(
+                            "10-bit 444", engine10, width, 1023);
+                    testConvertRow<BilinearLayout, RGBA16Output, Transform10Engine<6>, uint16_t>(
+                            "10-bit bilinear", engine16, width, 0xffff);
+                });
+            }
+        }
+    }
+
+    template<class Layout>
+    static void testBlendRow(int width) {
+        int step = 0;
+        const BlendChromaRowFunc blendRow = selectBlendChromaRow(Layout::kRowChroma, &step);
+        if (!blendRow) {
+            return;
+        }
+        const int uvWidth = (width + 1) >> 1;
+        std::vector<unsigned char> nearRow = randomRow<unsigned char>((uvWidth + TEST_PADDING) * 2,
+                                                                      255);
+        std::vector<unsigned char> farRow = randomRow<unsigned char>((uvWidth + TEST_PADDING) * 2,
+                                                                     255);
+        const unsigned char *nearU;
+        const unsigned char *nearV;
+        const unsigned char *farU;
+        const unsigned char *farV;
+        chromaPlanes(Layout::kRowChroma, nearRow.data(), uvWidth, &nearU, &nearV);
+        chromaPlanes(Layout::kRowChroma, farRow.data(), uvWidth, &farU, &farV);
+
+        std::vector<unsigned char> actual((uvWidth + TEST_PADDING) * 2);
+        std::vector<unsigned char> expected(actual.size());
+        unsigned char *actualV = actual.data() + uvWidth + TEST_PADDING;
+        unsigned char *expectedV = expected.data() + uvWidth + TEST_PADDING;
+        const int simdWidth = (uvWidth * 2) & ~(step - 1);
+        blendRow(nearU, nearV, farU, farV, actual.data(), actualV, simdWidth);
+        blendChromaRow<Layout>(nearU, nearV, farU, farV, Layout::kPixelStride, expected.data(),
+                               expectedV, 0, width);
+        expectRow("blend u", width, actual.data(), expected.data(), simdWidth >> 1);
+        expectRow("blend v", width, actualV, expectedV, simdWidth >> 1);
+    }
+
+    static void testStreamRow(int width) {
+        const StreamRowFunc streamRow = selectStreamRow();
+        if (!streamRow) {
+            return;
+        }
+        const std::vector<unsigned char> src = randomRow<unsigned char>(width * 4, 255);
+        std::vector<unsigned char> dst(src.size());
+        streamRow(src.data(), dst.data(), width * 4);
+        expectRow("stream", width, dst.data(), src.data(), width * 4);
+    }
+
+    template<int kPack>
+    static void testPackRow(int width) {
+        int step = 0;
+        const PackRowFunc simdRow = selectPackRow(kPack, &step);
+        if (!simdRow) {
+            return;
+        }
+        const std::vector<unsigned char> src = randomRow<unsigned char>(width * 4, 255);
+        std::vector<unsigned char> actual((width + TEST_PADDING) * 4);
+        std::vector<unsigned char> expected(actual.size());
+        const int simdWidth = width & ~(step - 1);
+        for (int y = 0; y < 4; y++) {
+            simdRow(src.data(), actual.data(), simdWidth, y);
+            packRow<kPack>(src.data(), expected.data(), 0, width, y);
+            expectRow("pack", width, actual.data(), expected.data(),
+                      simdWidth * packedBytesPerPixel(kPack));
+        }
+    }
+
+    static void testLumaRow(int width) {
+        const int lumas[] = {ROW_LUMA_EXPAND, ROW_LUMA_RGBA, ROW_LUMA_RGBA | ROW_LUMA_EXPAND,
+                             ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST,
+                             ROW_LUMA_RGBA | ROW_LUMA_ALPHA_FIRST | ROW_LUMA_EXPAND};
+        const std::vector<unsigned char> srcY = randomRow<unsigned char>(width, 255);
+        for (int luma : lumas) {
+            int step = 0;
+            const LumaRowFunc simdRow = selectLumaRow(luma, &step);
+            if (!simdRow) {
+                continue;
+            }
+            std::vector<unsigned char> actual((width + TEST_PADDING) * 4);
+            std::vector<unsigned char> expected(actual.size());
+            const int simdWidth = width & ~(step - 1);
+            simdRow(srcY.data(), actual.data(), simdWidth);
+            lumaRow(srcY.data(), expected.data(), 0, width, luma);
+            expectRow("luma", width, actual.data(), expected.data(),
+                      simdWidth * (luma & ROW_LUMA_RGBA ? 4 : 1));
+        }
+    }
+
+    template<int kPacked>
+    static void testSplitPackedRow(int width) {
+        int step = 0;
+        const SplitPackedRowFunc splitRow = selectSplitPackedRow(kPacked, &step);
+        if (!splitRow) {
+            return;
+        }
+        const std::vector<unsigned char> src = randomRow<unsigned char>((width + 1) / 2 * 4, 255);
+        std::vector<unsigned char> actual[3];
+        std::vector<unsigned char> expected[3];
+        for (int i = 0; i < 3; i++) {
+            actual[i].resize(width + TEST_PADDING);
+            expected[i].resize(width + TEST_PADDING);
+        }
+        const int simdWidth = width & ~(step - 1);
+        splitRow(src.data(), actual[0].data(), actual[1].data(), actual[2].data(), simdWidth);
+        splitPackedRow<kPacked>(src.data(), expected[0].data(), expected[1].data(),
+                                expected[2].data(), 0, width);
+        expectRow("split y", width, actual[0].data(), expected[0].data(), simdWidth);
+        expectRow("split u", width, actual[1].data(), expected[1].data(), simdWidth / 2);
+        expectRow("split v", width, actual[2].data(), expected[2].data(), simdWidth / 2);
+    }
+
+    template<int kInput, class Coefficients>
+    static void testRGBAToYUVRows(int width) {
+        const std::vector<unsigned char> src0 = randomRow<unsigned char>(width * 4, 255);
+        const std::vector<unsigned char> src1 = randomRow<unsigned char>(width * 4, 255);
+        int step = 0;
+        const RGBAToYRowFunc yRow = selectRGBAToYRow(kInput, Coefficients::kMatrix,
+                                                     Coefficients::kRange, &step);
+        if (yRow) {
+            std::vector<unsigned char> actual(width + TEST_PADDING);
+            std::vector<unsigned char> expected(actual.size());
+            const int simdWidth = width & ~(step - 1);
+            yRow(src0.data(), actual.data(), simdWidth);
+            rgbaToYRow<kInput, Coefficients>(src0.data(), expected.data(), 0, width);
+            expectRow("rgba to y", width, actual.data(), expected.data(), simdWidth);
+        }
+        for (int chroma = ROW_CHROMA_PLANAR; chroma <= ROW_CHROMA_NV21; chroma++) {
+            const RGBAToUVRowFunc uvRow = selectRGBAToUVRow(chroma, kInput, Coefficients::kMatrix,
+                                                            Coefficients::kRange, &step);
+            if (!uvRow) {
+                continue;
+            }
+            const int uvWidth = (width + 1) >> 1;
+            const int pixelStride = chroma == ROW_CHROMA_PLANAR ? 1 : 2;
+            std::vector<unsigned char> actual((uvWidth + TEST_PADDING) * 2);
+            std::vector<unsigned char> expected(actual.size());
+            const unsigned char *u;
+            const unsigned char *v;
+            chromaPlanes(chroma, actual.data(), uvWidth, &u, &v);
+            const int actualV = static_cast<int>(v - actual.data());
+            const int actualU = static_cast<int>(u - actual.data());
+            const int simdWidth = width & ~(step - 1);
+            uvRow(src0.data(), src1.data(), actual.data() + actualU, actual.data() + actualV,
+                  simdWidth);
+            rgbaToUVRow<kInput, Coefficients>(src0.data(), src1.data(),
+                                              expected.data() + actualU,
+                                              expected.data() + actualV, pixelStride, 0, width);
+            if (pixelStride == 1) {
+                expectRow("rgba to u", width, actual.data() + actualU, expected.data() + actualU,
+                          simdWidth / 2);
+                expectRow("rgba to v", width, actual.data() + actualV, expected.data() + actualV,
+                          simdWidth / 2);
+            } else {
+                expectRow("rgba to uv", width, actual.data(), expected.data(), simdWidth);
+            }
+        }
+    }
+
+    static void testRGBAToYUV(int width) {
+        for (int matrix = COLOR_MATRIX_BT601; matrix <= COLOR_MATRIX_BT2020; matrix++) {
+            for (int range = COLOR_RANGE_LIMITED; range <= COLOR_RANGE_FULL; range++) {
+                withColorCoefficients(matrix, range, [&](auto coefficients) {
+                    typedef decltype(coefficients) C;
+                    typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+                    for (int input = ROW_OUTPUT_RGBA; input <= ROW_OUTPUT_ABGR; input++) {
+                        withRowOutput(input, [&](auto order) {
+                            testRGBAToYUVRows<decltype(order)::value, Coefficients>(width);
+                        });
+                    }
+                });
+            }
+        }
+    }
+
+/*
+ * Pure red, green and blue reach the ends of the chroma range, e.g. U of blue
+ * is 255.5 before the clamp in full range. Every sample must be within 1 of
+ * the exact value, which a sum that wraps around is not.
+ */
+    template<class Coefficients>
+    static void expectSamples(const char *channel, int color, const unsigned char *actual,
+                              int count, double exact) {
+        exact = exact < 0.0 ? 0.0 : (exact > 255.0 ? 255.0 : exact);
+        for (int i = 0; i < count; i++) {
+            if (fabs(actual[i] - exact) > 1.0) {
+                printf("saturated %s, matrix %d range %d color %06x: %d, expected %.2f\n",
+                       channel, Coefficients::kMatrix, Coefficients::kRange, color, actual[i],
+                       exact);
+                sFailures++;
+                return;
+            }
+        }
+    }
+
+    template<int kInput, class Coefficients>
+    static void testSaturatedColor(int color, int width) {
+        typedef RowOutputOrder<kInput> Order;
+        typedef Coefficients C;
+        const int r = color >> 16;
+        const int g = (color >> 8) & 0xff;
+        const int b = color & 0xff;
+        std::vector<unsigned char> src(width * 4);
+        for (int x = 0; x < width; x++) {
+            src[x * 4 + Order::kR] = static_cast<unsigned char>(r);
+            src[x * 4 + Order::kG] = static_cast<unsigned char>(g);
+            src[x * 4 + Order::kB] = static_cast<unsigned char>(b);
+            src[x * 4 + Order::kA] = 255;
+        }
+        const int uvWidth = (width + 1) >> 1;
+        std::vector<unsigned char> dstY(width);
+        std::vector<unsigned char> dstU(uvWidth);
+        std::vector<unsigned char> dstV(uvWidth);
+        int step = 0;
+        int simdWidth = 0;
+        const RGBAToYRowFunc yRow = selectRGBAToYRow(kInput, C::kMatrix, C::kRange, &step);
+        if (yRow) {
+            simdWidth = width & ~(step - 1);
+            yRow(src.data(), dstY.data(), simdWidth);
+        }
+        rgbaToYRow<kInput, C>(src.data(), dstY.data(), simdWidth, width);
+        simdWidth = 0;
+        const RGBAToUVRowFunc uvRow = selectRGBAToUVRow(ROW_CHROMA_PLANAR, kInput, C::kMatrix,
+                                                        C::kRange, &step);
+        if (uvRow) {
+            simdWidth = width & ~(step - 1);
+            uvRow(src.data(), src.data(), dstU.data(), dstV.data(), simdWidth);
+        }
+        rgbaToUVRow<kInput, C>(src.data(), src.data(), dstU.data(), dstV.data(), 1, simdWidth,
+                               width);
+
+        const double y = (C::kYR * r + C::kYG * g + C::kYB * b) / 256.0 + C::kYOffset;
+        const double u = (C::kUR * r + C::kUG * g + C::kUB * b) / 256.0 + 128.0;
+        const double v = (C::kVR * r + C::kVG * g + C::kVB * b) / 256.0 + 128.0;
+        expectSamples<C>("y", color, dstY.data(), width, y);
+        expectSamples<C>("u", color, dstU.data(), uvWidth, u);
+        expectSamples<C>("v", color, dstV.data(), uvWidth, v);
+    }
+
+    static void testSaturatedColors(int width) {
+        const int colors[] = {0xff0000, 0x00ff00, 0x0000ff};
+        for (int matrix = COLOR_MATRIX_BT601; matrix <= COLOR_MATRIX_BT2020; matrix++) {
+            for (int range = COLOR_RANGE_LIMITED; range <= COLOR_RANGE_FULL; range++) {
+                withColorCoefficients(matrix, range, [&](auto coefficients) {
+                    typedef decltype(coefficients) C;
+                    typedef RGBToYUVCoefficients<C::kMatrix, C::kRange> Coefficients;
+                    for (int color : colors) {
+                        testSaturatedColor<ROW_OUTPUT_RGBA, Coefficients>(color, width);
+                        testSaturatedColor<ROW_OUTPUT_ABGR, Coefficients>(color, width);
+                    }
+                });
+            }
+        }
+    }
+
+    template<int kPack>
+    static void testPack16Row(int width) {
+        int step = 0;
+        const PackRowFunc packRow = selectPack16Row(kPack, &step);
+        if (!packRow) {
+            return;
+        }
+        //RGBA16 rows, alpha is always 1023
+        std::vector<uint16_t> src = randomRow<uint16_t>(width * 4, 1023);
+        for (int x = 0; x < width; x++) {
+            src[x * 4 + 3] = 1023;
+        }
+        std::vector<unsigned char> actual((width + TEST_PADDING) * 4);
+        std::vector<unsigned char> expected(actual.size());
+        const int simdWidth = width & ~(step - 1);
+        packRow(reinterpret_cast<const unsigned char *>(src.data()), actual.data(), simdWidth, 0);
+        pack16Row<kPack>(src.data(), expected.data(), 0, width);
+        expectRow("pack 16-bit", width, actual.data(), expected.data(), simdWidth * 4);
+    }
+
+    static void testUnpackRawRow(int raw, int format, int width) {
+        int step = 0;
+        const UnpackRawRowFunc unpackRow = selectUnpackRawRow(raw, &step);
+        if (!unpackRow || width <= step) {
+            return;
+        }
+        const std::vector<unsigned char> src = randomRow<unsigned char>(width * 2, 255);
+        std::vector<uint16_t> actual(width + TEST_PADDING);
+        std::vector<uint16_t> expected(actual.size());
+        const int simdWidth = (width - step) & ~(step - 1);
+        unpackRow(src.data(), actual.data(), simdWidth);
+        unpackRawRow(src.data(), expected.data(), 0, width, format);
+        expectRow("unpack raw", width, actual.data(), expected.data(), simdWidth);
+    }
+
+    template<int kOutput>
+    static void testDemosaicRow(int bayer, int width) {
+        int step = 0;
+        const DemosaicRowFunc demosaic = selectDemosaicRow(bayer, kOutput, &step);
+        if (!demosaic) {
+            return;
+        }
+        //each row with its mirrored neighbours at [-1] and [width]
+        const std::vector<uint16_t> above = randomRow<uint16_t>(width + 2, 4095);
+        const std::vector<uint16_t> row = randomRow<uint16_t>(width + 2, 4095);
+        const std::vector<uint16_t> below = randomRow<uint16_t>(width + 2, 4095);
+        const int black = static_cast<int>(sRandom() % 256);
+        const int scale = static_cast<int>(sRandom() % 65536);
+        std::vector<unsigned char> actual((width + TEST_PADDING) * 4);
+        std::vector<unsigned char> expected(actual.size());
+        const int simdWidth = width & ~(step - 1);
+        demosaic(above.data() + 1, row.data() + 1, below.data() + 1, actual.data(), simdWidth,
+                 black, scale);
+        demosaicRow<kOutput>(above.data() + 1, row.data() + 1, below.data() + 1,
+                             expected.data(), 0, width, bayer, black, scale);
+        expectRow("demosaic", width, actual.data(), expected.data(), simdWidth * 4);
+    }
+
+    //one block, the source walked upwards so the strides are negative as in a rotation
+    static void testTransposeBlock(int bytesPerElement) {
+        int step = 0;
+        const TransposeBlockFunc transpose = selectTransposeBlock(bytesPerElement, &step);
+        if (!transpose) {
+            return;
+        }
+        const int rowBytes = step * bytesPerElement;
+        const int srcRowStride = rowBytes + 5;
+        const int dstRowStride = rowBytes + 3;
+        const std::vector<unsigned char> src = randomRow<unsigned char>(srcRowStride * step, 255);
+        std::vector<unsigned char> actual(dstRowStride * step);
+        std::vector<unsigned char> expected(actual.size());
+        const unsigned char *pSrc = src.data() + (step - 1) * srcRowStride;
+        transpose(pSrc, -srcRowStride, actual.data(), dstRowStride);
+        for (int j = 0; j < step; j++) {
+            for (int i = 0; i < step; i++) {
+                memcpy(&expected[j * dstRowStride + i * bytesPerElement],
+                       pSrc - i * srcRowStride + j * bytesPerElement, bytesPerElement);
+            }
+            expectRow("transpose", step, &actual[j * dstRowStride], &expected[j * dstRowStride],
+                      rowBytes);
+        }
+    }
+}
+
+int main() {
+    using namespace native_utils;
+    for (int width : testWidths()) {
+        testConvert(width);
+        testBlendRow<PlanarLayout>(width);
+        testBlendRow<NV12Layout>(width);
+        testBlendRow<NV21Layout>(width);
+        testStreamRow(width);
+        testPackRow<ROW_PACK_RGB565>(width);
+        testPackRow<ROW_PACK_RGB565_DITHER>(width);
+        testPackRow<ROW_PACK_RGB24>(width);
+        testPackRow<ROW_PACK_GRAY>(width);
+        testLumaRow(width);
+        testSplitPackedRow<ROW_PACKED_YUY2>(width);
+        testSplitPackedRow<ROW_PACKED_UYVY>(width);
+        testRGBAToYUV(width);
+        testSaturatedColors(width);
+        for (int output = ROW_OUTPUT_RGBA; output <= ROW_OUTPUT_ABGR; output++) {
+            withRowOutput(output, [&](auto order) {
+                testPack16Row<ROW_PACK16_BYTES + decltype(order)::value>(width);
+                for (int bayer = ROW_BAYER_RG; bayer <= ROW_BAYER_BG; bayer++) {
+                    testDemosaicRow<decltype(order)::value>(bayer, width);
+                }
+            });
+        }
+        testPack16Row<ROW_PACK16_RGBA1010102>(width);
+        testUnpackRawRow(ROW_RAW10, RAW_FORMAT_RAW10, width);
+        testUnpackRawRow(ROW_RAW12, RAW_FORMAT_RAW12, width);
+    }
+    for (int bytesPerElement = 1; bytesPerElement <= 4; bytesPerElement++) {
+        testTransposeBlock(bytesPerElement);
+    }
+    printf("%d failures\n", sFailures);
+    return sFailures == 0 ? 0 : 1;
+}